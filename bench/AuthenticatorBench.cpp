@@ -0,0 +1,104 @@
+#include "Bench.h"
+#include "Authenticator.h"
+#include "UserDatabase.h"
+#include "Digest.h"
+#include "Logger.h"
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Проверяемый исход аутентификации
+ */
+enum class Outcome {
+    Success, ///< Верный пароль
+    WrongHash, ///< Неверный хеш
+    UnknownLogin ///< Логин отсутствует в базе
+};
+
+/**
+ * @brief Формирование SALT16 + HASH для пароля
+ * @param algorithm Алгоритм хеширования
+ * @param password Пароль
+ * @return Строка аутентификационных данных
+ */
+std::string saltHash(Digest::Algorithm algorithm, const std::string& password) {
+    const std::string salt = "1234567890ABCDEF";
+    std::unique_ptr<Digest> digest = Digest::create(algorithm);
+    unsigned char hash[Digest::MAX_SIZE];
+    digest->update(salt.data(), salt.size());
+    digest->update(password.data(), password.size());
+    digest->final(hash);
+    size_t size = Digest::size(algorithm);
+    std::string hex(2 * size, '0');
+    Digest::encodeHex(hash, size, &hex[0]);
+    return salt + hex;
+}
+
+/**
+ * @brief Проверка аутентификационных данных
+ * @param state Состояние прогона
+ * @param algorithm Алгоритм хеширования
+ * @param outcome Исход проверки
+ * @details Ошибки аутентификации дублируются журналом в stderr; на время
+ *          измерения stderr перенаправляется в /dev/null, чтобы не засорять вывод
+ */
+void verify(BenchState& state, Digest::Algorithm algorithm, Outcome outcome) {
+    Logger logger;
+    logger.init("/dev/null");
+    const char* db_path = "bench_auth.conf";
+    {
+        std::ofstream db_file(db_path);
+        db_file << "user:P@ssW0rd\nadmin:secret\n";
+    }
+    UserDatabase db;
+    bool loaded = db.load(db_path, logger);
+    std::remove(db_path);
+    if (!loaded) {
+        return;
+    }
+    Authenticator auth(algorithm);
+    std::string login = outcome == Outcome::UnknownLogin ? "nobody" : "user";
+    std::string data = saltHash(algorithm, outcome == Outcome::WrongHash ? "wrong" : "P@ssW0rd");
+
+    int saved_stderr = dup(STDERR_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    dup2(null_fd, STDERR_FILENO);
+    volatile bool sink = false;
+    state.start();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        sink = auth.verify(login, data, db, logger);
+    }
+    state.stop();
+    (void)sink;
+    dup2(saved_stderr, STDERR_FILENO);
+    close(null_fd);
+    close(saved_stderr);
+}
+
+BenchRegistrar registrar([] {
+    const struct {
+        const char* name;
+        Digest::Algorithm algorithm;
+    } algorithms[] = {{"sha1", Digest::Algorithm::Sha1}, {"sha256", Digest::Algorithm::Sha256}};
+    const struct {
+        const char* name;
+        Outcome outcome;
+    } outcomes[] = {{"success", Outcome::Success}, {"wrong_hash", Outcome::WrongHash},
+                    {"unknown_login", Outcome::UnknownLogin}};
+    for (const auto& a : algorithms) {
+        for (const auto& o : outcomes) {
+            Digest::Algorithm algorithm = a.algorithm;
+            Outcome outcome = o.outcome;
+            Bench::add("Authenticator/verify/" + std::string(a.name) + "/" + o.name,
+                       [algorithm, outcome](BenchState& state) { verify(state, algorithm, outcome); });
+        }
+    }
+});
+
+} // namespace
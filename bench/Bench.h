@@ -0,0 +1,139 @@
+/**
+ * @file Bench.h
+ * @brief Заголовочный файл набора микробенчмарков сервера
+ */
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Состояние одного прогона бенчмарка
+ * @details Функция бенчмарка готовит данные, вызывает start(), выполняет
+ *          iterations() операций и вызывает stop(): в результат попадает только
+ *          время между start() и stop(). Количество итераций подбирает набор
+ */
+class BenchState {
+public:
+    /**
+     * @brief Конструктор
+     * @param iterations Количество операций прогона
+     */
+    explicit BenchState(size_t iterations) : count(iterations), items(0), elapsed(0), skipped(false) {}
+
+    /**
+     * @brief Получение количества операций прогона
+     * @return Количество итераций
+     */
+    size_t iterations() const {
+        return count;
+    }
+
+    /**
+     * @brief Начало измеряемого участка
+     */
+    void start() {
+        begin = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * @brief Конец измеряемого участка
+     */
+    void stop() {
+        elapsed += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    /**
+     * @brief Задание количества обработанных элементов на операцию
+     * @param per_iteration Элементы (байты, записи) на одну операцию
+     */
+    void setItems(double per_iteration) {
+        items = per_iteration;
+    }
+
+    /**
+     * @brief Пропуск бенчмарка в текущем запуске
+     * @details Вызывается вместо измерения, если параметры запуска исключают бенчмарк
+     */
+    void skip() {
+        skipped = true;
+    }
+
+    /**
+     * @brief Проверка пропуска бенчмарка
+     * @return true - был вызван skip()
+     */
+    bool isSkipped() const {
+        return skipped;
+    }
+
+    /**
+     * @brief Получение количества элементов на операцию
+     * @return Элементы на операцию (0 - не задано)
+     */
+    double itemsPerIteration() const {
+        return items;
+    }
+
+    /**
+     * @brief Получение измеренного времени
+     * @return Время измеряемых участков в наносекундах
+     */
+    double elapsedNs() const {
+        return elapsed;
+    }
+
+private:
+    size_t count; ///< Количество операций
+    double items; ///< Элементы на операцию
+    double elapsed; ///< Измеренное время, нс
+    bool skipped; ///< Бенчмарк пропущен
+    std::chrono::steady_clock::time_point begin; ///< Начало текущего участка
+};
+
+/**
+ * @brief Реестр бенчмарков
+ */
+class Bench {
+public:
+    typedef std::function<void(BenchState&)> Function; ///< Функция бенчмарка
+
+    /**
+     * @brief Описание зарегистрированного бенчмарка
+     */
+    struct Case {
+        std::string name; ///< Имя вида "Модуль/операция/параметры"
+        Function fn; ///< Функция бенчмарка
+    };
+
+    /**
+     * @brief Регистрация бенчмарка
+     * @param name Имя бенчмарка
+     * @param fn Функция бенчмарка
+     */
+    static void add(const std::string& name, Function fn);
+
+    /**
+     * @brief Получение зарегистрированных бенчмарков
+     * @return Бенчмарки в порядке регистрации
+     */
+    static std::vector<Case>& cases();
+};
+
+extern size_t benchMaxUsers; ///< Наибольший размер базы в бенчмарках UserDatabase (--max-users)
+
+/**
+ * @brief Регистрация бенчмарков файла при статической инициализации
+ */
+struct BenchRegistrar {
+    /**
+     * @brief Конструктор
+     * @param register_all Функция, вызывающая Bench::add() для бенчмарков файла
+     */
+    explicit BenchRegistrar(void (*register_all)()) {
+        register_all();
+    }
+};
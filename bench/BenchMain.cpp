@@ -0,0 +1,245 @@
+/**
+ * @file BenchMain.cpp
+ * @brief Запуск набора микробенчмарков и сравнение с сохраненными результатами
+ * @details Использование: server_bench [--filter TEXT] [--min-time SEC] [--max-users N]
+ *          [--output FILE] [--compare FILE] [--threshold PERCENT]
+ *
+ * Результаты выводятся в формате JSON, по одному бенчмарку в строке:
+ * имя, количество итераций, время операции в наносекундах и, если задано,
+ * количество элементов в секунду. С параметром --compare результаты сравниваются
+ * с ранее сохраненным файлом: бенчмарк, время которого выросло больше порога,
+ * отмечается как регрессия, и программа завершается с кодом 1
+ */
+
+#include "Bench.h"
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <utility>
+
+namespace po = boost::program_options;
+
+size_t benchMaxUsers = 10000000; ///< Наибольший размер базы в бенчмарках UserDatabase
+
+/**
+ * @brief Регистрация бенчмарка
+ * @param name Имя бенчмарка
+ * @param fn Функция бенчмарка
+ */
+void Bench::add(const std::string& name, Function fn) {
+    cases().push_back(Case{name, std::move(fn)});
+}
+
+/**
+ * @brief Получение зарегистрированных бенчмарков
+ * @return Бенчмарки в порядке регистрации
+ */
+std::vector<Bench::Case>& Bench::cases() {
+    static std::vector<Case> registry;
+    return registry;
+}
+
+namespace {
+
+/**
+ * @brief Результат бенчмарка
+ */
+struct Result {
+    std::string name; ///< Имя бенчмарка
+    size_t iterations; ///< Итерации последнего прогона
+    double nsPerOp; ///< Время операции, нс
+    double itemsPerSecond; ///< Элементы в секунду (0 - не задано)
+};
+
+/**
+ * @brief Выполнение бенчмарка с подбором количества итераций
+ * @param bench Бенчмарк
+ * @param min_time Минимальная длительность измеряемого прогона в секундах
+ * @param out Результат последнего прогона
+ * @return true - бенчмарк выполнен, false - бенчмарк пропущен
+ * @details Количество итераций увеличивается, пока прогон не займет min_time;
+ *          следующий прогон оценивается по скорости предыдущего с запасом 40%
+ */
+bool measure(const Bench::Case& bench, double min_time, Result& out) {
+    size_t iterations = 1;
+    while (true) {
+        BenchState state(iterations);
+        bench.fn(state);
+        if (state.isSkipped()) {
+            return false;
+        }
+        double elapsed = state.elapsedNs();
+        if (elapsed >= min_time * 1e9 || iterations >= (size_t(1) << 40)) {
+            double ns = elapsed / iterations;
+            double items = state.itemsPerIteration() > 0 ? state.itemsPerIteration() * 1e9 / ns : 0;
+            out = Result{bench.name, iterations, ns, items};
+            return true;
+        }
+        double scale = elapsed > 0 ? min_time * 1e9 * 1.4 / elapsed : 100;
+        iterations = static_cast<size_t>(iterations * std::min(100.0, std::max(2.0, scale)));
+    }
+}
+
+/**
+ * @brief Формирование JSON с результатами
+ * @param results Результаты
+ * @return Документ JSON (один бенчмарк в строке)
+ */
+std::string toJson(const std::vector<Result>& results) {
+    std::ostringstream out;
+    out << std::setprecision(6) << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+            << ", \"ns_per_op\": " << r.nsPerOp << ", \"items_per_s\": " << r.itemsPerSecond << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return out.str();
+}
+
+/**
+ * @brief Загрузка сохраненных результатов
+ * @param path Файл, записанный этой программой
+ * @param baseline Время операции по именам бенчмарков
+ * @return true - файл прочитан
+ */
+bool loadBaseline(const std::string& path, std::map<std::string, double>& baseline) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    const std::string name_key = "\"name\": \"";
+    const std::string ns_key = "\"ns_per_op\": ";
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t name_pos = line.find(name_key);
+        size_t ns_pos = line.find(ns_key);
+        if (name_pos == std::string::npos || ns_pos == std::string::npos) {
+            continue;
+        }
+        name_pos += name_key.size();
+        size_t name_end = line.find('"', name_pos);
+        if (name_end == std::string::npos) {
+            continue;
+        }
+        baseline[line.substr(name_pos, name_end - name_pos)] = std::strtod(line.c_str() + ns_pos + ns_key.size(), nullptr);
+    }
+    return true;
+}
+
+/**
+ * @brief Сравнение результатов с сохраненными
+ * @param results Текущие результаты
+ * @param baseline Сохраненные результаты
+ * @param threshold Допустимый рост времени в процентах
+ * @return Количество регрессий
+ */
+size_t compare(const std::vector<Result>& results, const std::map<std::string, double>& baseline, double threshold) {
+    size_t regressions = 0;
+    std::printf("%-48s %14s %14s %9s\n", "benchmark", "baseline ns", "current ns", "change");
+    for (const Result& r : results) {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end() || it->second <= 0) {
+            std::printf("%-48s %14s %14.1f %9s  new\n", r.name.c_str(), "-", r.nsPerOp, "-");
+            continue;
+        }
+        double change = (r.nsPerOp / it->second - 1) * 100;
+        const char* verdict = "";
+        if (change > threshold) {
+            verdict = "  REGRESSION";
+            ++regressions;
+        } else if (change < -threshold) {
+            verdict = "  improved";
+        }
+        std::printf("%-48s %14.1f %14.1f %+8.1f%%%s\n", r.name.c_str(), it->second, r.nsPerOp, change, verdict);
+    }
+    std::printf("%zu regression(s) over %.1f%%\n", regressions, threshold);
+    return regressions;
+}
+
+} // namespace
+
+/**
+ * @brief Главная функция набора бенчмарков
+ * @param argc Количество аргументов командной строки
+ * @param argv Массив аргументов командной строки
+ * @return 0 - бенчмарки выполнены без регрессий,
+ *         1 - ошибка параметров или найдены регрессии
+ */
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string output;
+    std::string baseline_path;
+    double min_time;
+    double threshold;
+    po::options_description desc("Allowed options");
+    desc.add_options()
+    ("help,h", "Show help")
+    ("filter", po::value<std::string>(&filter)->default_value(""), "Run only benchmarks whose name contains TEXT")
+    ("min-time", po::value<double>(&min_time)->default_value(0.2), "Minimum measured time per benchmark (seconds)")
+    ("max-users", po::value<size_t>(&benchMaxUsers)->default_value(10000000), "Largest user database for UserDatabase benchmarks")
+    ("output,o", po::value<std::string>(&output)->default_value(""), "JSON result file (default - standard output)")
+    ("compare", po::value<std::string>(&baseline_path)->default_value(""), "Compare with a saved JSON result and flag regressions")
+    ("threshold", po::value<double>(&threshold)->default_value(10), "Slowdown in percent reported as a regression");
+    try {
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        if (vm.count("help")) {
+            std::cout << desc << std::endl;
+            return 0;
+        }
+        po::notify(vm);
+        if (min_time <= 0 || threshold < 0) {
+            throw po::error("min-time must be positive and threshold non-negative");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error parsing arguments: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::map<std::string, double> baseline;
+    if (!baseline_path.empty() && !loadBaseline(baseline_path, baseline)) {
+        std::cerr << "Cannot read baseline " << baseline_path << std::endl;
+        return 1;
+    }
+
+    std::vector<Result> results;
+    for (const Bench::Case& bench : Bench::cases()) {
+        if (bench.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        Result r;
+        if (!measure(bench, min_time, r)) {
+            continue;
+        }
+        results.push_back(r);
+        std::fprintf(stderr, "%-48s %14.1f ns/op", r.name.c_str(), r.nsPerOp);
+        if (r.itemsPerSecond > 0) {
+            std::fprintf(stderr, " %14.4g items/s", r.itemsPerSecond);
+        }
+        std::fprintf(stderr, "\n");
+    }
+
+    std::string json = toJson(results);
+    if (output.empty() && baseline_path.empty()) {
+        std::cout << json;
+    } else if (!output.empty()) {
+        std::ofstream file(output);
+        file << json;
+        if (!file) {
+            std::cerr << "Cannot write " << output << std::endl;
+            return 1;
+        }
+    }
+    if (!baseline_path.empty()) {
+        return compare(results, baseline, threshold) == 0 ? 0 : 1;
+    }
+    return 0;
+}
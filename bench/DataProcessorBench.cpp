@@ -0,0 +1,82 @@
+#include "Bench.h"
+#include "DataProcessor.h"
+#include "Logger.h"
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Распределение значений вектора
+ */
+enum class Values {
+    Small, ///< Малые значения без переполнения среднего
+    Full, ///< Случайные значения во всем диапазоне int32_t
+    Saturated ///< Все значения равны INT32_MAX
+};
+
+/**
+ * @brief Заполнение вектора по распределению
+ * @param size Длина вектора
+ * @param values Распределение значений
+ * @return Вектор
+ */
+std::vector<int32_t> makeVector(size_t size, Values values) {
+    std::mt19937 rng(42);
+    std::vector<int32_t> data(size);
+    for (int32_t& v : data) {
+        switch (values) {
+        case Values::Small:
+            v = std::uniform_int_distribution<int32_t>(-1000, 1000)(rng);
+            break;
+        case Values::Full:
+            v = static_cast<int32_t>(rng());
+            break;
+        case Values::Saturated:
+            v = std::numeric_limits<int32_t>::max();
+            break;
+        }
+    }
+    return data;
+}
+
+/**
+ * @brief Вычисление среднего вектора заданной длины
+ * @param state Состояние прогона
+ * @param size Длина вектора
+ * @param values Распределение значений
+ */
+void average(BenchState& state, size_t size, Values values) {
+    Logger logger;
+    logger.init("/dev/null");
+    DataProcessor processor;
+    std::vector<int32_t> data = makeVector(size, values);
+    volatile int32_t sink = 0;
+    state.start();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        sink = processor.calculateAverage(data.data(), data.size(), logger);
+    }
+    state.stop();
+    (void)sink;
+    state.setItems(static_cast<double>(size));
+}
+
+BenchRegistrar registrar([] {
+    const size_t sizes[] = {16, 1024, 65536, 1 << 20, 16 << 20};
+    const struct {
+        const char* name;
+        Values values;
+    } distributions[] = {{"small", Values::Small}, {"full", Values::Full}, {"saturated", Values::Saturated}};
+    for (const auto& d : distributions) {
+        for (size_t size : sizes) {
+            Values values = d.values;
+            Bench::add("DataProcessor/average/" + std::string(d.name) + "/" + std::to_string(size),
+                       [size, values](BenchState& state) { average(state, size, values); });
+        }
+    }
+});
+
+} // namespace
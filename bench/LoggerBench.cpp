@@ -0,0 +1,39 @@
+#include "Bench.h"
+#include "Logger.h"
+#include <cstdio>
+#include <string>
+
+namespace {
+
+/**
+ * @brief Запись информационных сообщений в журнал
+ * @param state Состояние прогона
+ * @param async true - фоновый поток записи, false - синхронная запись
+ * @details Время асинхронного режима включает ожидание записи очереди в stop()
+ */
+void logInfo(BenchState& state, bool async) {
+    const char* log_path = "bench_logger.log";
+    std::remove(log_path);
+    Logger logger;
+    logger.init(log_path);
+    if (async) {
+        logger.startAsync(4096);
+    }
+    const std::string message = "Authenticator: Success for login user";
+    state.start();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        logger.logInfo(message);
+    }
+    if (async) {
+        logger.stop();
+    }
+    state.stop();
+    std::remove(log_path);
+}
+
+BenchRegistrar registrar([] {
+    Bench::add("Logger/logInfo/sync", [](BenchState& state) { logInfo(state, false); });
+    Bench::add("Logger/logInfo/async", [](BenchState& state) { logInfo(state, true); });
+});
+
+} // namespace
@@ -0,0 +1,170 @@
+#include "Bench.h"
+#include "UserDatabase.h"
+#include "Logger.h"
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Файлы баз, созданные бенчмарками
+ * @details Файлы одного размера создаются один раз на весь запуск и удаляются
+ *          при завершении программы
+ */
+class Fixtures {
+public:
+    /**
+     * @brief Деструктор - удаление созданных файлов
+     */
+    ~Fixtures() {
+        for (const std::string& path : created) {
+            std::remove(path.c_str());
+        }
+    }
+
+    /**
+     * @brief Получение текстовой базы заданного размера
+     * @param users Количество пользователей
+     * @return Путь к файлу формата login:password
+     */
+    std::string text(size_t users) {
+        std::string path = "bench_users_" + std::to_string(users) + ".conf";
+        if (textReady.emplace(users).second) {
+            std::ofstream file(path);
+            for (size_t i = 0; i < users; ++i) {
+                file << "user" << i << ":password" << i << '\n';
+            }
+            created.push_back(path);
+        }
+        return path;
+    }
+
+    /**
+     * @brief Получение двоичной базы заданного размера
+     * @param users Количество пользователей
+     * @param logger Журнал
+     * @return Путь к файлу, записанному UserDatabase::save()
+     */
+    std::string binary(size_t users, Logger& logger) {
+        std::string path = "bench_users_" + std::to_string(users) + ".bin";
+        if (binaryReady.emplace(users).second) {
+            const UserDatabase& db = loaded(users, logger);
+            db.save(path, logger);
+            created.push_back(path);
+        }
+        return path;
+    }
+
+    /**
+     * @brief Получение загруженной базы заданного размера
+     * @param users Количество пользователей
+     * @param logger Журнал
+     * @return База; хранится только последняя запрошенная, чтобы не держать в памяти все размеры
+     */
+    const UserDatabase& loaded(size_t users, Logger& logger) {
+        if (!db || dbUsers != users) {
+            db.reset();
+            db.reset(new UserDatabase());
+            db->load(text(users), logger);
+            dbUsers = users;
+        }
+        return *db;
+    }
+
+private:
+    std::set<size_t> textReady; ///< Размеры созданных текстовых баз
+    std::set<size_t> binaryReady; ///< Размеры созданных двоичных баз
+    std::vector<std::string> created; ///< Созданные файлы
+    std::unique_ptr<UserDatabase> db; ///< Последняя загруженная база
+    size_t dbUsers = 0; ///< Размер загруженной базы
+};
+
+Fixtures fixtures;
+
+/**
+ * @brief Загрузка базы из файла
+ * @param state Состояние прогона
+ * @param users Количество пользователей
+ * @param binary true - двоичный формат, false - текстовый
+ */
+void load(BenchState& state, size_t users, bool binary) {
+    Logger logger;
+    logger.init("/dev/null");
+    std::string path = binary ? fixtures.binary(users, logger) : fixtures.text(users);
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        UserDatabase db;
+        state.start();
+        db.load(path, logger);
+        state.stop();
+    }
+    state.setItems(static_cast<double>(users));
+}
+
+/**
+ * @brief Поиск паролей в загруженной базе
+ * @param state Состояние прогона
+ * @param users Количество пользователей
+ * @param hit true - существующие логины, false - отсутствующие
+ */
+void getPassword(BenchState& state, size_t users, bool hit) {
+    Logger logger;
+    logger.init("/dev/null");
+    const UserDatabase& db = fixtures.loaded(users, logger);
+    std::vector<std::string> logins;
+    const size_t count = 4096;
+    for (size_t i = 0; i < count; ++i) {
+        size_t index = (i * 2654435761u) % users;
+        logins.push_back((hit ? "user" : "missing") + std::to_string(index));
+    }
+    std::string_view password;
+    volatile bool sink = false;
+    state.start();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        sink = db.getPassword(logins[i % count], password);
+    }
+    state.stop();
+    (void)sink;
+}
+
+BenchRegistrar registrar([] {
+    const size_t sizes[] = {1000, 10000, 100000, 1000000, 10000000};
+    for (size_t users : sizes) {
+        std::string suffix = "/" + std::to_string(users);
+        Bench::add("UserDatabase/load_text" + suffix, [users](BenchState& state) {
+            if (users > benchMaxUsers) {
+                state.skip();
+                return;
+            }
+            load(state, users, false);
+        });
+        Bench::add("UserDatabase/load_binary" + suffix, [users](BenchState& state) {
+            if (users > benchMaxUsers) {
+                state.skip();
+                return;
+            }
+            load(state, users, true);
+        });
+        Bench::add("UserDatabase/getPassword/hit" + suffix, [users](BenchState& state) {
+            if (users > benchMaxUsers) {
+                state.skip();
+                return;
+            }
+            getPassword(state, users, true);
+        });
+        Bench::add("UserDatabase/getPassword/miss" + suffix, [users](BenchState& state) {
+            if (users > benchMaxUsers) {
+                state.skip();
+                return;
+            }
+            getPassword(state, users, false);
+        });
+    }
+});
+
+} // namespace
@@ -0,0 +1,177 @@
+/**
+ * @file AuthThrottle.h
+ * @brief Заголовочный файл модуля AuthThrottle - ограничение неудачных попыток аутентификации
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+/**
+ * @brief Ограничитель перебора паролей по адресу клиента и по логину
+ * @details Неудачные попытки учитываются в двух таблицах фиксированного размера
+ *          (count-min sketch): по адресу клиента и по паре адрес-логин. Логин учитывается
+ *          вместе с адресом, чтобы неудачи с чужих адресов не блокировали владельца
+ *          учетной записи. Ключ отображается на
+ *          DEPTH ячеек, по одной в каждой строке таблицы, а оценкой числа неудач
+ *          служит минимум из них, поэтому коллизии могут только завысить оценку.
+ *          Счетчики затухают: за каждые window секунд без обновления значение ячейки
+ *          уменьшается вдвое. Ключ, оценка которого достигла limit, отклоняется:
+ *          адрес - сразу после accept, до разбора и хеширования, логин - до обращения
+ *          к базе пользователей. Ячейка хранит номер окна и счетчик в одном 64-битном
+ *          слове и обновляется через compare_exchange, без блокировок
+ * @note Методы потокобезопасны, память таблиц выделяется один раз при создании
+ */
+class AuthThrottle {
+public:
+    static const unsigned DEPTH = 4; ///< Количество строк таблицы (хеш-функций)
+    static const size_t WIDTH = 8192; ///< Количество ячеек в строке (степень двойки)
+
+    /**
+     * @brief Конструктор
+     * @param limit Количество неудач, после которого ключ отклоняется
+     * @param window Период полураспада счетчиков в секундах (больше нуля)
+     */
+    AuthThrottle(unsigned limit, unsigned window);
+
+    AuthThrottle(const AuthThrottle&) = delete;
+    AuthThrottle& operator=(const AuthThrottle&) = delete;
+
+    /**
+     * @brief Получение текущего времени для счетчиков
+     * @return Секунды монотонных часов
+     */
+    static uint32_t clock();
+
+    /**
+     * @brief Проверка адреса клиента сразу после подключения
+     * @param address Адрес клиента
+     * @param time Текущее время в секундах
+     * @return true - подключение разрешено, false - адрес отклонен (учитывается в rejectedAddresses())
+     */
+    bool allowAddress(std::string_view address, uint32_t time = clock());
+
+    /**
+     * @brief Проверка логина перед проверкой пароля
+     * @param address Адрес клиента
+     * @param login Логин пользователя
+     * @param time Текущее время в секундах
+     * @return true - проверка разрешена, false - логин отклонен для этого адреса
+     *         (учитывается в rejectedLogins())
+     */
+    bool allowLogin(std::string_view address, std::string_view login, uint32_t time = clock());
+
+    /**
+     * @brief Учет неудачной аутентификации
+     * @param address Адрес клиента
+     * @param login Логин пользователя (пустой - учитывается только адрес)
+     * @param time Текущее время в секундах
+     */
+    void recordFailure(std::string_view address, std::string_view login, uint32_t time = clock());
+
+    /**
+     * @brief Получение оценки числа неудач адреса
+     * @param address Адрес клиента
+     * @param time Текущее время в секундах
+     * @return Затухающее количество неудач (не меньше точного значения)
+     */
+    uint32_t addressFailures(std::string_view address, uint32_t time = clock()) const;
+
+    /**
+     * @brief Получение оценки числа неудач логина с адреса
+     * @param address Адрес клиента
+     * @param login Логин пользователя
+     * @param time Текущее время в секундах
+     * @return Затухающее количество неудач (не меньше точного значения)
+     */
+    uint32_t loginFailures(std::string_view address, std::string_view login, uint32_t time = clock()) const;
+
+    /**
+     * @brief Получение количества отклоненных подключений
+     * @return Количество отказов по адресу за время жизни объекта
+     */
+    uint64_t rejectedAddresses() const {
+        return rejectedAddressCount.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Получение количества отклоненных попыток по логину
+     * @return Количество отказов по логину за время жизни объекта
+     */
+    uint64_t rejectedLogins() const {
+        return rejectedLoginCount.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Получение порога отказа
+     * @return Количество неудач, после которого ключ отклоняется
+     */
+    unsigned limit() const {
+        return failureLimit;
+    }
+
+private:
+    /**
+     * @brief Таблица затухающих счетчиков
+     */
+    class Sketch {
+    public:
+        /**
+         * @brief Конструктор
+         * @details Выделяет DEPTH * WIDTH обнуленных ячеек
+         */
+        Sketch();
+
+        /**
+         * @brief Увеличение счетчиков ключа на единицу
+         * @param key Хеш ключа
+         * @param window Номер текущего окна
+         */
+        void add(uint64_t key, uint32_t window);
+
+        /**
+         * @brief Оценка счетчика ключа
+         * @param key Хеш ключа
+         * @param window Номер текущего окна
+         * @return Минимум затухших значений ячеек ключа
+         */
+        uint32_t estimate(uint64_t key, uint32_t window) const;
+
+    private:
+        /**
+         * @brief Вычисление номеров ячеек ключа
+         * @param key Хеш ключа
+         * @param index Номера ячеек по строкам (DEPTH элементов)
+         */
+        static void locate(uint64_t key, size_t* index);
+
+        std::unique_ptr<std::atomic<uint64_t>[]> cells; ///< Ячейки: номер окна (старшие 32 бита) и счетчик
+    };
+
+    /**
+     * @brief Значение счетчика ячейки с учетом затухания
+     * @param cell Слово ячейки
+     * @param window Номер текущего окна
+     * @return Счетчик, уменьшенный вдвое за каждое прошедшее окно
+     */
+    static uint32_t decayed(uint64_t cell, uint32_t window);
+
+    /**
+     * @brief Номер окна затухания для момента времени
+     * @param time Время в секундах
+     * @return Номер окна
+     */
+    uint32_t windowOf(uint32_t time) const {
+        return time / window;
+    }
+
+    unsigned failureLimit; ///< Порог отказа
+    unsigned window; ///< Период полураспада в секундах
+    Sketch addresses; ///< Неудачи по адресам клиентов
+    Sketch logins; ///< Неудачи по парам адрес-логин
+    alignas(64) std::atomic<uint64_t> rejectedAddressCount; ///< Отклоненные подключения
+    alignas(64) std::atomic<uint64_t> rejectedLoginCount; ///< Отклоненные попытки по логину
+};
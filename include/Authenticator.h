@@ -5,28 +5,137 @@
 
 #pragma once
 #include <string>
+#include <string_view>
+#include <cstddef>
+#include "Digest.h"
+#include "SessionStatus.h"
 
 class UserDatabase; ///< Предварительное объявление класса UserDatabase
+class TicketManager; ///< Предварительное объявление класса TicketManager
+class AuthThrottle; ///< Предварительное объявление класса AuthThrottle
+class Metrics; ///< Предварительное объявление класса Metrics
 class Logger; ///< Предварительное объявление класса Logger
 
 /**
  * @brief Класс для аутентификации пользователей
- * @details Реализует аутентификацию с использованием хеш-функции SHA-1 и соли, формируемой клиентом
+ * @details Реализует аутентификацию с использованием хеш-функции (SHA-1 или SHA-256)
+ *          и соли, формируемой клиентом. Длина аутентификационных данных определяется
+ *          выбранным алгоритмом: 16 символов SALT и хеш в hex-формате.
+ *          При подключенном TicketManager после аутентификации выдается билет, а строка
+ *          "RESUME:" + билет + логин возобновляет сессию без обращения к базе.
+ *          Подключенный AuthThrottle учитывает неудачи и отклоняет перебор паролей
+ * @note Алгоритм задается при создании и не меняется, verify() можно вызывать из нескольких потоков
  */
 class Authenticator {
 public:
+    /**
+     * @brief Конструктор
+     * @param algorithm Алгоритм хеширования
+     */
+    explicit Authenticator(Digest::Algorithm algorithm = Digest::Algorithm::Sha1)
+        : algorithm(algorithm), tickets(nullptr), limiter(nullptr), stats(nullptr) {}
+
+    static const char RESUME_PREFIX[]; ///< Префикс строки возобновления сессии
+
+    /**
+     * @brief Подключение билетов возобновления сессии
+     * @param manager Менеджер билетов (nullptr - билеты отключены)
+     */
+    void setTickets(const TicketManager* manager) {
+        tickets = manager;
+    }
+
+    /**
+     * @brief Подключение ограничителя неудачных попыток
+     * @param throttle Ограничитель (nullptr - ограничение отключено)
+     */
+    void setThrottle(AuthThrottle* throttle) {
+        limiter = throttle;
+    }
+
+    /**
+     * @brief Получение ограничителя неудачных попыток
+     * @return Ограничитель или nullptr, если ограничение отключено
+     */
+    AuthThrottle* throttle() const {
+        return limiter;
+    }
+
+    /**
+     * @brief Подключение метрик
+     * @param metrics Метрики для учета исходов и задержки аутентификации (nullptr - не учитывать)
+     */
+    void setMetrics(Metrics* metrics) {
+        stats = metrics;
+    }
+
+    /**
+     * @brief Получение алгоритма хеширования
+     * @return Алгоритм
+     */
+    Digest::Algorithm digestAlgorithm() const {
+        return algorithm;
+    }
+
+    /**
+     * @brief Получение длины аутентификационных данных
+     * @return Длина SALT + HASH в символах (56 для SHA-1, 80 для SHA-256)
+     */
+    size_t authDataLength() const {
+        return SALT16_LENGTH + 2 * Digest::size(algorithm);
+    }
+
     /**
      * @brief Проверка аутентификационных данных
      * @param login Логин пользователя
-     * @param salt_hash_client Строка формата SALT16 + HASH (56 символов)
+     * @param salt_hash_client Строка формата SALT16 + HASH (authDataLength() символов)
      * @param db Ссылка на базу данных пользователей
      * @param logger Ссылка на журнал для записи событий
      * @return true - аутентификация успешна,
      *         false - аутентификация не пройдена
      */
-    bool verify(const std::string& login, const std::string& salt_hash_client, 
+    bool verify(std::string_view login, std::string_view salt_hash_client, 
                 UserDatabase& db, Logger& logger) const;
 
+    /**
+     * @brief Аутентификация по строке, принятой от клиента
+     * @param message Строка LOGIN + SALT16 + HASH или "RESUME:" + билет + логин (без перевода строки)
+     * @param peer Адрес клиента для учета неудач
+     * @param db Ссылка на базу данных пользователей
+     * @param logger Ссылка на журнал для записи событий
+     * @param out_login Логин из строки
+     * @return Успех или код ошибки аутентификации (AuthTooShort, AuthFailed,
+     *         AuthThrottled, TicketRejected) с логином в подробности
+     */
+    SessionStatus authenticate(const std::string& message, const std::string& peer, UserDatabase& db,
+                               Logger& logger, std::string& out_login) const;
+
+    /**
+     * @brief Проверка, является ли строка запросом возобновления сессии
+     * @param message Строка аутентификации клиента
+     * @return true - билеты включены и строка начинается с RESUME_PREFIX
+     */
+    bool isResume(const std::string& message) const;
+
+    /**
+     * @brief Возобновление сессии по билету
+     * @param message Строка "RESUME:" + билет + логин
+     * @param out_login Логин из строки
+     * @param logger Ссылка на журнал для записи событий
+     * @return true - билет действителен для этого логина
+     */
+    bool resume(const std::string& message, std::string& out_login, Logger& logger) const;
+
+    /**
+     * @brief Выдача билета после успешной аутентификации
+     * @param message Строка аутентификации, по которой клиент прошел проверку
+     * @param login Логин пользователя
+     * @return Билет или пустая строка, если билеты отключены
+     * @details Новый билет выдается только после проверки пароля. После возобновления
+     *          возвращается предъявленный билет, поэтому срок сессии не продлевается
+     */
+    std::string issueTicket(const std::string& message, const std::string& login) const;
+
 private:
     /**
      * @brief Проверка строки на соотвествие шестнадцатеричному формату
@@ -34,8 +143,24 @@ private:
      * @return true - строка содержит только hex-символы,
      *         false - строка содержит недопустимые символы
      */
-    bool isValidHex(const std::string& str) const;
+    bool isValidHex(std::string_view str) const;
+
+    /**
+     * @brief Проверка строки аутентификации без учета в метриках
+     * @param message Строка LOGIN + SALT16 + HASH или "RESUME:" + билет + логин
+     * @param peer Адрес клиента для учета неудач
+     * @param db Ссылка на базу данных пользователей
+     * @param logger Ссылка на журнал для записи событий
+     * @param out_login Логин из строки
+     * @return Успех или код ошибки аутентификации
+     */
+    SessionStatus check(const std::string& message, const std::string& peer, UserDatabase& db,
+                        Logger& logger, std::string& out_login) const;
 
     static const int SALT16_LENGTH = 16; ///< Длина строки SALT в hex-формате
-    static const int SHA1_HEX_LENGTH = 40; ///< Длина хеша SHA-1 в hex-формате
-};
\ No newline at end of file
+
+    Digest::Algorithm algorithm; ///< Алгоритм хеширования
+    const TicketManager* tickets; ///< Менеджер билетов (nullptr - билеты отключены)
+    AuthThrottle* limiter; ///< Ограничитель неудачных попыток (nullptr - отключен)
+    Metrics* stats; ///< Метрики (nullptr - не учитываются)
+};
@@ -0,0 +1,136 @@
+/**
+ * @file BinaryLog.h
+ * @brief Заголовочный файл модуля BinaryLog - двоичный формат журнала
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Двоичный формат журнала: кодирование записей и разбор файла
+ * @details Файл состоит из записей с заголовком фиксированной длины HEADER_SIZE:
+ *          вид записи (1 байт), уровень (1), резерв (2), номер события (4),
+ *          время в наносекундах от эпохи Unix (8), длина тела (4). Числа хранятся
+ *          в порядке байт узла.
+ *          - Segment начинает сегмент (тело - MAGIC). Сегмент пишется при первой
+ *            записи журнала в файл и содержит все шаблоны, известные к этому моменту
+ *          - Template объявляет шаблон сообщения (тело - текст шаблона): неизменные
+ *            части сообщения и символ PLACEHOLDER на месте каждого аргумента.
+ *            Шаблон пишется один раз за сегмент
+ *          - Event - запись журнала: номер шаблона и аргументы, каждый с байтом типа
+ *          Номера шаблонов действуют в пределах сегмента. Запись события может
+ *          оказаться в файле раньше объявления шаблона (асинхронный журнал), поэтому
+ *          decode() сопоставляет события с шаблонами по окончании сегмента
+ */
+class BinaryLog {
+public:
+    /**
+     * @brief Вид записи
+     */
+    enum class Kind : uint8_t {
+        Segment = 0, ///< Начало сегмента
+        Template = 1, ///< Объявление шаблона
+        Event = 2 ///< Запись журнала
+    };
+
+    /**
+     * @brief Тип аргумента события
+     */
+    enum class ArgType : uint8_t {
+        Int = 1, ///< Целое со знаком, 8 байт
+        Uint = 2, ///< Целое без знака, 8 байт
+        Double = 3, ///< Число с плавающей точкой, 8 байт
+        Bool = 4, ///< Логическое значение, 1 байт
+        Char = 5, ///< Символ, 1 байт
+        String = 6 ///< Строка: длина (4 байта) и символы
+    };
+
+    static constexpr size_t HEADER_SIZE = 20; ///< Длина заголовка записи
+    static constexpr char PLACEHOLDER = '\x01'; ///< Место аргумента в шаблоне
+    static constexpr char MAGIC[8] = {'V', 'C', 'L', 'O', 'G', 'B', '1', '\n'}; ///< Тело записи Segment
+
+    /**
+     * @brief Разобранная запись журнала
+     */
+    struct Entry {
+        uint8_t level; ///< Уровень (номер Logger::Level)
+        uint64_t timestamp; ///< Время, нс от эпохи Unix
+        std::string message; ///< Текст сообщения с подставленными аргументами
+        std::vector<std::string> strings; ///< Строковые аргументы (логины, адреса ...)
+    };
+
+    /**
+     * @brief Добавление заголовка записи
+     * @param out Буфер записи
+     * @param kind Вид записи
+     * @param level Уровень
+     * @param event Номер шаблона
+     * @param timestamp Время, нс от эпохи Unix
+     * @param length Длина тела
+     */
+    static void appendHeader(std::string& out, Kind kind, uint8_t level, uint32_t event, uint64_t timestamp,
+                             uint32_t length) {
+        char header[HEADER_SIZE] = {};
+        header[0] = static_cast<char>(kind);
+        header[1] = static_cast<char>(level);
+        std::memcpy(header + 4, &event, sizeof(event));
+        std::memcpy(header + 8, &timestamp, sizeof(timestamp));
+        std::memcpy(header + 16, &length, sizeof(length));
+        out.append(header, HEADER_SIZE);
+    }
+
+    /**
+     * @brief Добавление аргумента фиксированной длины
+     * @param out Тело записи
+     * @param type Тип аргумента
+     * @param value Значение
+     */
+    template <typename T>
+    static void appendValue(std::string& out, ArgType type, T value) {
+        out.push_back(static_cast<char>(type));
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    /**
+     * @brief Добавление строкового аргумента
+     * @param out Тело записи
+     * @param value Строка
+     */
+    static void appendString(std::string& out, std::string_view value) {
+        uint32_t length = static_cast<uint32_t>(value.size());
+        out.push_back(static_cast<char>(ArgType::String));
+        out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.append(value.data(), value.size());
+    }
+
+    /**
+     * @brief Разбор двоичного журнала
+     * @param data Содержимое файла
+     * @param size Длина содержимого
+     * @param entries Разобранные записи в порядке файла
+     * @param error Описание ошибки формата
+     * @return true - файл разобран целиком, false - файл не является двоичным
+     *         журналом или обрывается (entries содержит записи до места ошибки)
+     */
+    static bool decode(const char* data, size_t size, std::vector<Entry>& entries, std::string& error);
+
+    /**
+     * @brief Форматирование записи в текстовом формате журнала
+     * @param entry Запись
+     * @return Строка "YYYY-MM-DD HH:MM:SS; УРОВЕНЬ; СООБЩЕНИЕ" (местное время)
+     */
+    static std::string formatLine(const Entry& entry);
+
+    /**
+     * @brief Проверка начала двоичного журнала
+     * @param data Начало файла
+     * @param size Длина данных
+     * @return true - данные начинаются с записи Segment
+     */
+    static bool isBinary(const char* data, size_t size);
+};
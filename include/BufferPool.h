@@ -0,0 +1,161 @@
+/**
+ * @file BufferPool.h
+ * @brief Заголовочный файл модуля BufferPool - пул буферов для данных векторов
+ */
+
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Пул буферов с классами размеров
+ * @details Буферы выдаются по классам размеров - степеням двойки от MIN_BUFFER_SIZE.
+ *          Освобожденный буфер возвращается в список своего класса и выдается повторно
+ *          без обращения к аллокатору, поэтому обработка множества векторов не приводит
+ *          к выделению памяти на каждый вектор. Память буферов не обнуляется.
+ *          Буферы от HUGE_PAGE_SIZE и больше выделяются через mmap и при включенном
+ *          режиме больших страниц помечаются madvise(MADV_HUGEPAGE).
+ *          Объем свободных буферов в пуле ограничен: буфер, не помещающийся в предел,
+ *          возвращается системе
+ * @note Объект предназначен для использования из одного потока (пул создается на
+ *       каждый рабочий поток сервера)
+ */
+class BufferPool {
+public:
+    static constexpr size_t MIN_BUFFER_SIZE = 4096; ///< Размер наименьшего класса
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024; ///< Размер большой страницы
+    static constexpr size_t DEFAULT_CACHE_LIMIT = 256 * 1024 * 1024; ///< Предел объема свободных буферов по умолчанию
+
+    /**
+     * @brief Буфер, выданный пулом
+     * @details Владеет памятью буфера и возвращает ее в пул при уничтожении или reset()
+     */
+    class Buffer {
+    public:
+        Buffer() : pool(nullptr), ptr(nullptr), sizeClass(0) {}
+        Buffer(Buffer&& other) noexcept : pool(other.pool), ptr(other.ptr), sizeClass(other.sizeClass) {
+            other.ptr = nullptr;
+        }
+        Buffer& operator=(Buffer&& other) noexcept;
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+
+        /**
+         * @brief Деструктор
+         * @details Возвращает буфер в пул
+         */
+        ~Buffer() {
+            reset();
+        }
+
+        /**
+         * @brief Получение памяти буфера
+         * @return Указатель на начало буфера (nullptr у пустого буфера)
+         */
+        char* data() const {
+            return ptr;
+        }
+
+        /**
+         * @brief Получение емкости буфера
+         * @return Размер буфера в байтах
+         */
+        size_t capacity() const {
+            return ptr ? BufferPool::classSize(sizeClass) : 0;
+        }
+
+        /**
+         * @brief Возврат буфера в пул
+         */
+        void reset();
+
+    private:
+        friend class BufferPool;
+        Buffer(BufferPool* pool, char* ptr, unsigned size_class) : pool(pool), ptr(ptr), sizeClass(size_class) {}
+
+        BufferPool* pool; ///< Пул-владелец
+        char* ptr; ///< Память буфера
+        unsigned sizeClass; ///< Класс размера
+    };
+
+    /**
+     * @brief Конструктор пула
+     * @param huge_pages Использовать большие страницы для буферов от HUGE_PAGE_SIZE
+     * @param cache_limit Предел объема свободных буферов в пуле
+     */
+    explicit BufferPool(bool huge_pages = false, size_t cache_limit = DEFAULT_CACHE_LIMIT);
+
+    /**
+     * @brief Деструктор
+     * @details Освобождает свободные буферы. Все выданные буферы должны быть
+     *          возвращены до уничтожения пула
+     */
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * @brief Получение буфера
+     * @param size Требуемый размер в байтах
+     * @return Буфер емкостью не меньше size с неинициализированным содержимым
+     * @throw std::bad_alloc при нехватке памяти
+     */
+    Buffer acquire(size_t size);
+
+    /**
+     * @brief Получение количества обращений к системному аллокатору
+     * @return Количество выделений памяти за время жизни пула
+     */
+    size_t allocations() const {
+        return allocationCount;
+    }
+
+    /**
+     * @brief Получение объема свободных буферов в пуле
+     * @return Объем в байтах
+     */
+    size_t cachedBytes() const {
+        return cached;
+    }
+
+private:
+    static const unsigned CLASS_COUNT = 21; ///< Количество классов (до 4 ГБ)
+
+    /**
+     * @brief Размер буфера класса
+     * @param size_class Класс размера
+     * @return Размер в байтах
+     */
+    static size_t classSize(unsigned size_class) {
+        return MIN_BUFFER_SIZE << size_class;
+    }
+
+    /**
+     * @brief Выделение памяти под буфер класса
+     * @param size_class Класс размера
+     * @return Указатель на память
+     * @throw std::bad_alloc при нехватке памяти
+     */
+    char* allocate(unsigned size_class);
+
+    /**
+     * @brief Освобождение памяти буфера класса
+     * @param ptr Указатель на память
+     * @param size_class Класс размера
+     */
+    static void deallocate(char* ptr, unsigned size_class);
+
+    /**
+     * @brief Возврат буфера в пул
+     * @param ptr Указатель на память
+     * @param size_class Класс размера
+     */
+    void release(char* ptr, unsigned size_class);
+
+    bool hugePages; ///< Режим больших страниц
+    size_t cacheLimit; ///< Предел объема свободных буферов
+    size_t cached; ///< Объем свободных буферов
+    size_t allocationCount; ///< Количество выделений памяти
+    std::vector<char*> freeLists[CLASS_COUNT]; ///< Свободные буферы по классам
+};
@@ -0,0 +1,245 @@
+/**
+ * @file Connection.h
+ * @brief Заголовочный файл модуля Connection - состояние клиентского соединения
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "DataProcessor.h"
+#include "FrameReader.h"
+#include "BufferPool.h"
+#include "SessionStatus.h"
+#include "Tracer.h"
+
+class Logger; ///< Предварительное объявление класса Logger
+class UserDatabase; ///< Предварительное объявление класса UserDatabase
+class Authenticator; ///< Предварительное объявление класса Authenticator
+class Metrics; ///< Предварительное объявление класса Metrics
+
+/**
+ * @brief Класс неблокирующего клиентского соединения
+ * @details Реализует протокол сервера в виде конечного автомата:
+ *          LOGIN+SALT+HASH -> "OK"/"ERR" -> uint32_t количество векторов ->
+ *          для каждого вектора uint32_t длина и int32_t[] данные -> int32_t результат.
+ *          Данные принимаются во входной кольцевой буфер соединения, из которого
+ *          FrameReader извлекает только полностью пришедшие кадры, поэтому короткие
+ *          чтения и несколько кадров за одно чтение обрабатываются одинаково.
+ *          Каждый вызов onReadable() продвигает автомат ровно настолько,
+ *          насколько позволяют уже пришедшие данные, не блокируя поток.
+ *          Для асинхронных механизмов ввода-вывода (io_uring), в которых данные читает
+ *          ядро, предназначены onData() и методы доступа к очереди ответов.
+ *          В потоковом режиме данные вектора не сохраняются: каждая порция из входного
+ *          буфера сразу добавляется к сумме, и память соединения не зависит от длины вектора
+ */
+class Connection {
+public:
+    /**
+     * @brief Конструктор соединения
+     * @param sock Неблокирующий сокет клиента
+     * @param peer Адрес клиента для записи в журнал
+     * @param logger Ссылка на журнал
+     * @param userDb Ссылка на базу данных пользователей
+     * @param authenticator Ссылка на аутентификатор
+     * @param processor Ссылка на обработчик данных
+     * @param pool Пул буферов для данных векторов (пул потока, обслуживающего соединение)
+     * @param streaming Потоковое суммирование векторов без их сохранения
+     * @param metrics Метрики векторов и закрытых соединений (nullptr - не учитывать)
+     */
+    Connection(int sock, const std::string& peer, Logger& logger, UserDatabase& userDb,
+               Authenticator& authenticator, DataProcessor& processor, BufferPool& pool,
+               bool streaming = false, Metrics* metrics = nullptr);
+
+    /**
+     * @brief Деструктор соединения
+     * @details Закрывает сокет клиента и учитывает закрытие в метриках
+     */
+    ~Connection();
+
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    /**
+     * @brief Получение сокета соединения
+     * @return Дескриптор сокета клиента
+     */
+    int socket() const {
+        return sock;
+    }
+
+    /**
+     * @brief Привязка соединения к трассируемой сессии
+     * @param session Номер сессии из Tracer::startSession() (0 - не трассируется)
+     * @details Вызывается сразу после приема подключения: с этого момента
+     *          отсчитывается этап приема строки аутентификации
+     */
+    void setTraceSession(uint64_t session) {
+        traceSession = session;
+        authStarted = session ? Tracer::now() : 0;
+    }
+
+    /**
+     * @brief Получение номера трассируемой сессии
+     * @return Номер сессии (0 - не трассируется)
+     */
+    uint64_t traceSessionId() const {
+        return traceSession;
+    }
+
+    /**
+     * @brief Обработка готовности сокета к чтению
+     * @details Читает данные до EAGAIN или до исчерпания бюджета чтения
+     * @return true - соединение активно,
+     *         false - соединение нужно закрыть
+     */
+    bool onReadable();
+
+    /**
+     * @brief Обработка готовности сокета к записи
+     * @details Досылает накопленные ответы клиенту
+     * @return true - соединение активно,
+     *         false - соединение нужно закрыть
+     */
+    bool onWritable();
+
+    /**
+     * @brief Обработка данных, уже принятых вызывающей стороной
+     * @param data Принятые данные
+     * @param len Длина данных
+     * @return true - соединение активно,
+     *         false - соединение можно закрыть после отправки ответов
+     */
+    bool onData(const char* data, size_t len);
+
+    /**
+     * @brief Получение неотправленных ответов
+     * @param len Длина неотправленных данных
+     * @return Указатель на неотправленные данные
+     * @note Указатель действителен до следующего вызова onData() или outputSent()
+     */
+    const char* pendingOutput(size_t& len) const {
+        len = outBuffer.size() - outOffset;
+        return outBuffer.data() + outOffset;
+    }
+
+    /**
+     * @brief Учет отправленных вызывающей стороной байт
+     * @param len Количество отправленных байт
+     */
+    void outputSent(size_t len);
+
+    /**
+     * @brief Проверка завершения сессии
+     * @return true - все ответы отправлены и соединение можно закрыть
+     */
+    bool isFinished() const {
+        return state == State::Closing && outOffset == outBuffer.size();
+    }
+
+    /**
+     * @brief Проверка наличия непрочитанных данных
+     * @return true - чтение прервано по бюджету и сокет нужно обработать повторно
+     */
+    bool hasPendingInput() const {
+        return pendingInput;
+    }
+
+    static const size_t READ_BUDGET = 1 << 20; ///< Максимум байт, читаемых за один вызов onReadable()
+
+private:
+    /**
+     * @brief Состояния протокола
+     */
+    enum class State {
+        ReadAuth, ///< Ожидание строки LOGIN+SALT+HASH
+        ReadCount, ///< Ожидание количества векторов
+        ReadLength, ///< Ожидание длины очередного вектора
+        ReadPayload, ///< Ожидание данных вектора
+        Closing ///< Отправка оставшихся ответов и закрытие
+    };
+
+    int sock; ///< Сокет клиента
+    std::string peer; ///< Адрес клиента
+    Logger& logger; ///< Ссылка на журнал
+    UserDatabase& userDb; ///< Ссылка на базу данных пользователей
+    Authenticator& authenticator; ///< Ссылка на аутентификатор
+    DataProcessor& processor; ///< Ссылка на обработчик данных
+    BufferPool& pool; ///< Пул буферов для данных векторов
+    bool streaming; ///< Потоковый режим обработки векторов
+    Metrics* stats; ///< Метрики (nullptr - не учитываются)
+
+    State state; ///< Текущее состояние протокола
+    bool pendingInput; ///< Чтение прервано по бюджету
+    FrameReader input; ///< Входной буфер и разбор кадров
+    std::string authMessage; ///< Строка аутентификации
+    uint32_t header; ///< Принятое поле количества или длины
+    uint32_t numVectors; ///< Количество векторов в сессии
+    uint32_t vectorIndex; ///< Номер текущего вектора
+    BufferPool::Buffer payload; ///< Данные текущего вектора (не используется в потоковом режиме)
+    DataProcessor::Accumulator accumulator; ///< Сумма текущего вектора в потоковом режиме
+    size_t payloadBytes; ///< Размер данных текущего вектора в байтах
+    size_t payloadRead; ///< Принято байт данных текущего вектора
+    uint64_t payloadStarted; ///< Время получения длины текущего вектора (при метриках или трассировке)
+    std::string outBuffer; ///< Неотправленные ответы клиенту
+    size_t outOffset; ///< Смещение неотправленной части outBuffer
+    uint64_t traceSession; ///< Номер трассируемой сессии (0 - не трассируется)
+    uint64_t authStarted; ///< Время приема подключения (только при трассировке)
+
+    /**
+     * @brief Разбор накопленных во входном буфере кадров
+     * @param flush_auth Принять неполную строку аутентификации (клиент замолчал)
+     */
+    void processInput(bool flush_auth);
+
+    /**
+     * @brief Проверка клиента по принятой строке аутентификации
+     * @return Успех или код ошибки аутентификации
+     */
+    SessionStatus completeAuth();
+
+    /**
+     * @brief Обработка принятого поля количества или длины
+     * @return Успех или InvalidLength при невалидной длине вектора
+     */
+    SessionStatus completeHeader();
+
+    /**
+     * @brief Обработка порции данных вектора, уже находящейся в памяти
+     * @param data Данные
+     * @param len Длина данных (не больше оставшейся части вектора)
+     */
+    void consumePayload(const char* data, size_t len);
+
+    /**
+     * @brief Обработка полностью принятого вектора
+     */
+    void completePayload();
+
+    /**
+     * @brief Постановка ответа в очередь отправки
+     * @param data Указатель на данные
+     * @param len Длина данных
+     */
+    void queue(const void* data, size_t len);
+
+    /**
+     * @brief Отправка накопленных ответов
+     * @return true - соединение активно,
+     *         false - соединение нужно закрыть
+     */
+    bool flush();
+
+    /**
+     * @brief Отправка "ERR" клиенту и перевод соединения в состояние закрытия
+     * @param message Текст сообщения для записи в журнал
+     */
+    void fail(const std::string& message);
+
+    /**
+     * @brief Отправка "ERR" клиенту по результату шага протокола
+     * @param status Результат с кодом ошибки
+     */
+    void fail(const SessionStatus& status);
+};
@@ -5,16 +5,91 @@
 
 #pragma once
 #include <vector>
+#include <string>
 #include <cstdint>
+#include <cstddef>
 
 class Logger; ///< Предварительное объявление класса Logger
+class ThreadPool; ///< Предварительное объявление класса ThreadPool
+class Metrics; ///< Предварительное объявление класса Metrics
 
 /**
  * @brief Класс для обработки числовых данных
- * @details Выполняет вычисления над векторами целых чисел
+ * @details Выполняет вычисления над векторами целых чисел.
+ *          Суммирование выполняется векторным ядром (AVX-512, AVX2 или SSE4.1),
+ *          выбранным при запуске по результатам CPUID, либо переносимым скалярным ядром.
+ *          Все ядра суммируют в 64-битных элементах, поэтому результат совпадает до бита.
+ *          Векторы длиннее заданного порога делятся на части размером с кэш, которые
+ *          суммируются параллельно в пуле потоков; частичные суммы int64_t складываются
+ *          точно, поэтому результат совпадает с последовательным вычислением
  */
 class DataProcessor {
 public:
+    /**
+     * @brief Накопитель суммы для потоковой обработки вектора
+     * @details Позволяет вычислять среднее по частям, не храня вектор целиком:
+     *          данные подаются порциями через feed()/feedBytes(), результат
+     *          получается вызовом DataProcessor::finalize()
+     */
+    class Accumulator {
+    public:
+        /**
+         * @brief Сброс накопителя перед новым вектором
+         */
+        void reset() {
+            total = 0;
+            elements = 0;
+            partialLen = 0;
+        }
+
+        /**
+         * @brief Добавление целых элементов
+         * @param data Указатель на элементы
+         * @param count Количество элементов
+         */
+        void feed(const int32_t* data, size_t count);
+
+        /**
+         * @brief Добавление произвольного фрагмента байтового потока
+         * @param data Указатель на байты (выравнивание не требуется)
+         * @param len Количество байт
+         * @note Неполный элемент в конце фрагмента сохраняется до следующего вызова
+         */
+        void feedBytes(const char* data, size_t len);
+
+        /**
+         * @brief Добавление уже вычисленной частичной суммы
+         * @param sum Сумма элементов части
+         * @param count Количество элементов части
+         */
+        void merge(int64_t sum, uint64_t count) {
+            total += sum;
+            elements += count;
+        }
+
+        /**
+         * @brief Получение суммы накопленных элементов
+         * @return Сумма в int64_t
+         */
+        int64_t sum() const {
+            return total;
+        }
+
+        /**
+         * @brief Получение количества накопленных элементов
+         * @return Количество целых элементов
+         */
+        uint64_t count() const {
+            return elements;
+        }
+
+    private:
+        int64_t total = 0; ///< Сумма элементов (int64_t предотвращает промежуточное переполнение)
+        uint64_t elements = 0; ///< Количество элементов
+        char partial[sizeof(int32_t)] = {}; ///< Байты неполного элемента
+        size_t partialLen = 0; ///< Количество байт неполного элемента
+    };
+
     /**
      * @brief Вычисление среднего арифметического значений вектора
      * @param vector Вектор целых чисел для обработки
@@ -24,4 +99,68 @@ public:
      * @warning При пустом векторе возвращает 0
      */
     int32_t calculateAverage(const std::vector<int32_t>& vector, Logger& logger);
+
+    /**
+     * @brief Вычисление среднего арифметического значений массива
+     * @param data Указатель на элементы
+     * @param count Количество элементов
+     * @param logger Ссылка на объект журнала для записи ошибок
+     * @return Среднее арифметическое значений массива
+     * @note при переполнении возвращает INT32_MAX или INT32_Min
+     * @warning При пустом массиве возвращает 0
+     */
+    int32_t calculateAverage(const int32_t* data, size_t count, Logger& logger);
+
+    /**
+     * @brief Вычисление среднего арифметического по накопителю
+     * @param acc Накопитель с суммой и количеством элементов
+     * @param logger Ссылка на объект журнала для записи ошибок
+     * @return Среднее арифметическое, совпадающее с результатом calculateAverage
+     * @note при переполнении возвращает INT32_MAX или INT32_Min
+     * @warning При пустом накопителе возвращает 0
+     */
+    int32_t finalize(const Accumulator& acc, Logger& logger);
+
+    /**
+     * @brief Получение названия используемого ядра суммирования
+     * @return Название ядра ("avx512", "avx2", "sse4.1" или "scalar")
+     */
+    static const char* kernelName();
+
+    /**
+     * @brief Получение списка ядер суммирования, поддерживаемых процессором
+     * @return Названия ядер в порядке убывания предпочтения
+     */
+    static std::vector<std::string> availableKernels();
+
+    /**
+     * @brief Принудительный выбор ядра суммирования
+     * @param name Название ядра
+     * @return true - ядро выбрано, false - ядро неизвестно или не поддерживается процессором
+     * @warning Не потокобезопасно: вызывается до запуска рабочих потоков
+     */
+    static bool selectKernel(const std::string& name);
+
+    /**
+     * @brief Настройка параллельного суммирования больших векторов
+     * @param pool Пул потоков вычислений (nullptr - только последовательное суммирование)
+     * @param threshold Минимальная длина вектора в элементах для параллельной обработки
+     * @note Пул должен существовать, пока используется обработчик
+     */
+    void setParallel(ThreadPool* pool, size_t threshold);
+
+    /**
+     * @brief Подключение метрик
+     * @param metrics Метрики для учета ограничений среднего границами int32_t (nullptr - не учитывать)
+     */
+    void setMetrics(Metrics* metrics) {
+        stats = metrics;
+    }
+
+    static const size_t PARALLEL_CHUNK = 256 * 1024; ///< Длина части вектора в элементах (1 МБ)
+
+private:
+    ThreadPool* pool = nullptr; ///< Пул потоков для параллельного суммирования
+    size_t parallelThreshold = 0; ///< Порог длины вектора для параллельного суммирования
+    Metrics* stats = nullptr; ///< Метрики (nullptr - не учитываются)
 };
@@ -0,0 +1,100 @@
+/**
+ * @file DbReloader.h
+ * @brief Заголовочный файл модуля DbReloader - фоновая перезагрузка базы пользователей
+ */
+
+#pragma once
+#include <string>
+#include <thread>
+#include <atomic>
+
+class UserDatabase; ///< Предварительное объявление класса UserDatabase
+class Logger; ///< Предварительное объявление класса Logger
+
+/**
+ * @brief Фоновая перезагрузка базы пользователей
+ * @details Отдельный поток перезагружает базу по запросу (requestReload(), например
+ *          по сигналу SIGHUP) и, если включено наблюдение, при изменении файла базы
+ *          (inotify). Наблюдается каталог файла, поэтому замена файла переименованием
+ *          (как в UserDatabase::save() и большинстве редакторов) тоже обнаруживается.
+ *          События файла, идущие подряд, объединяются: база перезагружается после
+ *          паузы в RELOAD_DELAY_MS. Рабочие потоки сервера продолжают читать
+ *          прежний снимок базы до публикации нового
+ */
+class DbReloader {
+public:
+    static const int RELOAD_DELAY_MS = 200; ///< Пауза после последнего изменения файла
+
+    /**
+     * @brief Конструктор
+     * @param db База пользователей (должна быть загружена)
+     * @param logger Ссылка на журнал
+     */
+    DbReloader(UserDatabase& db, Logger& logger);
+
+    /**
+     * @brief Деструктор
+     * @details Останавливает поток перезагрузки
+     */
+    ~DbReloader();
+
+    DbReloader(const DbReloader&) = delete;
+    DbReloader& operator=(const DbReloader&) = delete;
+
+    /**
+     * @brief Запуск потока перезагрузки
+     * @param watch_file Перезагружать базу при изменении файла
+     * @return true - поток запущен,
+     *         false - не удалось создать дескрипторы событий
+     */
+    bool start(bool watch_file);
+
+    /**
+     * @brief Запрос перезагрузки базы
+     * @details Безопасен для вызова из любого потока; запросы, пришедшие во время
+     *          перезагрузки, объединяются в одну следующую
+     */
+    void requestReload();
+
+    /**
+     * @brief Остановка потока перезагрузки
+     */
+    void stop();
+
+    /**
+     * @brief Получение количества выполненных перезагрузок
+     * @return Количество успешных перезагрузок
+     */
+    unsigned reloads() const {
+        return reloadCount.load();
+    }
+
+    /**
+     * @brief Получение количества неудачных перезагрузок
+     * @return Количество перезагрузок, при которых сохранена прежняя база
+     */
+    unsigned failures() const {
+        return failureCount.load();
+    }
+
+private:
+    /**
+     * @brief Тело потока перезагрузки
+     */
+    void run();
+
+    /**
+     * @brief Перезагрузка базы с учетом результата
+     */
+    void reload();
+
+    UserDatabase& db; ///< База пользователей
+    Logger& logger; ///< Журнал
+    int eventFd; ///< Дескриптор запросов перезагрузки и остановки
+    int inotifyFd; ///< Дескриптор наблюдения за каталогом базы (-1 - наблюдение выключено)
+    std::string fileName; ///< Имя файла базы в наблюдаемом каталоге
+    std::thread thread; ///< Поток перезагрузки
+    std::atomic<bool> stopping; ///< Запрос остановки
+    std::atomic<unsigned> reloadCount; ///< Количество успешных перезагрузок
+    std::atomic<unsigned> failureCount; ///< Количество неудачных перезагрузок
+};
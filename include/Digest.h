@@ -0,0 +1,116 @@
+/**
+ * @file Digest.h
+ * @brief Заголовочный файл модуля Digest - хеш-функции аутентификации
+ */
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Хеш-функция аутентификации
+ * @details Единый интерфейс над реализациями SHA-1 и SHA-256 библиотеки Crypto++.
+ *          Crypto++ при первом использовании определяет возможности процессора
+ *          и выбирает аппаратную реализацию (расширения SHA-NI на x86-64, Crypto
+ *          Extensions на ARMv8), а при их отсутствии - программную; выбранная
+ *          реализация сообщается методом provider().
+ *          Объект переиспользуется: final() возвращает его в начальное состояние
+ * @note Объект не потокобезопасен: каждый поток использует свой экземпляр
+ */
+class Digest {
+public:
+    /**
+     * @brief Алгоритм хеширования
+     */
+    enum class Algorithm {
+        Sha1, ///< SHA-1 (20 байт)
+        Sha256 ///< SHA-256 (32 байта)
+    };
+
+    static const size_t ALGORITHM_COUNT = 2; ///< Количество алгоритмов
+    static const size_t MAX_SIZE = 32; ///< Наибольший размер хеша в байтах
+
+    virtual ~Digest() = default;
+
+    /**
+     * @brief Добавление данных к хешу
+     * @param data Данные
+     * @param size Размер данных в байтах
+     */
+    virtual void update(const void* data, size_t size) = 0;
+
+    /**
+     * @brief Завершение вычисления хеша
+     * @param out Буфер размером не меньше size()
+     * @details После вызова объект готов к вычислению следующего хеша
+     */
+    virtual void final(unsigned char* out) = 0;
+
+    /**
+     * @brief Получение размера хеша
+     * @return Размер хеша в байтах
+     */
+    virtual size_t size() const = 0;
+
+    /**
+     * @brief Получение используемой реализации
+     * @return Название реализации Crypto++ (например, "SHANI", "ARMv8", "C++")
+     */
+    virtual std::string provider() const = 0;
+
+    /**
+     * @brief Создание объекта хеш-функции
+     * @param algorithm Алгоритм
+     * @return Новый объект
+     */
+    static std::unique_ptr<Digest> create(Algorithm algorithm);
+
+    /**
+     * @brief Разбор названия алгоритма
+     * @param name Название: "sha1" или "sha256"
+     * @param out_algorithm Алгоритм
+     * @return true - название известно
+     */
+    static bool parse(const std::string& name, Algorithm& out_algorithm);
+
+    /**
+     * @brief Получение названия алгоритма
+     * @param algorithm Алгоритм
+     * @return Название для журнала ("SHA-1", "SHA-256")
+     */
+    static const char* name(Algorithm algorithm);
+
+    /**
+     * @brief Получение размера хеша алгоритма
+     * @param algorithm Алгоритм
+     * @return Размер хеша в байтах
+     */
+    static size_t size(Algorithm algorithm);
+
+    /**
+     * @brief Декодирование hex-строки в байты
+     * @param hex Hex-строка длиной 2 * size (символы в любом регистре)
+     * @param out Буфер результата размером size
+     * @param size Количество байтов
+     * @return true - строка содержит только hex-символы
+     */
+    static bool decodeHex(const char* hex, unsigned char* out, size_t size);
+
+    /**
+     * @brief Кодирование байтов в hex-строку
+     * @param data Байты
+     * @param size Количество байтов
+     * @param out Буфер результата размером 2 * size (прописные символы)
+     */
+    static void encodeHex(const unsigned char* data, size_t size, char* out);
+
+    /**
+     * @brief Сравнение буферов за время, не зависящее от содержимого
+     * @param a Первый буфер
+     * @param b Второй буфер
+     * @param size Размер буферов
+     * @return true - буферы совпадают
+     */
+    static bool equal(const unsigned char* a, const unsigned char* b, size_t size);
+};
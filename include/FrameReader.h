@@ -0,0 +1,77 @@
+/**
+ * @file FrameReader.h
+ * @brief Заголовочный файл модуля FrameReader - разбор кадров протокола из входного потока
+ */
+
+#pragma once
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "RingBuffer.h"
+
+/**
+ * @brief Разбор кадров протокола поверх кольцевого буфера соединения
+ * @details Протокол состоит из текстовой строки аутентификации и двоичных кадров
+ *          (поля uint32_t и массивы int32_t). Данные из сокета принимаются в буфер
+ *          порциями произвольной длины, а методы next*() извлекают кадр только тогда,
+ *          когда он поступил полностью. Поэтому короткие чтения и несколько кадров,
+ *          пришедших одним чтением, обрабатываются одинаково. Буфер выделяется один
+ *          раз на соединение, разбор кадров выделений памяти не требует
+ */
+class FrameReader {
+public:
+    static const size_t DEFAULT_CAPACITY = 16 * 1024; ///< Емкость буфера по умолчанию
+
+    /**
+     * @brief Конструктор
+     * @param capacity Емкость входного буфера
+     */
+    explicit FrameReader(size_t capacity = DEFAULT_CAPACITY) : input(capacity) {}
+
+    /**
+     * @brief Доступ к входному буферу для приема данных
+     * @return Ссылка на кольцевой буфер
+     */
+    RingBuffer& buffer() {
+        return input;
+    }
+
+    /**
+     * @brief Получение объема непрочитанных данных
+     * @return Количество байт в буфере
+     */
+    size_t buffered() const {
+        return input.size();
+    }
+
+    /**
+     * @brief Извлечение текстовой строки
+     * @param line Строка без завершающего '\n' (память строки переиспользуется)
+     * @param max_len Максимальная длина строки
+     * @param partial Вернуть неполную строку, если в буфере есть данные
+     * @return true - строка извлечена, false - данных недостаточно
+     * @details Строка считается полной при получении '\n' или при накоплении max_len байт
+     */
+    bool nextLine(std::string& line, size_t max_len, bool partial = false);
+
+    /**
+     * @brief Извлечение поля uint32_t
+     * @param value Значение поля
+     * @return true - поле извлечено, false - данных недостаточно
+     */
+    bool nextU32(uint32_t& value);
+
+    /**
+     * @brief Извлечение доступной части массива данных
+     * @param len Оставшаяся длина массива в байтах
+     * @param sink Обработчик непрерывных участков (const char* data, size_t len)
+     * @return Количество извлеченных байт
+     */
+    template <typename Sink>
+    size_t nextPayload(size_t len, Sink&& sink) {
+        return input.drain(len, sink);
+    }
+
+private:
+    RingBuffer input; ///< Входной буфер соединения
+};
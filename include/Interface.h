@@ -6,16 +6,45 @@
 #pragma once
 #include <boost/program_options.hpp>
 #include <string>
+#include <cstdint>
 namespace po = boost::program_options;
 
 /**
  * @brief Структура для хранения параметров сервера
- * @details Содержит пути к файлам базы данных и журнала, а также номер порта
+ * @details Содержит пути к файлам базы данных и журнала, номер порта, режим ввода-вывода
+ *         , количество рабочих потоков
+ *          и режимы обработки векторов
  */
 struct Params {
     std::string dbFile; ///< Путь к файлу базы данных пользователей
     std::string logFile; ///< Путь к файлу журнала работы сервера
     unsigned short port; ///< Порт
+    std::string ioMode; ///< Режим ввода-вывода: "epoll", "uring" или "blocking"
+    unsigned workers; ///< Количество рабочих потоков (0 - по числу ядер)
+    bool streaming; ///< Потоковое суммирование векторов без буферизации всего вектора
+    bool hugePages; ///< Большие страницы для крупных буферов векторов
+    size_t parallelThreshold; ///< Длина вектора для параллельного суммирования (0 - отключено)
+    unsigned computeThreads; ///< Потоки параллельного суммирования (0 - по числу ядер)
+    bool asyncLog; ///< Асинхронная запись журнала фоновым потоком
+    size_t logQueue; ///< Емкость очереди асинхронного журнала (записей)
+    std::string logOverflow; ///< Поведение при переполнении очереди журнала: "block" или "drop"
+    std::string logLevel; ///< Минимальный уровень записей журнала: "trace" ... "critical" или "off"
+    std::string logFormat; ///< Формат файла журнала: "text" или "binary"
+    uint64_t logRotateSize; ///< Размер файла журнала для ротации в байтах (0 - без ротации по размеру)
+    unsigned logRotateInterval; ///< Период ротации журнала в секундах (0 - без ротации по времени)
+    unsigned logKeep; ///< Количество хранимых ротированных файлов журнала
+    bool logCompress; ///< Сжатие ротированных файлов журнала gzip
+    bool pipeline; ///< Прием следующего вектора во время вычисления предыдущего
+    bool watchDb; ///< Перезагружать базу пользователей при изменении файла
+    std::string hash; ///< Алгоритм хеширования аутентификации: "sha1" или "sha256"
+    bool tickets; ///< Выдача билетов возобновления сессии
+    unsigned ticketLifetime; ///< Срок действия билета в секундах
+    std::string ticketSecret; ///< Файл секрета билетов (пусто - случайный секрет процесса)
+    unsigned authThrottle; ///< Порог неудачных попыток аутентификации (0 - ограничение отключено)
+    unsigned authThrottleWindow; ///< Период полураспада счетчиков неудач в секундах
+    unsigned short metricsPort; ///< Порт HTTP-экспорта метрик (0 - экспорт отключен)
+    std::string traceFile; ///< Файл трассы в формате Chrome trace_event (пусто - трассировка отключена)
+    unsigned traceSample; ///< Трассировать каждую N-ю сессию
 };
 
 /**
@@ -29,9 +58,14 @@ private:
     Params params; ///< Экземпляр структуры с параметрами
 
 public:
+    static const unsigned MAX_WORKERS = 1024; ///< Максимальное количество рабочих потоков
+
     /**
      * @brief Конструктор класса Interface
-     * @details Инициализирует парсер опциями: help, file, log, port
+     * @details Инициализирует парсер опциями: help, file, log, port, io, workers, stream, huge-pages,
+     *          parallel-threshold, compute-threads, async-log, log-queue, log-overflow,
+     *          log-level, log-format, log-rotate-size, log-rotate-interval, log-keep, log-compress, pipeline,
+     *          watch-db, hash, tickets, ticket-lifetime, ticket-secret, auth-throttle, auth-throttle-window
      */
     Interface();
 
@@ -40,7 +74,7 @@ public:
      * @param argc Количество аргументов
      * @param argv Массив аргументов
      * @return true - успешный парсинг рабочих параметров,
-     *         false - запрошена справка (help)
+     *         false - запрошена справка (help) или значение параметра недопустимо
      * @throw po::error при ошибках парсинга
      */
     bool Parser(int argc, char** argv);
@@ -0,0 +1,150 @@
+/**
+ * @file IoUring.h
+ * @brief Заголовочный файл модуля IoUring - обертка над интерфейсом io_uring ядра Linux
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <linux/io_uring.h>
+
+/**
+ * @brief Кольцо io_uring с кольцом предоставленных буферов для приема
+ * @details Работает напрямую через системные вызовы io_uring_setup/io_uring_enter/
+ *          io_uring_register (без liburing). Заявки накапливаются в очереди SQ и
+ *          отправляются в ядро одним вызовом submitAndWait(). Для приема данных
+ *          регистрируется кольцо буферов (IORING_REGISTER_PBUF_RING): ядро само
+ *          выбирает свободный буфер, а приложение возвращает его через recycle()
+ * @note Объект предназначен для использования из одного потока
+ */
+class IoUring {
+public:
+    /**
+     * @brief Создание кольца и регистрация буферов приема
+     * @param entries Размер очереди заявок
+     * @param buffer_count Количество буферов приема (степень двойки)
+     * @param buffer_size Размер одного буфера приема
+     * @throw std::system_error если ядро не поддерживает io_uring или кольца буферов
+     */
+    IoUring(unsigned entries, unsigned buffer_count, unsigned buffer_size);
+
+    /**
+     * @brief Деструктор
+     * @details Освобождает отображенную память колец и закрывает дескриптор io_uring
+     */
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    /**
+     * @brief Постановка многократного accept (IORING_ACCEPT_MULTISHOT)
+     * @param listen_sock Слушающий сокет
+     * @param user_data Метка завершений
+     */
+    void prepareAcceptMultishot(int listen_sock, uint64_t user_data);
+
+    /**
+     * @brief Постановка приема в буфер из кольца предоставленных буферов
+     * @param sock Сокет клиента
+     * @param user_data Метка завершений
+     * @param multishot Многократный прием (IORING_RECV_MULTISHOT)
+     */
+    void prepareRecv(int sock, uint64_t user_data, bool multishot);
+
+    /**
+     * @brief Постановка отправки данных
+     * @param sock Сокет клиента
+     * @param data Данные (должны оставаться доступными до завершения)
+     * @param len Длина данных
+     * @param user_data Метка завершения
+     */
+    void prepareSend(int sock, const void* data, size_t len, uint64_t user_data);
+
+    /**
+     * @brief Отправка накопленных заявок и ожидание хотя бы одного завершения
+     * @throw std::system_error при ошибке io_uring_enter
+     */
+    void submitAndWait();
+
+    /**
+     * @brief Обход готовых завершений
+     * @param handler Функция-обработчик (user_data, res, flags)
+     * @return Количество обработанных завершений
+     */
+    template <typename Handler>
+    unsigned forEachCompletion(Handler&& handler) {
+        unsigned head = *cqHead;
+        unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        unsigned count = 0;
+        for (; head != tail; ++head, ++count) {
+            const io_uring_cqe& cqe = cqes[head & *cqMask];
+            handler(cqe.user_data, cqe.res, cqe.flags);
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+        publishBuffers();
+        return count;
+    }
+
+    /**
+     * @brief Получение данных буфера приема
+     * @param bid Номер буфера из флагов завершения
+     * @return Указатель на начало буфера
+     */
+    const char* buffer(unsigned bid) const {
+        return bufferMemory + static_cast<size_t>(bid) * bufferSize;
+    }
+
+    /**
+     * @brief Возврат буфера приема в кольцо
+     * @param bid Номер буфера
+     * @note Буферы становятся доступны ядру после обработки текущей пачки завершений
+     */
+    void recycle(unsigned bid);
+
+private:
+    int ringFd; ///< Дескриптор io_uring
+    unsigned sqEntries; ///< Размер очереди заявок
+    void* sqRing; ///< Отображение кольца SQ
+    size_t sqRingSize; ///< Размер отображения кольца SQ
+    void* cqRing; ///< Отображение кольца CQ (может совпадать с sqRing)
+    size_t cqRingSize; ///< Размер отображения кольца CQ
+    io_uring_sqe* sqes; ///< Массив заявок
+    unsigned* sqHead; ///< Голова очереди SQ (изменяется ядром)
+    unsigned* sqTail; ///< Хвост очереди SQ
+    unsigned* sqMask; ///< Маска индексов SQ
+    unsigned* sqArray; ///< Массив индексов заявок
+    unsigned* cqHead; ///< Голова очереди CQ
+    unsigned* cqTail; ///< Хвост очереди CQ (изменяется ядром)
+    unsigned* cqMask; ///< Маска индексов CQ
+    io_uring_cqe* cqes; ///< Массив завершений
+    unsigned sqeTail; ///< Локальный хвост SQ (еще не опубликованные заявки)
+
+    io_uring_buf* bufRing; ///< Кольцо предоставленных буферов (хвост - поле resv нулевого элемента)
+    size_t bufRingSize; ///< Размер отображения кольца буферов
+    char* bufferMemory; ///< Память буферов приема
+    unsigned bufferCount; ///< Количество буферов приема
+    unsigned bufferSize; ///< Размер одного буфера приема
+    unsigned short bufTail; ///< Локальный хвост кольца буферов
+
+    /**
+     * @brief Получение свободной заявки
+     * @return Обнуленная заявка в очереди SQ
+     */
+    io_uring_sqe* nextSqe();
+
+    /**
+     * @brief Публикация возвращенных буферов для ядра
+     * @note Массив bufs структуры io_uring_buf_ring в C++ смещен из-за пустой структуры
+     *       в __DECLARE_FLEX_ARRAY, поэтому кольцо адресуется как массив io_uring_buf
+     */
+    void publishBuffers() {
+        __atomic_store_n(&bufRing[0].resv, bufTail, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * @brief Освобождение ресурсов кольца
+     */
+    void release();
+};
@@ -6,22 +6,292 @@
 #pragma once
 #include <string>
 #include <fstream>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <condition_variable>
+#include <deque>
+#include <ctime>
+#include <cstdint>
+#include <cstddef>
+#include <charconv>
+#include <type_traits>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <sys/uio.h>
+#include "BinaryLog.h"
+
+/**
+ * @brief Минимальный уровень записей, компилируемых в программу
+ * @details Номер уровня Logger::Level (0 - TRACE ... 5 - CRITICAL). Вызовы
+ *          Logger::log() и его сокращений ниже этого уровня удаляются компилятором
+ *          вместе с форматированием аргументов. Задается при сборке:
+ *          make LOG_MIN_LEVEL=2
+ */
+#ifndef VCALC_LOG_MIN_LEVEL
+#define VCALC_LOG_MIN_LEVEL 0
+#endif
 
 /**
  * @brief Класс для ведения журнала работы сервера
- * @details Обеспечивает запись информационных сообщений и ошибок в файл
+ * @details Обеспечивает запись информационных сообщений и ошибок в файл.
+ *          По умолчанию каждая запись сразу дописывается в файл. В асинхронном режиме
+ *          (startAsync()) запись только форматируется и помещается в ограниченную
+ *          кольцевую очередь без блокировок (несколько производителей, один потребитель),
+ *          а фоновый поток держит файл открытым и записывает накопленные строки
+ *          пачками одним вызовом writev.
+ *          Записи ниже порога setLevel() отбрасываются до форматирования. Методы
+ *          trace() ... critical() принимают части сообщения отдельными аргументами
+ *          и собирают строку только для записи, прошедшей порог; записи ниже
+ *          VCALC_LOG_MIN_LEVEL не компилируются.
+ *          В двоичном формате (setFormat()) запись - заголовок фиксированной длины
+ *          и типизированные аргументы (BinaryLog): время не форматируется, числа
+ *          не переводятся в текст, а неизменные части сообщения один раз
+ *          объявляются шаблоном. Текст восстанавливает утилита vcalc-logcat.
+ *          Файл открывается один раз и остается открытым. При ротации (setRotation())
+ *          по размеру или по времени файл переименовывается в PATH.YYYYmmdd-HHMMSS,
+ *          а запись продолжается в новый файл PATH. Сжатие gzip и удаление старых
+ *          файлов сверх заданного числа выполняет отдельный поток, поэтому запись
+ *          при ротации не обходит каталог журнала
+ * @note Методы записи безопасны для вызова из нескольких потоков
  */
 class Logger {
-private:
-    std::string logPath; ///< Путь к файлу журнала
-
 public:
+    /**
+     * @brief Поведение при переполнении очереди асинхронного журнала
+     */
+    enum class OverflowPolicy {
+        Block, ///< Ожидать освобождения места в очереди
+        Drop ///< Отбросить запись и увеличить счетчик отброшенных записей
+    };
+
+    /**
+     * @brief Уровни записей журнала
+     */
+    enum class Level {
+        Trace, ///< Подробная трассировка
+        Debug, ///< Отладочные сообщения
+        Info, ///< Информационные сообщения
+        Warning, ///< Предупреждения
+        Error, ///< Ошибки (дублируются в stderr)
+        Critical, ///< Критические ошибки (дублируются в stderr)
+        Off ///< Порог, отключающий журнал
+    };
+
+    /**
+     * @brief Формат файла журнала
+     */
+    enum class Format {
+        Text, ///< Строки "YYYY-MM-DD HH:MM:SS; УРОВЕНЬ; СООБЩЕНИЕ"
+        Binary ///< Двоичные записи BinaryLog
+    };
+
+    Logger();
+
+    /**
+     * @brief Деструктор
+     * @details Останавливает асинхронный режим, дописывая все накопленные записи
+     */
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
     /**
      * @brief Инициализация журнала
      * @param log_path Путь к файлу журнала
      */
     void init(const std::string& log_path);
 
+    /**
+     * @brief Выбор формата файла журнала
+     * @param format Формат
+     * @note Вызывается до первой записи и до startAsync()
+     */
+    void setFormat(Format format) {
+        binary.store(format == Format::Binary, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Получение формата файла журнала
+     * @return Формат
+     */
+    Format format() const {
+        return binary.load(std::memory_order_relaxed) ? Format::Binary : Format::Text;
+    }
+
+    /**
+     * @brief Настройка ротации файла журнала
+     * @param max_bytes Размер файла, при превышении которого он ротируется (0 - без ограничения)
+     * @param interval_seconds Период ротации в секундах (0 - без ротации по времени)
+     * @param keep Количество хранимых ротированных файлов
+     * @param compress Сжимать ротированные файлы gzip в фоновом потоке
+     * @note Вызывается до первой записи и до startAsync()
+     */
+    void setRotation(uint64_t max_bytes, unsigned interval_seconds, unsigned keep, bool compress);
+
+    /**
+     * @brief Включение асинхронного режима
+     * @param capacity Емкость очереди записей (округляется до степени двойки)
+     * @param policy Поведение при переполнении очереди
+     * @return true - режим включен, false - не удалось открыть файл журнала
+     */
+    bool startAsync(size_t capacity, OverflowPolicy policy = OverflowPolicy::Block);
+
+    /**
+     * @brief Выключение асинхронного режима
+     * @details Дописывает все накопленные записи, сбрасывает файл на диск (fsync)
+     *          и закрывает его. Последующие записи выполняются синхронно
+     */
+    void stop();
+
+    /**
+     * @brief Получение количества отброшенных записей
+     * @return Количество записей, отброшенных из-за переполнения очереди
+     */
+    uint64_t droppedRecords() const {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Установка порога записей
+     * @param level Минимальный записываемый уровень
+     */
+    void setLevel(Level level) {
+        threshold.store(level, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Получение порога записей
+     * @return Минимальный записываемый уровень
+     */
+    Level level() const {
+        return threshold.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Проверка, будет ли записана запись уровня
+     * @param level Уровень записи
+     * @return true - уровень не ниже порога и VCALC_LOG_MIN_LEVEL
+     */
+    bool enabled(Level level) const {
+        return static_cast<int>(level) >= VCALC_LOG_MIN_LEVEL && level != Level::Off &&
+               level >= threshold.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Разбор названия уровня
+     * @param name Название: "trace", "debug", "info", "warning", "error", "critical" или "off"
+     * @param level Результат разбора
+     * @return true - название распознано
+     */
+    static bool parseLevel(const std::string& name, Level& level);
+
+    /**
+     * @brief Получение названия уровня в записи журнала
+     * @param level Уровень
+     * @return "TRACE", "DEBUG", "INFO", "WARNING", "ERROR" или "CRITICAL"
+     */
+    static const char* levelName(Level level);
+
+    /**
+     * @brief Запись с отложенным форматированием
+     * @tparam L Уровень записи
+     * @param args Части сообщения: строки, символы, числа
+     * @details Аргументы передаются по ссылке; строка собирается в буфере потока
+     *          только если запись проходит порог, поэтому отброшенная запись стоит
+     *          одного сравнения. При L ниже VCALC_LOG_MIN_LEVEL вызов удаляется
+     *          компилятором. Строковые литералы (массивы char) - неизменные части
+     *          сообщения: в двоичном формате они входят в шаблон, а остальные
+     *          аргументы записываются значениями. Буфер char, не являющийся
+     *          литералом, передается как std::string_view
+     */
+    template <Level L, typename... Args>
+    void log(const Args&... args) {
+        if constexpr (static_cast<int>(L) >= VCALC_LOG_MIN_LEVEL) {
+            if (!enabled(L)) {
+                return;
+            }
+            bool binary_mode = binary.load(std::memory_order_relaxed);
+            if (binary_mode) {
+                std::string& text = formatBuffer();
+                text.clear();
+                (appendTemplate(text, args), ...);
+                uint32_t event = templateId(text);
+                std::string& body = binaryBuffer();
+                body.clear();
+                (appendBinaryArg(body, args), ...);
+                writeEvent(L, event, body);
+            }
+            if (!binary_mode || L >= Level::Error) {
+                std::string& line = formatBuffer();
+                line.clear();
+                (appendArg(line, args), ...);
+                if (binary_mode) {
+                    echo(L, line);
+                } else {
+                    emit(L, line);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Запись уровня TRACE с отложенным форматированием
+     * @param args Части сообщения
+     */
+    template <typename... Args>
+    void trace(const Args&... args) {
+        log<Level::Trace>(args...);
+    }
+
+    /**
+     * @brief Запись уровня DEBUG с отложенным форматированием
+     * @param args Части сообщения
+     */
+    template <typename... Args>
+    void debug(const Args&... args) {
+        log<Level::Debug>(args...);
+    }
+
+    /**
+     * @brief Запись уровня INFO с отложенным форматированием
+     * @param args Части сообщения
+     */
+    template <typename... Args>
+    void info(const Args&... args) {
+        log<Level::Info>(args...);
+    }
+
+    /**
+     * @brief Запись уровня WARNING с отложенным форматированием
+     * @param args Части сообщения
+     */
+    template <typename... Args>
+    void warning(const Args&... args) {
+        log<Level::Warning>(args...);
+    }
+
+    /**
+     * @brief Запись уровня ERROR с отложенным форматированием
+     * @param args Части сообщения
+     */
+    template <typename... Args>
+    void error(const Args&... args) {
+        log<Level::Error>(args...);
+    }
+
+    /**
+     * @brief Запись уровня CRITICAL с отложенным форматированием
+     * @param args Части сообщения
+     */
+    template <typename... Args>
+    void critical(const Args&... args) {
+        log<Level::Critical>(args...);
+    }
+
     /**
      * @brief Запись сообщения об ошибке
      * @param message Текст сообщения об ошибке
@@ -34,4 +304,272 @@ public:
      * @param message Текст информационного сообщения
      */
     void logInfo(const std::string& message);
+
+private:
+    /**
+     * @brief Ячейка очереди асинхронного журнала
+     * @details Номер sequence определяет владельца ячейки: производитель может занять
+     *          ячейку с номером, равным позиции записи, потребитель - прочитать ячейку
+     *          с номером позиции + 1 (схема ограниченной очереди Вьюкова)
+     */
+    struct Record {
+        std::atomic<size_t> sequence; ///< Номер состояния ячейки
+        std::string line; ///< Отформатированная строка (память переиспользуется)
+    };
+
+    std::string logPath; ///< Путь к файлу журнала
+    std::atomic<Level> threshold; ///< Минимальный записываемый уровень
+    std::atomic<bool> binary; ///< Двоичный формат файла
+    const uint64_t id; ///< Номер объекта для кэша шаблонов потока
+    std::mutex templateMutex; ///< Защита таблицы шаблонов
+    std::unordered_map<std::string, uint32_t> templates; ///< Номера шаблонов по тексту
+    std::vector<std::string> templateTexts; ///< Тексты шаблонов по номеру - 1
+    uint32_t dropEvent; ///< Шаблон сообщения об отброшенных записях
+    std::mutex writeMutex; ///< Сериализация записей в файл и защита fd, fileBytes, rotateAt
+    std::mutex stderrMutex; ///< Сериализация вывода ошибок в stderr
+    int fd; ///< Дескриптор открытого файла журнала (-1 - файл не открыт)
+    uint64_t fileBytes; ///< Длина открытого файла без заголовка текущего сегмента
+    time_t rotateAt; ///< Время следующей ротации по периоду (0 - не задано)
+    uint64_t rotateBytes; ///< Размер файла для ротации (0 - без ограничения)
+    unsigned rotateSeconds; ///< Период ротации в секундах (0 - без ротации по времени)
+    unsigned rotateKeep; ///< Количество хранимых ротированных файлов
+    bool rotateCompress; ///< Сжатие ротированных файлов
+    std::string rotateStamp; ///< Метка времени последнего ротированного файла
+    unsigned rotateSequence; ///< Суффикс -N последнего ротированного файла с этой меткой
+    std::thread housekeeper; ///< Поток сжатия и удаления ротированных файлов
+    std::mutex housekeepMutex; ///< Защита очереди ротированных файлов
+    std::condition_variable housekeepWake; ///< Оповещение потока обслуживания
+    std::deque<std::string> rotatedQueue; ///< Ротированные файлы, ожидающие обслуживания
+    bool housekeepStopping; ///< Запрос остановки потока обслуживания (защищено housekeepMutex)
+
+    std::unique_ptr<Record[]> ring; ///< Очередь записей
+    size_t ringMask; ///< Маска индекса очереди (емкость - 1)
+    alignas(64) std::atomic<size_t> ringTail; ///< Позиция записи производителей
+    alignas(64) size_t ringHead; ///< Позиция чтения фонового потока
+    std::atomic<bool> asyncMode; ///< Асинхронный режим включен
+    std::atomic<unsigned> activeProducers; ///< Производители внутри enqueue()
+    OverflowPolicy overflow; ///< Поведение при переполнении
+    std::atomic<uint64_t> dropped; ///< Количество отброшенных записей
+    std::thread writer; ///< Фоновый поток записи
+    std::atomic<bool> stopping; ///< Запрос остановки фонового потока
+    std::atomic<bool> writerSleeping; ///< Фоновый поток ожидает записей
+    std::mutex wakeMutex; ///< Защита ожидания фонового потока
+    std::condition_variable wakeUp; ///< Оповещение фонового потока
+
+    /**
+     * @brief Получение буфера форматирования текущего потока
+     * @return Строка, память которой переиспользуется между записями
+     */
+    static std::string& formatBuffer() {
+        static thread_local std::string buffer;
+        return buffer;
+    }
+
+    /**
+     * @brief Добавление части сообщения
+     * @param out Строка сообщения
+     * @param value Строка, символ, число или bool
+     * @details Целые числа форматируются std::to_chars без выделения памяти
+     */
+    template <typename T>
+    static void appendArg(std::string& out, const T& value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            out += value ? "true" : "false";
+        } else if constexpr (std::is_same_v<T, char>) {
+            out.push_back(value);
+        } else if constexpr (std::is_integral_v<T>) {
+            char buf[24];
+            auto result = std::to_chars(buf, buf + sizeof(buf), value);
+            out.append(buf, result.ptr);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            out += std::to_string(value);
+        } else {
+            out += value;
+        }
+    }
+
+    /**
+     * @brief Получение буфера двоичных аргументов текущего потока
+     * @return Строка, память которой переиспользуется между записями
+     */
+    static std::string& binaryBuffer() {
+        static thread_local std::string buffer;
+        return buffer;
+    }
+
+    /**
+     * @brief Добавление части сообщения в шаблон
+     * @param out Текст шаблона
+     * @param value Строковый литерал или аргумент
+     * @details Литерал добавляется текстом, аргумент - символом BinaryLog::PLACEHOLDER
+     */
+    template <typename T>
+    static void appendTemplate(std::string& out, const T& value) {
+        if constexpr (std::is_array_v<T>) {
+            out += value;
+        } else {
+            out.push_back(BinaryLog::PLACEHOLDER);
+        }
+    }
+
+    /**
+     * @brief Добавление аргумента в тело двоичной записи
+     * @param out Тело записи
+     * @param value Аргумент (строковые литералы пропускаются - они в шаблоне)
+     */
+    template <typename T>
+    static void appendBinaryArg(std::string& out, const T& value) {
+        if constexpr (std::is_array_v<T>) {
+            return;
+        } else if constexpr (std::is_same_v<T, bool>) {
+            BinaryLog::appendValue(out, BinaryLog::ArgType::Bool, static_cast<char>(value));
+        } else if constexpr (std::is_same_v<T, char>) {
+            BinaryLog::appendValue(out, BinaryLog::ArgType::Char, value);
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            BinaryLog::appendValue(out, BinaryLog::ArgType::Int, static_cast<int64_t>(value));
+        } else if constexpr (std::is_integral_v<T>) {
+            BinaryLog::appendValue(out, BinaryLog::ArgType::Uint, static_cast<uint64_t>(value));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            BinaryLog::appendValue(out, BinaryLog::ArgType::Double, static_cast<double>(value));
+        } else {
+            BinaryLog::appendString(out, std::string_view(value));
+        }
+    }
+
+    /**
+     * @brief Запись сообщения, прошедшего порог
+     * @param level Уровень сообщения
+     * @param message Текст сообщения
+     * @details Ошибки и критические ошибки дублируются в stderr
+     */
+    void emit(Level level, const std::string& message);
+
+    /**
+     * @brief Дублирование ошибки в stderr
+     * @param level Уровень сообщения (ниже ERROR не выводится)
+     * @param message Текст сообщения
+     */
+    void echo(Level level, const std::string& message);
+
+    /**
+     * @brief Получение номера шаблона
+     * @param text Текст шаблона
+     * @return Номер шаблона (с единицы)
+     * @details Новый шаблон получает следующий номер и записывается в журнал
+     */
+    uint32_t templateId(const std::string& text);
+
+    /**
+     * @brief Запись двоичного события
+     * @param level Уровень
+     * @param event Номер шаблона
+     * @param body Аргументы
+     */
+    void writeEvent(Level level, uint32_t event, const std::string& body);
+
+    /**
+     * @brief Запись готовой двоичной записи
+     * @param bytes Заголовок и тело записи
+     */
+    void writeRecord(const std::string& bytes);
+
+    /**
+     * @brief Начало сегмента двоичного журнала
+     * @param file Дескриптор файла журнала
+     * @details Записывает запись Segment и все известные шаблоны; вызывается под writeMutex
+     */
+    void startSegment(int file);
+
+    /**
+     * @brief Запись фрагментов в файл журнала с проверкой ротации
+     * @param iov Массив фрагментов
+     * @param count Количество фрагментов
+     * @param declaration Запись объявляет шаблон (в только что открытый файл не пишется)
+     * @details Вызывается под writeMutex
+     */
+    void appendFile(iovec* iov, int count, bool declaration = false);
+
+    /**
+     * @brief Подготовка файла к записи
+     * @param incoming Длина дописываемых данных
+     * @param started Результат: открыт новый файл (в двоичном формате - начат сегмент)
+     * @return true - файл открыт
+     * @details Открывает файл или ротирует его, если пора; вызывается под writeMutex
+     */
+    bool prepareFile(size_t incoming, bool& started);
+
+    /**
+     * @brief Открытие файла журнала
+     * @return true - файл открыт
+     */
+    bool openFile();
+
+    /**
+     * @brief Ротация файла журнала
+     * @return true - открыт новый файл
+     */
+    bool rotate();
+
+    /**
+     * @brief Удаление ротированных файлов сверх rotateKeep
+     */
+    void removeRotated();
+
+    /**
+     * @brief Сжатие ротированного файла
+     * @param path Путь к файлу
+     */
+    void compressFile(const std::string& path);
+
+    /**
+     * @brief Тело потока обслуживания ротированных файлов
+     */
+    void housekeepLoop();
+
+    /**
+     * @brief Занятие ячейки очереди асинхронного журнала
+     * @param pos Позиция занятой ячейки
+     * @return Ячейка или nullptr, если запись отброшена при переполнении
+     */
+    Record* claim(size_t& pos);
+
+    /**
+     * @brief Публикация заполненной ячейки для фонового потока
+     * @param record Ячейка
+     * @param pos Позиция ячейки
+     */
+    void publish(Record* record, size_t pos);
+
+    /**
+     * @brief Запись строки журнала
+     * @param level Уровень сообщения
+     * @param message Текст сообщения
+     */
+    void write(const char* level, const std::string& message);
+
+    /**
+     * @brief Помещение записи в очередь асинхронного журнала
+     * @param level Уровень сообщения
+     * @param message Текст сообщения
+     */
+    void enqueue(const char* level, const std::string& message);
+
+    /**
+     * @brief Тело фонового потока записи
+     */
+    void writerLoop();
+
+    /**
+     * @brief Запись пачки готовых записей из очереди
+     * @return Количество записанных записей
+     */
+    size_t drainBatch();
+
+    /**
+     * @brief Запись данных в файл журнала с учетом частичной записи
+     * @param file Дескриптор файла
+     * @param iov Массив фрагментов
+     * @param count Количество фрагментов
+     */
+    void writeAll(int file, iovec* iov, int count);
 };
@@ -0,0 +1,178 @@
+/**
+ * @file Metrics.h
+ * @brief Заголовочный файл модуля Metrics - счетчики и гистограммы задержек сервера
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Счетчики работы сервера и гистограммы задержек
+ * @details Каждый поток, записывающий метрики, получает свой блок счетчиков
+ *          (shard), выровненный по строке кэша. Запись выполняется только
+ *          потоком-владельцем обычными load/store без атомарных RMW-инструкций,
+ *          поэтому рабочие потоки не делят строки кэша и не ждут друг друга.
+ *          Снимок для экспорта складывает блоки всех потоков.
+ *          Гистограммы задержек устроены как HDR: значения в наносекундах делятся
+ *          на степени двойки, а каждая степень - на SUB_BUCKETS равных частей,
+ *          поэтому относительная погрешность квантилей не превышает 1/SUB_BUCKETS
+ *          при диапазоне от 1 нс до 2^MAX_EXPONENT нс
+ * @note Запись потокобезопасна. Объект должен существовать, пока в него пишут
+ */
+class Metrics {
+public:
+    /**
+     * @brief Счетчики событий
+     */
+    enum class Counter {
+        ConnectionsAccepted, ///< Принятые подключения
+        ConnectionsClosed, ///< Закрытые подключения
+        AuthSuccesses, ///< Успешные аутентификации
+        AuthFailures, ///< Неудачные аутентификации
+        VectorsProcessed, ///< Обработанные векторы
+        BytesProcessed, ///< Байты данных обработанных векторов
+        OverflowClamps, ///< Средние, ограниченные границами int32_t
+        Count ///< Количество счетчиков
+    };
+
+    /**
+     * @brief Измеряемые задержки
+     */
+    enum class Latency {
+        Auth, ///< Проверка строки аутентификации
+        VectorReceive, ///< Прием данных вектора от длины до последнего байта
+        Compute, ///< Вычисление среднего
+        Count ///< Количество гистограмм
+    };
+
+    static const unsigned SUB_BITS = 4; ///< Двоичный логарифм SUB_BUCKETS
+    static const unsigned SUB_BUCKETS = 1u << SUB_BITS; ///< Частей в каждой степени двойки
+    static const unsigned MAX_EXPONENT = 40; ///< Граница диапазона 2^MAX_EXPONENT нс (около 18 минут)
+    static const size_t BUCKETS = (MAX_EXPONENT - SUB_BITS + 1) * SUB_BUCKETS; ///< Количество интервалов гистограммы
+
+    /**
+     * @brief Снимок гистограммы задержек
+     */
+    struct Histogram {
+        std::vector<uint64_t> buckets; ///< Количество значений в каждом интервале
+        uint64_t count = 0; ///< Количество значений
+        uint64_t sum = 0; ///< Сумма значений, нс
+
+        /**
+         * @brief Оценка квантиля
+         * @param q Уровень квантиля (0..1)
+         * @return Наибольшее значение интервала, содержащего квантиль, нс (0 - значений нет)
+         */
+        uint64_t quantile(double q) const;
+    };
+
+    /**
+     * @brief Конструктор
+     */
+    Metrics();
+
+    /**
+     * @brief Деструктор
+     */
+    ~Metrics();
+
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    /**
+     * @brief Получение текущего времени для измерения задержек
+     * @return Наносекунды монотонных часов
+     */
+    static uint64_t now();
+
+    /**
+     * @brief Увеличение счетчика
+     * @param counter Счетчик
+     * @param value Приращение
+     */
+    void add(Counter counter, uint64_t value = 1);
+
+    /**
+     * @brief Запись задержки
+     * @param latency Гистограмма
+     * @param nanoseconds Задержка в наносекундах
+     */
+    void record(Latency latency, uint64_t nanoseconds);
+
+    /**
+     * @brief Получение суммарного значения счетчика
+     * @param counter Счетчик
+     * @return Сумма по всем потокам
+     */
+    uint64_t value(Counter counter) const;
+
+    /**
+     * @brief Получение снимка гистограммы
+     * @param latency Гистограмма
+     * @return Сумма интервалов по всем потокам
+     */
+    Histogram histogram(Latency latency) const;
+
+    /**
+     * @brief Регистрация значения, вычисляемого при экспорте
+     * @param name Имя метрики в формате Prometheus
+     * @param help Описание метрики
+     * @param counter true - монотонный счетчик, false - текущее значение (gauge)
+     * @param fn Функция получения значения (вызывается из потока экспорта)
+     * @details Используется для величин, которые уже ведут другие модули:
+     *          размер базы пользователей, отказы AuthThrottle
+     */
+    void addCallback(const std::string& name, const std::string& help, bool counter,
+                     std::function<double()> fn);
+
+    /**
+     * @brief Формирование текста метрик в формате Prometheus
+     * @return Текст для ответа на запрос /metrics
+     */
+    std::string exposition() const;
+
+    /**
+     * @brief Получение номера интервала гистограммы
+     * @param nanoseconds Значение
+     * @return Номер интервала (значения вне диапазона попадают в последний)
+     */
+    static size_t bucketIndex(uint64_t nanoseconds);
+
+    /**
+     * @brief Получение нижней границы интервала гистограммы
+     * @param index Номер интервала (BUCKETS - граница диапазона)
+     * @return Наименьшее значение интервала, нс
+     */
+    static uint64_t bucketLowerBound(size_t index);
+
+private:
+    struct Shard; ///< Счетчики одного потока
+
+    /**
+     * @brief Значение, вычисляемое при экспорте
+     */
+    struct Callback {
+        std::string name; ///< Имя метрики
+        std::string help; ///< Описание
+        bool counter; ///< Тип: counter или gauge
+        std::function<double()> fn; ///< Функция получения значения
+    };
+
+    /**
+     * @brief Получение блока счетчиков текущего потока
+     * @return Блок, созданный при первой записи потока
+     */
+    Shard& local();
+
+    const uint64_t id; ///< Номер объекта для поиска блока потока
+    mutable std::mutex mutex; ///< Защита списков блоков и функций
+    std::vector<std::unique_ptr<Shard>> shards; ///< Блоки потоков
+    std::vector<Callback> callbacks; ///< Значения, вычисляемые при экспорте
+};
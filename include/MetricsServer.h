@@ -0,0 +1,80 @@
+/**
+ * @file MetricsServer.h
+ * @brief Заголовочный файл модуля MetricsServer - HTTP-экспорт метрик
+ */
+
+#pragma once
+#include <atomic>
+#include <thread>
+
+class Metrics; ///< Предварительное объявление класса Metrics
+class Logger; ///< Предварительное объявление класса Logger
+
+/**
+ * @brief Отдача метрик по HTTP в формате Prometheus
+ * @details Отдельный поток принимает подключения на своем порту и отвечает на
+ *          GET /metrics текстом Metrics::exposition(); остальные пути получают 404.
+ *          Запросы обслуживаются по одному: сборщик метрик обращается редко, а
+ *          ожидание запроса ограничено REQUEST_TIMEOUT_MS, поэтому молчащий клиент
+ *          не останавливает экспорт. Рабочие потоки сервера в экспорте не участвуют
+ */
+class MetricsServer {
+public:
+    static const int REQUEST_TIMEOUT_MS = 1000; ///< Предельное время приема запроса
+
+    /**
+     * @brief Конструктор
+     * @param metrics Экспортируемые метрики
+     * @param logger Ссылка на журнал
+     */
+    MetricsServer(const Metrics& metrics, Logger& logger);
+
+    /**
+     * @brief Деструктор
+     * @details Останавливает поток экспорта
+     */
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    /**
+     * @brief Запуск потока экспорта
+     * @param port Порт HTTP
+     * @return true - порт открыт и поток запущен,
+     *         false - не удалось открыть порт (причина записана в журнал)
+     */
+    bool start(unsigned short port);
+
+    /**
+     * @brief Остановка потока экспорта
+     */
+    void stop();
+
+    /**
+     * @brief Получение количества обслуженных запросов
+     * @return Количество ответов на /metrics
+     */
+    unsigned scrapes() const {
+        return scrapeCount.load();
+    }
+
+private:
+    /**
+     * @brief Тело потока экспорта
+     */
+    void run();
+
+    /**
+     * @brief Обслуживание одного подключения
+     * @param sock Сокет клиента
+     */
+    void serve(int sock);
+
+    const Metrics& metrics; ///< Экспортируемые метрики
+    Logger& logger; ///< Журнал
+    int listenFd; ///< Слушающий сокет (-1 - не открыт)
+    int eventFd; ///< Дескриптор запроса остановки
+    std::thread thread; ///< Поток экспорта
+    std::atomic<unsigned> scrapeCount; ///< Количество ответов на /metrics
+};
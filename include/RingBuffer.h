@@ -0,0 +1,144 @@
+/**
+ * @file RingBuffer.h
+ * @brief Заголовочный файл модуля RingBuffer - кольцевой буфер входящих данных
+ */
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <algorithm>
+#include <sys/types.h>
+
+/**
+ * @brief Кольцевой буфер байт фиксированной емкости
+ * @details Память выделяется один раз при создании, дальнейшая работа не требует
+ *          выделений. Емкость округляется вверх до степени двойки, поэтому позиции
+ *          чтения и записи хранятся как монотонные счетчики, а индекс в памяти
+ *          получается маской. Свободное место и данные в общем случае состоят из
+ *          двух непрерывных участков (до конца памяти и с ее начала)
+ * @note Объект предназначен для использования из одного потока
+ */
+class RingBuffer {
+public:
+    /**
+     * @brief Конструктор буфера
+     * @param capacity Минимальная емкость в байтах
+     */
+    explicit RingBuffer(size_t capacity);
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /**
+     * @brief Получение емкости буфера
+     * @return Емкость в байтах
+     */
+    size_t capacity() const {
+        return mask + 1;
+    }
+
+    /**
+     * @brief Получение объема накопленных данных
+     * @return Количество непрочитанных байт
+     */
+    size_t size() const {
+        return tail - head;
+    }
+
+    /**
+     * @brief Получение объема свободного места
+     * @return Количество байт, которые можно записать
+     */
+    size_t space() const {
+        return capacity() - size();
+    }
+
+    /**
+     * @brief Копирование данных в буфер
+     * @param data Данные
+     * @param len Длина данных
+     * @return Количество скопированных байт (не больше space())
+     */
+    size_t write(const char* data, size_t len);
+
+    /**
+     * @brief Прием данных из сокета в свободное место буфера
+     * @param sock Сокет
+     * @param max_len Максимум принимаемых байт
+     * @param flags Флаги recvmsg (например, MSG_DONTWAIT)
+     * @return Результат recvmsg: количество байт, 0 при закрытии соединения или -1 при ошибке (errno)
+     * @details Оба участка свободного места заполняются одним системным вызовом
+     */
+    ssize_t receive(int sock, size_t max_len, int flags = 0);
+
+    /**
+     * @brief Копирование данных без их извлечения
+     * @param dst Буфер назначения
+     * @param len Количество байт
+     * @return Количество скопированных байт (не больше size())
+     */
+    size_t peek(void* dst, size_t len) const;
+
+    /**
+     * @brief Извлечение данных
+     * @param dst Буфер назначения
+     * @param len Количество байт
+     * @return Количество извлеченных байт (не больше size())
+     */
+    size_t read(void* dst, size_t len) {
+        size_t n = peek(dst, len);
+        head += n;
+        return n;
+    }
+
+    /**
+     * @brief Отбрасывание прочитанных данных
+     * @param len Количество байт (не больше size())
+     */
+    void consume(size_t len) {
+        head += len;
+    }
+
+    /**
+     * @brief Поиск байта среди первых байт буфера
+     * @param c Искомый байт
+     * @param limit Количество просматриваемых байт
+     * @return Смещение найденного байта от начала данных или npos
+     */
+    size_t find(char c, size_t limit) const;
+
+    /**
+     * @brief Передача данных обработчику непрерывными участками с извлечением
+     * @param len Максимум передаваемых байт
+     * @param sink Обработчик (const char* data, size_t len)
+     * @return Количество переданных байт
+     * @details Данные не копируются: обработчик получает указатели прямо в память буфера
+     */
+    template <typename Sink>
+    size_t drain(size_t len, Sink&& sink) {
+        size_t total = 0;
+        while (total < len && head != tail) {
+            size_t offset = head & mask;
+            size_t n = std::min(std::min(len - total, size()), capacity() - offset);
+            sink(memory.get() + offset, n);
+            head += n;
+            total += n;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Удаление всех данных
+     */
+    void clear() {
+        head = tail = 0;
+    }
+
+    static constexpr size_t npos = static_cast<size_t>(-1); ///< Признак отсутствия искомого байта
+
+private:
+    std::unique_ptr<char[]> memory; ///< Память буфера
+    size_t mask; ///< Маска индекса (емкость - 1)
+    size_t head; ///< Счетчик прочитанных байт
+    size_t tail; ///< Счетчик записанных байт
+};
@@ -8,16 +8,26 @@
 #include "Authenticator.h"
 #include "DataProcessor.h"
 #include "Logger.h"
+#include "Connection.h"
+#include "SessionStatus.h"
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <stdexcept>
 #include <string>
 #include <sys/socket.h>
 #include <netinet/in.h>
 
+class IoUring; ///< Предварительное объявление класса IoUring
+class Metrics; ///< Предварительное объявление класса Metrics
+class VectorPipeline; ///< Предварительное объявление класса VectorPipeline
+
+#define BUFLEN 1024 ///< Максимальный размер буфера для текстового сообщения аутентификации
+
 /**
  * @brief Базовый класс исключений сервера
- * @details Наследуется от std::runtime_error
+ * @details Наследуется от std::runtime_error. Исключения используются только для
+ *          фатальных сбоев; штатные ошибки сессии возвращаются как SessionStatus
  */
 class server_error : public std::runtime_error {
 public:
@@ -30,29 +40,24 @@ public:
 };
 
 /**
- * @brief Исключение для ошибок аутентификации
+ * @brief Режим обработки клиентских соединений
  */
-class auth_error : public server_error {
-public:
-    /**
-     * @brief Конструктор исключения аутентификации
-     * @param message Сообщение об ошибке аутентификации
-     */
-    explicit auth_error(const std::string& message) 
-        : server_error("Auth error: " + message) {}
+enum class IoMode {
+    Epoll, ///< Неблокирующий цикл событий на epoll (edge-triggered)
+    Uring, ///< Асинхронный ввод-вывод через io_uring (при недоступности - epoll)
+    Blocking ///< Последовательная обработка клиентов блокирующими вызовами
 };
 
 /**
- * @brief Исключение для ошибок обработки векторов
+ * @brief Параметры работы сервера
  */
-class vector_error : public server_error {
-public:
-    /**
-     * @brief Конструктор исключения ошибок обработки векторов
-     * @param message Сообщение об ошибке обработки векторов
-     */
-    explicit vector_error(const std::string& message) 
-        : server_error("Vector error: " + message) {}
+struct ServerConfig {
+    IoMode ioMode = IoMode::Epoll; ///< Режим обработки соединений
+    unsigned workers = 1; ///< Количество рабочих потоков, каждый со своим слушающим сокетом
+    bool streaming = false; ///< Потоковое суммирование векторов без буферизации всего вектора
+    bool hugePages = false; ///< Большие страницы для крупных буферов векторов
+    bool pipeline = false; ///< Прием следующего вектора во время вычисления предыдущего (блокирующий режим)
+    Metrics* metrics = nullptr; ///< Метрики соединений и векторов (nullptr - не учитываются)
 };
 
 /**
@@ -71,10 +76,12 @@ public:
      * @param userDb Ссылка на базу данных пользователей
      * @param authenticator Ссылка на аутентификатор
      * @param processor Ссылка на обработчик данных
+     * @param config Параметры работы сервера
      * @throw std::runtime_error при невалидном порте
      */
     Server(unsigned short port, Logger& logger, UserDatabase& userDb, 
-           Authenticator& authenticator, DataProcessor& processor);
+           Authenticator& authenticator, DataProcessor& processor,
+           const ServerConfig& config = ServerConfig());
 
     /**
      * @brief Деструктор сервера
@@ -84,7 +91,8 @@ public:
 
     /**
      * @brief Основной метод запуска сервера
-     * @details Запускает бесконечный цикл обработки подключений
+     * @details Запускает config.workers рабочих потоков, каждый из которых обслуживает
+     *          собственный слушающий сокет в режиме config.ioMode
      * @note Метод не возвращает управление
      * @throw std::system_error при ошибках сетевого взаимодействия
      */
@@ -96,10 +104,10 @@ private:
     UserDatabase& userDb; ///< Ссылка на базу данных пользователей
     Authenticator& authenticator; ///< Ссылка на аутентификатор
     DataProcessor& processor; ///< Ссылка на обработчик данных
+    ServerConfig config; ///< Параметры работы сервера
     
-    int listen_sock; ///< Сокет
+    std::vector<int> listen_socks; ///< Слушающие сокеты рабочих потоков
     std::unique_ptr<sockaddr_in> self_addr; ///< Адрес сервера
-    std::unique_ptr<sockaddr_in> foreign_addr; ///< Адрес клиента
 
     /**
      * @brief Проверка валидности номера порта
@@ -110,32 +118,93 @@ private:
 
     /**
      * @brief Инициализация и запуск сокета
+     * @return Дескриптор слушающего сокета
      * @throw std::system_error при ошибках создания сокета
      */
-    void startListening();
+    int startListening();
+
+    /**
+     * @brief Тело рабочего потока
+     * @param id Номер рабочего потока
+     * @param listen_sock Слушающий сокет потока
+     */
+    void runWorker(unsigned id, int listen_sock);
+
+    /**
+     * @brief Цикл обработки событий epoll
+     * @param listen_sock Слушающий сокет потока
+     * @param pool Пул буферов потока
+     * @details Обслуживает все соединения одновременно в одном потоке
+     * @throw std::system_error при ошибках epoll
+     */
+    void runEventLoop(int listen_sock, BufferPool& pool);
+
+    /**
+     * @brief Цикл обработки завершений io_uring
+     * @param listen_sock Слушающий сокет потока
+     * @param ring Кольцо io_uring потока
+     * @param pool Пул буферов потока
+     * @throw std::system_error при ошибках io_uring
+     */
+    void runUringLoop(int listen_sock, IoUring& ring, BufferPool& pool);
+
+    /**
+     * @brief Последовательная обработка клиентов блокирующими вызовами
+     * @param listen_sock Слушающий сокет потока
+     * @param pool Пул буферов потока
+     */
+    void runBlocking(int listen_sock, BufferPool& pool);
+
+    /**
+     * @brief Прием всех ожидающих подключений
+     * @param listen_sock Слушающий сокет потока
+     * @param epoll_fd Дескриптор epoll потока
+     * @param connections Таблица активных соединений потока
+     * @param pool Пул буферов потока
+     */
+    void acceptClients(int listen_sock, int epoll_fd,
+                       std::unordered_map<int, std::unique_ptr<Connection>>& connections, BufferPool& pool);
 
     /**
      * @brief Обработка одного клиента
      * @param client_sock Сокет подключенного клиента
-     * @throw auth_error при ошибках аутентификации
-     * @throw vector_error при ошибках обработки векторов
+     * @param peer Адрес клиента
+     * @param pool Пул буферов потока
+     * @param pipeline Поток вычисления векторов (nullptr - последовательная обработка)
+     * @throw std::bad_alloc при нехватке памяти под вектор
      */
-    void handleClient(int client_sock);
+    void handleClient(int client_sock, const std::string& peer, BufferPool& pool, VectorPipeline* pipeline);
 
     /**
      * @brief Обработка векторов данных от клиента
      * @param client_sock Сокет клиента
-     * @throw vector_error при ошибках обработки векторов
+     * @param reader Входной буфер соединения
+     * @param pool Пул буферов потока
+     * @param pipeline Поток вычисления векторов (nullptr - последовательная обработка)
+     * @return Успех или код ошибки приема векторов
+     */
+    SessionStatus processVectors(int client_sock, FrameReader& reader, BufferPool& pool, VectorPipeline* pipeline);
+
+    /**
+     * @brief Конвейерная обработка векторов
+     * @param sock Сокет клиента
+     * @param reader Входной буфер соединения
+     * @param pool Пул буферов потока
+     * @param pipeline Поток вычисления векторов
+     * @param num_vectors Количество векторов
+     * @return Успех или код ошибки приема векторов
      */
-    void processVectors(int client_sock);
+    SessionStatus pipelineVectors(int sock, FrameReader& reader, BufferPool& pool, VectorPipeline& pipeline,
+                                  uint32_t num_vectors);
 
     /**
      * @brief Чтение текстового сообщения от клиента
      * @param sock Сокет клиента
-     * @return Прочитанная строка
-     * @throw std::system_error при ошибках чтения
+     * @param reader Входной буфер соединения
+     * @param message Прочитанная строка
+     * @return Успех, Disconnected или ReceiveFailed
      */
-    std::string readTextMessage(int sock) const;
+    SessionStatus readTextMessage(int sock, FrameReader& reader, std::string& message) const;
 
     /**
      * @brief Отправка сообщения об ошибке клиенту
@@ -143,4 +212,12 @@ private:
      * @param message Текст сообщения для записи в журнал
      */
     void sendError(int client_sock, const std::string& message) const;
-};
\ No newline at end of file
+
+    /**
+     * @brief Проверка адреса нового клиента ограничителем неудачных попыток
+     * @param client_sock Сокет подключенного клиента
+     * @param peer Адрес клиента
+     * @return true - клиент принят (учитывается в метриках), false - адрес отклонен, сокет закрыт
+     */
+    bool admit(int client_sock, const std::string& peer) const;
+};
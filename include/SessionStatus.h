@@ -0,0 +1,99 @@
+/**
+ * @file SessionStatus.h
+ * @brief Заголовочный файл модуля SessionStatus - результат шага протокола
+ */
+
+#pragma once
+#include <string>
+#include <utility>
+
+/**
+ * @brief Результат шага протокола клиентской сессии
+ * @details Штатные исходы сессии - неверный пароль, недопустимая длина вектора,
+ *          отключение клиента - возвращаются значением, а не исключением: под потоком
+ *          неудачных сессий раскрутка стека и захват блокировки раскрутчика стоят
+ *          дороже самой проверки. Исключения остаются для фатальных сбоев
+ *          (нехватка памяти, ошибки запуска сервера). Текст для журнала собирается
+ *          методом message() только при записи
+ */
+class [[nodiscard]] SessionStatus {
+public:
+    /**
+     * @brief Коды результата
+     */
+    enum class Code {
+        Ok, ///< Шаг выполнен
+        Disconnected, ///< Клиент отключился
+        ReceiveFailed, ///< Ошибка приема (detail - описание ошибки)
+        AuthTooShort, ///< Строка аутентификации короче SALT + HASH
+        AuthFailed, ///< Неверный логин или пароль (detail - логин)
+        AuthThrottled, ///< Логин превысил порог неудачных попыток с адреса клиента (detail - логин)
+        TicketRejected, ///< Билет возобновления сессии недействителен (detail - логин)
+        CountTruncated, ///< Соединение закрыто до получения количества векторов
+        LengthTruncated, ///< Соединение закрыто до получения длины вектора
+        InvalidLength, ///< Нулевая или слишком большая длина вектора
+        DataTruncated ///< Соединение закрыто до получения данных вектора
+    };
+
+    /**
+     * @brief Конструктор успешного результата
+     */
+    SessionStatus() : statusCode(Code::Ok) {}
+
+    /**
+     * @brief Конструктор результата
+     * @param code Код результата
+     * @param detail Подробность для журнала (логин, описание ошибки)
+     */
+    explicit SessionStatus(Code code, std::string detail = std::string())
+        : statusCode(code), statusDetail(std::move(detail)) {}
+
+    /**
+     * @brief Проверка успешности
+     * @return true - шаг выполнен
+     */
+    bool isOk() const {
+        return statusCode == Code::Ok;
+    }
+
+    /**
+     * @brief Проверка успешности
+     * @return true - шаг выполнен
+     */
+    explicit operator bool() const {
+        return isOk();
+    }
+
+    /**
+     * @brief Получение кода результата
+     * @return Код
+     */
+    Code code() const {
+        return statusCode;
+    }
+
+    /**
+     * @brief Получение подробности результата
+     * @return Логин или описание ошибки (может быть пустым)
+     */
+    const std::string& detail() const {
+        return statusDetail;
+    }
+
+    /**
+     * @brief Проверка принадлежности к ошибкам аутентификации
+     * @return true - код AuthTooShort, AuthFailed, AuthThrottled или TicketRejected
+     */
+    bool isAuthError() const;
+
+    /**
+     * @brief Формирование текста для журнала
+     * @return Описание результата с подробностью, например
+     *         "Auth error: Authentication failed for login user"
+     */
+    std::string message() const;
+
+private:
+    Code statusCode; ///< Код результата
+    std::string statusDetail; ///< Подробность для журнала
+};
@@ -0,0 +1,129 @@
+/**
+ * @file ThreadPool.h
+ * @brief Заголовочный файл модуля ThreadPool - пул потоков с перехватом задач
+ */
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Пул потоков вычислений с перехватом задач (work stealing)
+ * @details У каждого потока пула своя очередь задач. Поток выполняет задачи из своей
+ *          очереди с конца, а опустев - перехватывает задачи из начала чужих очередей,
+ *          поэтому неравномерно распределенная работа выравнивается без общей очереди.
+ *          Поток, вызвавший parallelFor(), не простаивает: до завершения своих задач
+ *          он сам выполняет задачи пула. Задача не требует выделения памяти:
+ *          она хранит указатель на функцию, контекст и номер части работы
+ * @note Методы потокобезопасны; parallelFor() может вызываться из нескольких потоков
+ *       одновременно
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Конструктор пула
+     * @param threads Количество потоков пула (0 - все части выполняет вызывающий поток)
+     */
+    explicit ThreadPool(unsigned threads);
+
+    /**
+     * @brief Деструктор
+     * @details Останавливает и дожидается потоков пула
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Получение количества потоков пула
+     * @return Количество потоков (без учета вызывающих)
+     */
+    unsigned size() const {
+        return static_cast<unsigned>(workers.size());
+    }
+
+    /**
+     * @brief Параллельное выполнение частей работы
+     * @param count Количество частей
+     * @param body Функция body(size_t index), вызываемая для каждой части ровно один раз
+     * @details Возвращает управление после выполнения всех частей. Функция body
+     *          не должна выбрасывать исключения
+     */
+    template <typename Body>
+    void parallelFor(size_t count, Body&& body) {
+        std::atomic<size_t> pending(count);
+        Batch batch{&invoke<typename std::remove_reference<Body>::type>,
+                    const_cast<void*>(static_cast<const void*>(&body)), &pending};
+        run(batch, count);
+    }
+
+private:
+    /**
+     * @brief Группа частей одного вызова parallelFor()
+     */
+    struct Batch {
+        void (*fn)(void*, size_t); ///< Функция выполнения части
+        void* ctx; ///< Контекст функции
+        std::atomic<size_t>* pending; ///< Количество невыполненных частей
+    };
+
+    /**
+     * @brief Задача - одна часть работы
+     */
+    struct Task {
+        const Batch* batch; ///< Группа задачи
+        size_t index; ///< Номер части
+    };
+
+    /**
+     * @brief Очередь задач потока
+     */
+    struct Queue {
+        std::mutex mutex; ///< Защита очереди
+        std::deque<Task> tasks; ///< Задачи
+    };
+
+    /**
+     * @brief Вызов функции части работы через стертый тип
+     */
+    template <typename Body>
+    static void invoke(void* ctx, size_t index) {
+        (*static_cast<Body*>(ctx))(index);
+    }
+
+    /**
+     * @brief Распределение частей по очередям и ожидание их выполнения
+     * @param batch Группа частей
+     * @param count Количество частей
+     */
+    void run(const Batch& batch, size_t count);
+
+    /**
+     * @brief Тело потока пула
+     * @param self Номер потока
+     */
+    void workerLoop(unsigned self);
+
+    /**
+     * @brief Выполнение одной задачи: своей или перехваченной
+     * @param self Номер очереди, с которой начинается поиск
+     * @return true - задача выполнена, false - все очереди пусты
+     */
+    bool runOne(unsigned self);
+
+    std::vector<std::unique_ptr<Queue>> queues; ///< Очереди задач потоков
+    std::vector<std::thread> workers; ///< Потоки пула
+    std::atomic<size_t> queued; ///< Количество задач во всех очередях
+    std::atomic<unsigned> nextQueue; ///< Очередь для следующего распределения
+    std::mutex sleepMutex; ///< Защита ожидания потоков
+    std::condition_variable wakeUp; ///< Оповещение о новых задачах
+    bool stopping; ///< Признак остановки пула
+};
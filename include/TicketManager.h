@@ -0,0 +1,98 @@
+/**
+ * @file TicketManager.h
+ * @brief Заголовочный файл модуля TicketManager - билеты возобновления сессии
+ */
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+/**
+ * @brief Выдача и проверка билетов возобновления сессии
+ * @details После успешной аутентификации клиент получает билет и при повторном
+ *          подключении может предъявить его вместо SALT+HASH, минуя поиск в базе
+ *          и вычисление хеша пароля.
+ *
+ *          Билет - строка из TICKET_LENGTH hex-символов:
+ *          срок действия (8 байт) || номер ключа (4 байта) || HMAC-SHA256 (32 байта).
+ *          HMAC вычисляется от логина, срока действия и номера ключа. Ключ номер N
+ *          выводится из секрета сервера как HMAC-SHA256(секрет, "vcalc-ticket-key" || N),
+ *          где N = время / KEY_ROTATION, поэтому ключи сменяются каждые KEY_ROTATION
+ *          секунд без общего состояния: любой процесс с тем же секретом проверяет
+ *          билеты других процессов. Принимаются ключи текущего и предыдущего периода
+ * @note Объект не изменяется после создания, методы можно вызывать из нескольких потоков.
+ *       Билет остается действительным до истечения срока даже после удаления
+ *       пользователя из базы, поэтому Authenticator выдает новый билет только
+ *       после проверки пароля
+ */
+class TicketManager {
+public:
+    static constexpr size_t TICKET_LENGTH = 2 * (8 + 4 + 32); ///< Длина билета в hex-символах
+    static constexpr time_t KEY_ROTATION = 3600; ///< Период смены ключа в секундах (наибольший срок билета)
+    static constexpr size_t MIN_SECRET_LENGTH = 16; ///< Минимальная длина секрета в байтах
+
+    /**
+     * @brief Конструктор
+     * @param secret Секрет сервера (не короче MIN_SECRET_LENGTH байт)
+     * @param lifetime Срок действия билета в секундах (не больше KEY_ROTATION: принимаются
+     *                 ключи только текущего и предыдущего периода)
+     */
+    TicketManager(const std::string& secret, unsigned lifetime);
+
+    /**
+     * @brief Выдача билета
+     * @param login Логин аутентифицированного пользователя
+     * @param now Текущее время
+     * @return Билет длиной TICKET_LENGTH
+     */
+    std::string issue(std::string_view login, time_t now) const;
+
+    /**
+     * @brief Проверка билета
+     * @param login Логин, предъявленный вместе с билетом
+     * @param ticket Билет
+     * @param now Текущее время
+     * @return true - билет выдан этому логину, не истек и подписан действующим ключом
+     */
+    bool validate(std::string_view login, std::string_view ticket, time_t now) const;
+
+    /**
+     * @brief Получение срока действия билетов
+     * @return Срок действия в секундах
+     */
+    unsigned lifetime() const {
+        return ticketLifetime;
+    }
+
+    /**
+     * @brief Чтение секрета из файла
+     * @param path Путь к файлу секрета
+     * @param out_secret Содержимое файла
+     * @return true - файл прочитан и содержит не менее MIN_SECRET_LENGTH байт
+     * @details Общий файл секрета позволяет процессам сервера принимать билеты друг друга
+     */
+    static bool readSecret(const std::string& path, std::string& out_secret);
+
+    /**
+     * @brief Генерация случайного секрета
+     * @return Секрет длиной 32 байта
+     * @details Билеты, подписанные таким секретом, принимает только текущий процесс
+     */
+    static std::string generateSecret();
+
+private:
+    /**
+     * @brief Вычисление подписи билета
+     * @param login Логин
+     * @param expiry Срок действия
+     * @param key_id Номер ключа
+     * @param out Буфер подписи (32 байта)
+     */
+    void sign(std::string_view login, uint64_t expiry, uint32_t key_id, unsigned char* out) const;
+
+    std::string secret; ///< Секрет сервера
+    unsigned ticketLifetime; ///< Срок действия билета в секундах
+};
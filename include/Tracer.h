@@ -0,0 +1,226 @@
+/**
+ * @file Tracer.h
+ * @brief Заголовочный файл модуля Tracer - трассировка этапов клиентских сессий
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Трассировка этапов сессий с выводом в формате Chrome trace_event
+ * @details Этапы сессии (прием подключения, прием строки аутентификации, проверка
+ *          хеша, прием вектора, вычисление среднего, отправка ответа) записываются
+ *          интервалами (span) в кольцевой буфер потока: поток пишет только в свой
+ *          буфер, поэтому запись не требует блокировок. При переполнении старые
+ *          интервалы перезаписываются. Трассируется каждая sample_every-я сессия:
+ *          номер сессии хранится в thread_local, и для нетрассируемой сессии
+ *          интервал стоит одного чтения thread_local и сравнения с нулем.
+ *          Без установленного трассировщика (install()) номер сессии всегда 0.
+ *          write() сохраняет буферы в JSON, который открывается в chrome://tracing
+ *          и Perfetto: поток сервера - отдельная дорожка, номер сессии - в args
+ * @note Время берется из steady_clock (vDSO, без системного вызова) - те же
+ *       наносекунды, что и Metrics::now()
+ */
+class Tracer {
+public:
+    /**
+     * @brief Этапы сессии
+     */
+    enum class Stage {
+        Accept, ///< Прием подключения и создание соединения
+        ReadAuth, ///< Прием строки аутентификации
+        Verify, ///< Проверка хеша (Authenticator::verify)
+        Receive, ///< Прием данных вектора
+        Average, ///< Вычисление среднего (DataProcessor::calculateAverage)
+        Finalize, ///< Деление суммы и проверка границ (DataProcessor::finalize)
+        Send, ///< Отправка ответа
+        Count ///< Количество этапов
+    };
+
+    static const size_t DEFAULT_CAPACITY = 65536; ///< Интервалов в буфере одного потока
+
+    /**
+     * @brief Установка интервала на время жизни объекта
+     * @details Интервал записывается деструктором, если при создании поток
+     *          обслуживал трассируемую сессию
+     */
+    class Span {
+    public:
+        /**
+         * @brief Начало интервала
+         * @param stage Этап
+         */
+        explicit Span(Stage stage) : stage(stage), session(current), start(session ? now() : 0) {}
+
+        /**
+         * @brief Конец интервала
+         */
+        ~Span() {
+            if (session) {
+                finish();
+            }
+        }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        /**
+         * @brief Запись интервала в буфер потока
+         */
+        void finish();
+
+        Stage stage; ///< Этап
+        uint64_t session; ///< Номер сессии (0 - не трассируется)
+        uint64_t start; ///< Начало, нс
+    };
+
+    /**
+     * @brief Назначение текущей сессии потока на время жизни объекта
+     * @details Вызывается при входе в обработку соединения; по выходе восстанавливает
+     *          прежнее значение, поэтому вложенные области допустимы
+     */
+    class Scope {
+    public:
+        /**
+         * @brief Конструктор
+         * @param session Номер сессии (0 - не трассировать)
+         */
+        explicit Scope(uint64_t session) : previous(current) {
+            current = session;
+        }
+
+        /**
+         * @brief Деструктор
+         */
+        ~Scope() {
+            current = previous;
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        uint64_t previous; ///< Сессия до входа в область
+    };
+
+    /**
+     * @brief Конструктор
+     * @param sample_every Трассировать каждую N-ю сессию (0 считается как 1)
+     * @param capacity Интервалов в буфере одного потока (округляется вверх до степени двойки)
+     */
+    explicit Tracer(unsigned sample_every = 1, size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief Деструктор
+     * @details Снимает трассировщик, если он установлен
+     */
+    ~Tracer();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    /**
+     * @brief Установка трассировщика процесса
+     * @param tracer Трассировщик (nullptr - трассировка выключена)
+     * @note Вызывается до запуска рабочих потоков
+     */
+    static void install(Tracer* tracer);
+
+    /**
+     * @brief Получение установленного трассировщика
+     * @return Трассировщик или nullptr
+     */
+    static Tracer* active() {
+        return instance.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Получение текущего времени
+     * @return Наносекунды монотонных часов
+     */
+    static uint64_t now();
+
+    /**
+     * @brief Выбор номера для новой сессии
+     * @return Номер трассируемой сессии или 0, если трассировщик не установлен
+     *         либо сессия не попала в выборку
+     */
+    static uint64_t startSession();
+
+    /**
+     * @brief Получение сессии, обслуживаемой текущим потоком
+     * @return Номер сессии из ближайшего Scope (0 - не трассируется)
+     */
+    static uint64_t session() {
+        return current;
+    }
+
+    /**
+     * @brief Запись интервала с явными границами
+     * @param stage Этап
+     * @param session Номер сессии (0 - интервал не записывается)
+     * @param start Начало, нс (now())
+     * @param end Конец, нс (now())
+     * @details Для этапов, которые начинаются и заканчиваются в разных вызовах
+     *          (прием строки аутентификации, асинхронная отправка)
+     */
+    static void record(Stage stage, uint64_t session, uint64_t start, uint64_t end);
+
+    /**
+     * @brief Получение названия этапа
+     * @param stage Этап
+     * @return Название для trace_event ("verify", "receive" ...)
+     */
+    static const char* stageName(Stage stage);
+
+    /**
+     * @brief Сохранение интервалов в формате Chrome trace_event
+     * @param path Путь к файлу JSON
+     * @return true - файл записан, false - ошибка записи
+     * @details Можно вызывать во время работы: интервалы, которые поток перезаписывает
+     *          в момент чтения, пропускаются (из заполненного буфера - самый старый)
+     */
+    bool write(const std::string& path) const;
+
+    /**
+     * @brief Получение количества сохраненных интервалов
+     * @return Интервалы во всех буферах (не больше емкости буфера на поток)
+     */
+    size_t size() const;
+
+private:
+    struct Ring; ///< Кольцевой буфер интервалов одного потока
+
+    /**
+     * @brief Получение буфера текущего потока
+     * @return Буфер, созданный при первой записи потока
+     */
+    Ring& local();
+
+    /**
+     * @brief Запись интервала в буфер текущего потока
+     * @param stage Этап
+     * @param session Номер сессии
+     * @param start Начало, нс
+     * @param end Конец, нс
+     */
+    void append(Stage stage, uint64_t session, uint64_t start, uint64_t end);
+
+    static inline std::atomic<Tracer*> instance{nullptr}; ///< Установленный трассировщик
+    static inline thread_local uint64_t current = 0; ///< Сессия, обслуживаемая потоком (0 - не трассируется)
+
+    const uint64_t id; ///< Номер объекта для поиска буфера потока
+    const unsigned sampleEvery; ///< Период выборки сессий
+    const size_t capacity; ///< Емкость буфера потока (степень двойки)
+    const uint64_t origin; ///< Время создания - начало шкалы ts
+    std::atomic<uint64_t> sessions; ///< Счетчик начатых сессий
+    mutable std::mutex mutex; ///< Защита списка буферов
+    std::vector<std::unique_ptr<Ring>> rings; ///< Буферы потоков
+};
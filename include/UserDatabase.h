@@ -5,34 +5,254 @@
 
 #pragma once
 #include <string>
-#include <map>
+#include <string_view>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
 
 class Logger; ///< Предварительное объявление класса Logger
 
 /**
  * @brief Класс для работы с базой данных пользователей
- * @details Загружает пары "логин:пароль" из текстового файла и предоставляет доступ к ним для аутентификации
+ * @details Загружает пары "логин:пароль" из текстового файла или из скомпилированного
+ *          двоичного файла и предоставляет доступ к ним для аутентификации.
+ *          Логины и пароли хранятся подряд в одном непрерывном буфере, а индекс - плоская хеш-таблица
+ *          с открытой адресацией и линейным пробированием. Ячейка индекса хранит часть хеша,
+ *          поэтому при поиске строки сравниваются только у ячеек с совпавшим хешем.
+ *          Поиск принимает std::string_view, возвращает представление пароля в буфере
+ *          и не выделяет память.
+ *
+ *          Двоичный формат (см. save()) содержит заголовок, индекс и буфер строк в том же
+ *          виде, что и в памяти. Такой файл отображается в память через mmap и используется
+ *          на месте: загрузка не зависит от числа пользователей, а страницы файла разделяются
+ *          всеми процессами, открывшими ту же базу.
+ *
+ *          Загруженная база - неизменяемый снимок. Повторная загрузка (reload()) строит
+ *          новый снимок, не мешая читателям, и публикует его атомарной заменой указателя
+ *          (по схеме RCU). Читатель закрепляет снимок объектом Reader без блокировок:
+ *          он только увеличивает счетчик читателей текущей эпохи. Старый снимок
+ *          освобождается, когда завершатся все читатели, начавшие чтение до замены
+ * @note Методы чтения можно вызывать из нескольких потоков одновременно с load() и reload()
  */
 class UserDatabase {
 private:
-    std::map<std::string, std::string> users; ///< Контейнер для хранения пользователей
+    /**
+     * @brief Ячейка индекса
+     * @details Пустая ячейка имеет нулевую длину логина (пустые логины не загружаются)
+     */
+    struct Slot {
+        uint32_t hash; ///< Старшие биты хеша логина
+        uint32_t offset; ///< Смещение логина в буфере, пароль следует сразу за ним
+        uint32_t loginLength; ///< Длина логина
+        uint32_t passwordLength; ///< Длина пароля
+    };
+
+    /**
+     * @brief Заголовок двоичного файла базы
+     * @details Числа хранятся в порядке байтов машины (little-endian на x86-64)
+     */
+    struct FileHeader {
+        char magic[8]; ///< Сигнатура BINARY_MAGIC
+        uint32_t version; ///< Версия формата
+        uint32_t slotCount; ///< Количество ячеек индекса (степень двойки)
+        uint64_t userCount; ///< Количество пользователей
+        uint64_t slotsOffset; ///< Смещение индекса от начала файла
+        uint64_t arenaOffset; ///< Смещение буфера строк от начала файла
+        uint64_t arenaSize; ///< Размер буфера строк
+    };
+
+    /**
+     * @brief Неизменяемый снимок базы
+     */
+    struct Snapshot {
+        std::vector<char> arena; ///< Буфер логинов и паролей (текстовая база)
+        std::vector<Slot> table; ///< Хеш-таблица (текстовая база)
+        const char* arenaData = nullptr; ///< Буфер строк: собственный или отображенный
+        size_t arenaSize = 0; ///< Размер буфера строк
+        const Slot* slots = nullptr; ///< Индекс: собственный или отображенный
+        size_t slotCount = 0; ///< Количество ячеек индекса (степень двойки)
+        size_t userCount = 0; ///< Количество пользователей
+        void* mapping = nullptr; ///< Отображение двоичного файла
+        size_t mappingSize = 0; ///< Размер отображения
+
+        Snapshot() = default;
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        /**
+         * @brief Деструктор
+         * @details Снимает отображение двоичной базы
+         */
+        ~Snapshot();
+
+        /**
+         * @brief Поиск пароля по логину
+         * @param login Логин пользователя
+         * @param out_password Представление пароля в буфере снимка
+         * @return true - пользователь найден
+         */
+        bool find(std::string_view login, std::string_view& out_password) const;
+    };
+
+    /**
+     * @brief Счетчик читателей эпохи на отдельной строке кэша
+     */
+    struct alignas(64) ReaderCount {
+        std::atomic<size_t> count{0}; ///< Количество активных читателей
+    };
+
+    static const char BINARY_MAGIC[8]; ///< Сигнатура двоичного файла базы
+    static const uint32_t BINARY_VERSION = 1; ///< Версия двоичного формата
+
+    std::atomic<Snapshot*> current{nullptr}; ///< Опубликованный снимок
+    std::atomic<unsigned> epoch{0}; ///< Эпоха читателей (меняется при каждой замене снимка)
+    mutable ReaderCount readers[2]; ///< Читатели четных и нечетных эпох
+    std::mutex writeMutex; ///< Сериализация загрузок
+    std::string dbPath; ///< Путь к последней успешно загруженной базе
+
+    /**
+     * @brief Загрузка текстовой базы
+     * @param db_path Путь к файлу
+     * @param logger Ссылка на журнал
+     * @return Новый снимок или nullptr при ошибке
+     */
+    static std::unique_ptr<Snapshot> loadText(const std::string& db_path, Logger& logger);
+
+    /**
+     * @brief Отображение двоичной базы в память
+     * @param fd Дескриптор открытого файла
+     * @param db_path Путь к файлу (для сообщений)
+     * @param logger Ссылка на журнал
+     * @return Новый снимок или nullptr при ошибке
+     */
+    static std::unique_ptr<Snapshot> loadBinary(int fd, const std::string& db_path, Logger& logger);
+
+    /**
+     * @brief Публикация нового снимка
+     * @param snapshot Новый снимок
+     * @details Вызывается под writeMutex. Возвращает управление после освобождения
+     *          старого снимка
+     */
+    void publish(std::unique_ptr<Snapshot> snapshot);
 
 public:
+    /**
+     * @brief Закрепление текущего снимка базы для чтения
+     * @details Пока объект существует, снимок не освобождается, поэтому представления
+     *          паролей, полученные через него, остаются действительными. Закрепление
+     *          не использует блокировок и не выделяет память
+     */
+    class Reader {
+    public:
+        /**
+         * @brief Закрепление текущего снимка
+         * @param db База пользователей
+         */
+        explicit Reader(const UserDatabase& db);
+
+        /**
+         * @brief Снятие закрепления
+         */
+        ~Reader() {
+            counter->fetch_sub(1, std::memory_order_release);
+        }
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        /**
+         * @brief Получение пароля пользователя по логину без копирования
+         * @param login Логин пользователя
+         * @param out_password Представление пароля, действительное до уничтожения объекта
+         * @return true - пользователь найден,
+         *         false - пользователь не найден
+         */
+        bool getPassword(std::string_view login, std::string_view& out_password) const {
+            return snapshot != nullptr && snapshot->find(login, out_password);
+        }
+
+        /**
+         * @brief Получение количества пользователей снимка
+         * @return Количество пользователей
+         */
+        size_t size() const {
+            return snapshot ? snapshot->userCount : 0;
+        }
+
+    private:
+        friend class UserDatabase;
+        std::atomic<size_t>* counter; ///< Счетчик читателей закрепленной эпохи
+        const Snapshot* snapshot; ///< Закрепленный снимок
+    };
+
+    UserDatabase() = default;
+
+    /**
+     * @brief Деструктор
+     * @details Освобождает текущий снимок. Читателей к этому моменту быть не должно
+     */
+    ~UserDatabase();
+
+    UserDatabase(const UserDatabase&) = delete;
+    UserDatabase& operator=(const UserDatabase&) = delete;
+
     /**
      * @brief Загрузка базы пользователей из файла
-     * @param db_path Путь к файлу базы данных
+     * @param db_path Путь к файлу базы данных (текстовому или двоичному)
      * @param logger Ссылка на объект журнала для записи ошибок
      * @return true - база успешно загружена,
      *         false - произошла ошибка при загрузке
+     * @details Формат определяется по сигнатуре в начале файла. При ошибке
+     *          действующая база сохраняется
      */
     bool load(const std::string& db_path, Logger& logger);
 
     /**
-     * @brief Получение пароля пользователя по логину
+     * @brief Повторная загрузка базы из последнего загруженного файла
+     * @param logger Ссылка на объект журнала для записи ошибок
+     * @return true - новая база опубликована,
+     *         false - ошибка загрузки (действующая база сохраняется)
+     */
+    bool reload(Logger& logger);
+
+    /**
+     * @brief Получение пути к загруженной базе
+     * @return Путь к файлу последней успешной загрузки
+     */
+    std::string path();
+
+    /**
+     * @brief Сохранение базы в двоичном формате
+     * @param db_path Путь к создаваемому файлу
+     * @param logger Ссылка на объект журнала для записи ошибок
+     * @return true - файл записан,
+     *         false - ошибка записи
+     * @details Файл сначала записывается во временный файл рядом с целевым, затем
+     *          переименовывается, поэтому читатели никогда не видят неполный файл
+     */
+    bool save(const std::string& db_path, Logger& logger) const;
+
+    /**
+     * @brief Получение копии пароля пользователя по логину
      * @param login Логин пользователя
      * @param out_password Строка для записи пароля
      * @return true - пользователь найден,
      *         false - пользователь не найден
      */
-    bool getPassword(const std::string& login, std::string& out_password) const;
+    bool getPassword(std::string_view login, std::string& out_password) const;
+
+    /**
+     * @brief Получение количества пользователей
+     * @return Количество пользователей текущего снимка
+     */
+    size_t size() const;
+
+    /**
+     * @brief Проверка режима хранения
+     * @return true - текущий снимок отображен из двоичного файла
+     */
+    bool isMapped() const;
 };
@@ -0,0 +1,102 @@
+/**
+ * @file VectorPipeline.h
+ * @brief Заголовочный файл модуля VectorPipeline - вычисление векторов параллельно с приемом
+ */
+
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+class DataProcessor; ///< Предварительное объявление класса DataProcessor
+class Logger; ///< Предварительное объявление класса Logger
+
+/**
+ * @brief Поток вычисления среднего для конвейерной обработки векторов
+ * @details Принимает по одному вектору: пока поток вычисляет среднее вектора i,
+ *          поток соединения принимает вектор i + 1 во второй буфер. Вектор
+ *          передается указателем, поэтому память вектора не должна изменяться
+ *          и освобождаться до получения результата (wait() или drain())
+ * @note Методы вызываются одним потоком - владельцем соединения
+ */
+class VectorPipeline {
+public:
+    /**
+     * @brief Результат вычисления
+     */
+    struct Result {
+        int32_t value; ///< Среднее арифметическое
+        uint64_t nanoseconds; ///< Время вычисления, нс
+    };
+
+    /**
+     * @brief Конструктор
+     * @param processor Обработчик данных
+     * @param logger Журнал для записи ошибок вычисления
+     * @details Запускает поток вычисления
+     */
+    VectorPipeline(DataProcessor& processor, Logger& logger);
+
+    /**
+     * @brief Деструктор
+     * @details Дожидается текущего вычисления и останавливает поток
+     */
+    ~VectorPipeline();
+
+    VectorPipeline(const VectorPipeline&) = delete;
+    VectorPipeline& operator=(const VectorPipeline&) = delete;
+
+    /**
+     * @brief Передача вектора на вычисление
+     * @param data Элементы вектора
+     * @param count Количество элементов
+     * @param trace Номер трассируемой сессии (0 - не трассируется)
+     * @note Предыдущий результат должен быть получен: busy() == false
+     */
+    void submit(const int32_t* data, size_t count, uint64_t trace = 0);
+
+    /**
+     * @brief Проверка наличия переданного и не полученного вектора
+     * @return true - результат еще не получен
+     */
+    bool busy() const {
+        return pending;
+    }
+
+    /**
+     * @brief Ожидание результата переданного вектора
+     * @return Результат вычисления
+     * @throw Исключение, выброшенное при вычислении
+     */
+    Result wait();
+
+    /**
+     * @brief Ожидание завершения вычисления без получения результата
+     * @details Используется при прерывании сессии, чтобы освободить память вектора
+     */
+    void drain();
+
+private:
+    DataProcessor& processor; ///< Обработчик данных
+    Logger& logger; ///< Журнал
+    std::mutex mutex; ///< Защита состояния задачи
+    std::condition_variable submitted; ///< Оповещение потока вычисления о задаче
+    std::condition_variable finished; ///< Оповещение владельца о результате
+    const int32_t* data; ///< Элементы вектора задачи
+    size_t count; ///< Количество элементов
+    uint64_t trace; ///< Номер трассируемой сессии задачи
+    bool queued; ///< Задача ожидает или выполняется (защищено mutex)
+    bool stopping; ///< Запрос остановки потока (защищено mutex)
+    Result result; ///< Результат последней задачи
+    std::exception_ptr error; ///< Исключение последней задачи
+    bool pending; ///< Результат переданного вектора не получен (только поток-владелец)
+    std::thread worker; ///< Поток вычисления
+
+    /**
+     * @brief Тело потока вычисления
+     */
+    void run();
+};
@@ -0,0 +1,229 @@
+/**
+ * @file AuthThrottle.cpp
+ * @brief Реализация класса AuthThrottle - ограничения неудачных попыток аутентификации
+ */
+
+#include "AuthThrottle.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace {
+
+const uint64_t ADDRESS_SEED = 0xcbf29ce484222325ULL; ///< Начальное значение FNV-1a для адресов
+const uint64_t LOGIN_SEED = 0x84222325cbf29ce4ULL; ///< Начальное значение для пар адрес-логин
+const uint64_t FNV_PRIME = 0x100000001b3ULL; ///< Множитель FNV-1a 64
+
+/**
+ * @brief Добавление байтов к хешу FNV-1a 64
+ * @param h Текущее значение хеша
+ * @param data Байты
+ * @return Новое значение хеша
+ */
+uint64_t hashBytes(uint64_t h, std::string_view data) {
+    for (unsigned char c : data) {
+        h ^= c;
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+/**
+ * @brief Перемешивание старших бит хеша
+ * @param h Хеш FNV-1a
+ * @return Хеш ключа
+ */
+uint64_t finish(uint64_t h) {
+    return h ^ (h >> 29);
+}
+
+/**
+ * @brief Хеш адреса клиента
+ * @param address Адрес клиента
+ * @return Хеш ключа
+ */
+uint64_t addressKey(std::string_view address) {
+    return finish(hashBytes(ADDRESS_SEED, address));
+}
+
+/**
+ * @brief Хеш пары адрес-логин
+ * @param address Адрес клиента
+ * @param login Логин пользователя
+ * @return Хеш ключа
+ * @details Между адресом и логином хешируется нулевой байт, которого нет в адресе,
+ *          поэтому разные разбиения одной строки дают разные ключи
+ */
+uint64_t loginKey(std::string_view address, std::string_view login) {
+    uint64_t h = hashBytes(LOGIN_SEED, address);
+    h *= FNV_PRIME;
+    return finish(hashBytes(h, login));
+}
+
+} // namespace
+
+/**
+ * @brief Конструктор
+ * @param limit Количество неудач, после которого ключ отклоняется
+ * @param window Период полураспада счетчиков в секундах
+ */
+AuthThrottle::AuthThrottle(unsigned limit, unsigned window)
+    : failureLimit(limit), window(window == 0 ? 1 : window),
+      rejectedAddressCount(0), rejectedLoginCount(0)
+{
+}
+
+/**
+ * @brief Получение текущего времени для счетчиков
+ * @return Секунды монотонных часов
+ */
+uint32_t AuthThrottle::clock() {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Проверка адреса клиента сразу после подключения
+ * @param address Адрес клиента
+ * @param time Текущее время в секундах
+ * @return true - подключение разрешено, false - адрес отклонен
+ */
+bool AuthThrottle::allowAddress(std::string_view address, uint32_t time) {
+    if (addresses.estimate(addressKey(address), windowOf(time)) < failureLimit) {
+        return true;
+    }
+    rejectedAddressCount.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+/**
+ * @brief Проверка логина перед проверкой пароля
+ * @param address Адрес клиента
+ * @param login Логин пользователя
+ * @param time Текущее время в секундах
+ * @return true - проверка разрешена, false - логин отклонен для этого адреса
+ */
+bool AuthThrottle::allowLogin(std::string_view address, std::string_view login, uint32_t time) {
+    if (logins.estimate(loginKey(address, login), windowOf(time)) < failureLimit) {
+        return true;
+    }
+    rejectedLoginCount.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+/**
+ * @brief Учет неудачной аутентификации
+ * @param address Адрес клиента
+ * @param login Логин пользователя (пустой - учитывается только адрес)
+ * @param time Текущее время в секундах
+ */
+void AuthThrottle::recordFailure(std::string_view address, std::string_view login, uint32_t time) {
+    uint32_t w = windowOf(time);
+    addresses.add(addressKey(address), w);
+    if (!login.empty()) {
+        logins.add(loginKey(address, login), w);
+    }
+}
+
+/**
+ * @brief Получение оценки числа неудач адреса
+ * @param address Адрес клиента
+ * @param time Текущее время в секундах
+ * @return Затухающее количество неудач
+ */
+uint32_t AuthThrottle::addressFailures(std::string_view address, uint32_t time) const {
+    return addresses.estimate(addressKey(address), windowOf(time));
+}
+
+/**
+ * @brief Получение оценки числа неудач логина с адреса
+ * @param address Адрес клиента
+ * @param login Логин пользователя
+ * @param time Текущее время в секундах
+ * @return Затухающее количество неудач
+ */
+uint32_t AuthThrottle::loginFailures(std::string_view address, std::string_view login, uint32_t time) const {
+    return logins.estimate(loginKey(address, login), windowOf(time));
+}
+
+/**
+ * @brief Значение счетчика ячейки с учетом затухания
+ * @param cell Слово ячейки
+ * @param window Номер текущего окна
+ * @return Счетчик, уменьшенный вдвое за каждое прошедшее окно
+ * @details Ячейка из будущего окна (часы разных потоков прочитаны в разном порядке)
+ *          считается текущей
+ */
+uint32_t AuthThrottle::decayed(uint64_t cell, uint32_t window) {
+    uint32_t count = static_cast<uint32_t>(cell);
+    uint32_t stamp = static_cast<uint32_t>(cell >> 32);
+    if (count == 0 || stamp >= window) {
+        return count;
+    }
+    uint32_t elapsed = window - stamp;
+    return elapsed >= 32 ? 0 : count >> elapsed;
+}
+
+/**
+ * @brief Конструктор таблицы
+ */
+AuthThrottle::Sketch::Sketch()
+    : cells(new std::atomic<uint64_t>[DEPTH * WIDTH]())
+{
+}
+
+/**
+ * @brief Вычисление номеров ячеек ключа
+ * @param key Хеш ключа
+ * @param index Номера ячеек по строкам
+ * @details Номера строк получаются двойным хешированием h1 + i * h2 из половин
+ *          64-битного хеша
+ */
+void AuthThrottle::Sketch::locate(uint64_t key, size_t* index) {
+    uint32_t h1 = static_cast<uint32_t>(key);
+    uint32_t h2 = static_cast<uint32_t>(key >> 32) | 1;
+    for (unsigned i = 0; i < DEPTH; ++i) {
+        index[i] = i * WIDTH + ((h1 + i * h2) & (WIDTH - 1));
+    }
+}
+
+/**
+ * @brief Увеличение счетчиков ключа на единицу
+ * @param key Хеш ключа
+ * @param window Номер текущего окна
+ * @details Каждая ячейка затухает до текущего окна и увеличивается одним
+ *          compare_exchange; при гонке с другим потоком попытка повторяется
+ */
+void AuthThrottle::Sketch::add(uint64_t key, uint32_t window) {
+    size_t index[DEPTH];
+    locate(key, index);
+    for (unsigned i = 0; i < DEPTH; ++i) {
+        std::atomic<uint64_t>& cell = cells[index[i]];
+        uint64_t old = cell.load(std::memory_order_relaxed);
+        uint64_t updated;
+        do {
+            uint32_t count = decayed(old, window);
+            if (count != std::numeric_limits<uint32_t>::max()) {
+                ++count;
+            }
+            uint32_t stamp = std::max(window, static_cast<uint32_t>(old >> 32));
+            updated = (static_cast<uint64_t>(stamp) << 32) | count;
+        } while (!cell.compare_exchange_weak(old, updated, std::memory_order_relaxed));
+    }
+}
+
+/**
+ * @brief Оценка счетчика ключа
+ * @param key Хеш ключа
+ * @param window Номер текущего окна
+ * @return Минимум затухших значений ячеек ключа
+ */
+uint32_t AuthThrottle::Sketch::estimate(uint64_t key, uint32_t window) const {
+    size_t index[DEPTH];
+    locate(key, index);
+    uint32_t result = std::numeric_limits<uint32_t>::max();
+    for (unsigned i = 0; i < DEPTH; ++i) {
+        result = std::min(result, decayed(cells[index[i]].load(std::memory_order_relaxed), window));
+    }
+    return result;
+}
@@ -6,24 +6,25 @@
 #include "Authenticator.h"
 #include "UserDatabase.h"
 #include "Logger.h"
-#include <cryptopp/sha.h>
-#include <cryptopp/hex.h>
-#include <cryptopp/filters.h>
-#include <iostream>
+#include "Digest.h"
+#include "TicketManager.h"
+#include "AuthThrottle.h"
+#include "Metrics.h"
+#include "Tracer.h"
 #include <algorithm>
-#include <cctype>
+#include <cstring>
+#include <ctime>
 
-namespace CPP = CryptoPP;
+const char Authenticator::RESUME_PREFIX[] = "RESUME:";
 
 /**
  * @brief Проверка строки на соответствие шестнадцатеричному формату
  * @param str Проверяемая строка
- * @param logger Ссылка на журнал для записи ошибок
  * @return true - строка содержит только hex-символы,
  *         false - строка содержит недопустимые символы
  * @details Допустимые символы: 0-9, A-F, a-f
  */
-bool Authenticator::isValidHex(const std::string& str) const {
+bool Authenticator::isValidHex(std::string_view str) const {
     return std::all_of(str.begin(), str.end(), [](char c) {
         return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f');
     });
@@ -32,73 +33,198 @@ bool Authenticator::isValidHex(const std::string& str) const {
 /**
  * @brief Проверка аутентификационных данных пользователя
  * @param login Логин пользователя
- * @param salt_hash_client Строка формата SALT16 + HASH (56 символов)
+ * @param salt_hash_client Строка формата SALT16 + HASH (authDataLength() символов)
  * @param db Ссылка на базу данных пользователей
  * @param logger Ссылка на журнал для записи ошибок
  * @return true - аутентификация успешна,
  *         false - аутентификация не пройдена
  * @details Алгоритм проверки:
- *          1. Проверка длины сообщения (16+40=56 символов)
- *          2. Валидация hex-формата SALT и HASH
+ *          1. Проверка длины сообщения (16+40=56 символов для SHA-1, 16+64=80 для SHA-256)
+ *          2. Валидация hex-формата SALT и декодирование HASH клиента в байты
  *          3. Поиск пользователя в базе данных
- *          4. Вычисление хеша SHA-1 от (SALT + PASSWORD)
- *          5. Сравнение вычисленного хеша с полученным
- * @note Используется схема: HASH = SHA1(SALT || PASSWORD)
+ *          4. Вычисление хеша от (SALT + PASSWORD) в буфер на стеке
+ *          5. Сравнение хешей за постоянное время
+ *
+ *          Объект хеш-функции создается один раз на поток для каждого алгоритма
+ *          и переиспользуется, SALT и HASH не копируются из сообщения, поэтому
+ *          проверка не выделяет память (кроме записи в журнал)
+ * @note Используется схема: HASH = H(SALT || PASSWORD), H - SHA-1 или SHA-256
  * @warning При несовпадении хешей в журнал записывается ошибка аутентификации
  */
-bool Authenticator::verify(const std::string& login, const std::string& salt_hash_client, 
+bool Authenticator::verify(std::string_view login, std::string_view salt_hash_client, 
                            UserDatabase& db, Logger& logger) const {
-    
-    if (salt_hash_client.length() != SALT16_LENGTH + SHA1_HEX_LENGTH) {
-        logger.logError("Authenticator: Message length mismatch. Expected: " + 
-                       std::to_string(SALT16_LENGTH + SHA1_HEX_LENGTH) + 
-                       ", got: " + std::to_string(salt_hash_client.length()), false);
+    Tracer::Span span(Tracer::Stage::Verify);
+
+    if (salt_hash_client.length() != authDataLength()) {
+        logger.error("Authenticator: Message length mismatch. Expected: ", authDataLength(),
+                     ", got: ", salt_hash_client.length());
         return false;
     }
     
-    std::string salt16 = salt_hash_client.substr(0, SALT16_LENGTH);
-    std::string clientHash16 = salt_hash_client.substr(SALT16_LENGTH);
+    std::string_view salt16(salt_hash_client.data(), SALT16_LENGTH);
     
     if (!isValidHex(salt16)) {
-        logger.logError("Authenticator: Invalid hex format in SALT16: " + salt16, false);
+        logger.error("Authenticator: Invalid hex format in SALT16: ", salt16);
         return false;
     }
     
-    if (!isValidHex(clientHash16)) {
-        logger.logError("Authenticator: Invalid hex format in client hash", false);
+    size_t digest_size = Digest::size(algorithm);
+    unsigned char client_digest[Digest::MAX_SIZE];
+    if (!Digest::decodeHex(salt_hash_client.data() + SALT16_LENGTH, client_digest, digest_size)) {
+        logger.error("Authenticator: Invalid hex format in client hash");
         return false;
     }
     
-    std::string password;
-    if (!db.getPassword(login, password)) {
-        logger.logError("Authenticator: Login " + login + " not found", false);
+    UserDatabase::Reader reader(db); // снимок базы закреплен до конца проверки
+    std::string_view password;
+    if (!reader.getPassword(login, password)) {
+        logger.error("Authenticator: Login ", login, " not found");
         return false;
     }
     
-    std::string input = salt16 + password;
-    std::string serverHash16;
-    
+    unsigned char server_digest[Digest::MAX_SIZE];
     try {
-        CPP::SHA1 hash;
-        
-        CPP::StringSource(input, true,
-            new CPP::HashFilter(hash, 
-                new CPP::HexEncoder(
-                    new CPP::StringSink(serverHash16))));
-        
-    } catch (const CPP::Exception& e) {
+        thread_local std::unique_ptr<Digest> digests[Digest::ALGORITHM_COUNT];
+        std::unique_ptr<Digest>& digest = digests[static_cast<size_t>(algorithm)];
+        if (!digest) {
+            digest = Digest::create(algorithm);
+        }
+        digest->update(salt16.data(), salt16.size());
+        digest->update(password.data(), password.size());
+        digest->final(server_digest);
+    } catch (const std::exception& e) {
         logger.logError(std::string("Crypto++ error: ") + e.what(), true);
         return false;
     }
     
-    std::transform(clientHash16.begin(), clientHash16.end(), clientHash16.begin(), ::toupper);
-    std::transform(serverHash16.begin(), serverHash16.end(), serverHash16.begin(), ::toupper);
-    
-    if (serverHash16 == clientHash16) {
-        logger.logInfo("Authenticator: Success for login " + login);
+    if (Digest::equal(server_digest, client_digest, digest_size)) {
+        logger.info("Authenticator: Success for login ", login);
         return true;
     } else {
-        logger.logError("Authenticator: Password mismatch for login " + login, false);
+        logger.error("Authenticator: Password mismatch for login ", login);
+        return false;
+    }
+}
+
+/**
+ * @brief Аутентификация по строке, принятой от клиента
+ * @param message Строка LOGIN + SALT16 + HASH или "RESUME:" + билет + логин (без перевода строки)
+ * @param peer Адрес клиента для учета неудач
+ * @param db Ссылка на базу данных пользователей
+ * @param logger Ссылка на журнал для записи событий
+ * @param out_login Логин из строки
+ * @return Успех или код ошибки аутентификации с логином в подробности
+ * @details Отделяет логин от SALT+HASH и проверяет их (строку "RESUME:..." - как билет).
+ *          При подключенном ограничителе неудачи учитываются, а логин, превысивший порог
+ *          неудач с адреса клиента, отклоняется с этого адреса без обращения к базе и
+ *          вычисления хеша. При подключенных метриках
+ *          учитываются исход и время проверки
+ */
+SessionStatus Authenticator::authenticate(const std::string& message, const std::string& peer, UserDatabase& db,
+                                          Logger& logger, std::string& out_login) const {
+    if (stats == nullptr) {
+        return check(message, peer, db, logger, out_login);
+    }
+    uint64_t started = Metrics::now();
+    SessionStatus status = check(message, peer, db, logger, out_login);
+    stats->record(Metrics::Latency::Auth, Metrics::now() - started);
+    stats->add(status ? Metrics::Counter::AuthSuccesses : Metrics::Counter::AuthFailures);
+    return status;
+}
+
+/**
+ * @brief Проверка строки аутентификации без учета в метриках
+ * @param message Строка LOGIN + SALT16 + HASH или "RESUME:" + билет + логин (без перевода строки)
+ * @param peer Адрес клиента для учета неудач
+ * @param db Ссылка на базу данных пользователей
+ * @param logger Ссылка на журнал для записи событий
+ * @param out_login Логин из строки
+ * @return Успех или код ошибки аутентификации с логином в подробности
+ */
+SessionStatus Authenticator::check(const std::string& message, const std::string& peer, UserDatabase& db,
+                                   Logger& logger, std::string& out_login) const {
+    if (isResume(message)) {
+        if (!resume(message, out_login, logger)) {
+            if (limiter) {
+                limiter->recordFailure(peer, out_login);
+            }
+            return SessionStatus(SessionStatus::Code::TicketRejected, out_login);
+        }
+        return SessionStatus();
+    }
+
+    size_t auth_length = authDataLength();
+    if (message.length() < auth_length) {
+        if (limiter) {
+            limiter->recordFailure(peer, "");
+        }
+        return SessionStatus(SessionStatus::Code::AuthTooShort);
+    }
+    out_login.assign(message, 0, message.length() - auth_length);
+    if (limiter && !limiter->allowLogin(peer, out_login)) {
+        limiter->recordFailure(peer, "");
+        return SessionStatus(SessionStatus::Code::AuthThrottled, out_login);
+    }
+    std::string_view auth_data(message.data() + message.length() - auth_length, auth_length);
+    if (!verify(out_login, auth_data, db, logger)) {
+        if (limiter) {
+            limiter->recordFailure(peer, out_login);
+        }
+        return SessionStatus(SessionStatus::Code::AuthFailed, out_login);
+    }
+    return SessionStatus();
+}
+
+/**
+ * @brief Проверка, является ли строка запросом возобновления сессии
+ * @param message Строка аутентификации клиента
+ * @return true - билеты включены и строка начинается с RESUME_PREFIX
+ */
+bool Authenticator::isResume(const std::string& message) const {
+    return tickets != nullptr && message.compare(0, sizeof(RESUME_PREFIX) - 1, RESUME_PREFIX) == 0;
+}
+
+/**
+ * @brief Возобновление сессии по билету
+ * @param message Строка "RESUME:" + билет + логин
+ * @param out_login Логин из строки
+ * @param logger Ссылка на журнал для записи событий
+ * @return true - билет действителен для этого логина
+ * @details База пользователей и хеш пароля не используются: подпись билета
+ *          подтверждает, что этот логин уже прошел аутентификацию
+ */
+bool Authenticator::resume(const std::string& message, std::string& out_login, Logger& logger) const {
+    size_t prefix = sizeof(RESUME_PREFIX) - 1;
+    if (tickets == nullptr || message.length() <= prefix + TicketManager::TICKET_LENGTH) {
+        logger.logError("Authenticator: Malformed session resume message", false);
+        return false;
+    }
+    std::string_view ticket(message.data() + prefix, TicketManager::TICKET_LENGTH);
+    out_login = message.substr(prefix + TicketManager::TICKET_LENGTH);
+    if (!tickets->validate(out_login, ticket, std::time(nullptr))) {
+        logger.error("Authenticator: Invalid session ticket for login ", out_login);
         return false;
     }
+    logger.info("Authenticator: Session resumed for login ", out_login);
+    return true;
+}
+
+/**
+ * @brief Выдача билета после успешной аутентификации
+ * @param message Строка аутентификации, по которой клиент прошел проверку
+ * @param login Логин пользователя
+ * @return Билет или пустая строка, если билеты отключены
+ * @details Возобновление не проверяет пароль по базе, поэтому клиенту возвращается
+ *          тот же билет с прежним сроком: иначе, переподключаясь до истечения срока,
+ *          он продлевал бы доступ бесконечно, в том числе после удаления или смены
+ *          пароля пользователя в базе
+ */
+std::string Authenticator::issueTicket(const std::string& message, const std::string& login) const {
+    if (tickets == nullptr) {
+        return std::string();
+    }
+    if (isResume(message)) {
+        return message.substr(sizeof(RESUME_PREFIX) - 1, TicketManager::TICKET_LENGTH);
+    }
+    return tickets->issue(login, std::time(nullptr));
 }
@@ -0,0 +1,218 @@
+/**
+ * @file BinaryLog.cpp
+ * @brief Реализация разбора двоичного журнала
+ */
+
+#include "BinaryLog.h"
+#include "Logger.h"
+#include <ctime>
+#include <unordered_map>
+
+namespace {
+
+/**
+ * @brief Событие, ожидающее объявления своего шаблона
+ */
+struct Pending {
+    uint8_t level; ///< Уровень
+    uint32_t event; ///< Номер шаблона
+    uint64_t timestamp; ///< Время, нс
+    const char* body; ///< Аргументы
+    size_t length; ///< Длина аргументов
+};
+
+/**
+ * @brief Чтение значения фиксированной длины из тела события
+ * @param pos Текущая позиция (сдвигается за значение)
+ * @param end Конец тела
+ * @param value Результат
+ * @return true - значение прочитано
+ */
+template <typename T>
+bool readValue(const char*& pos, const char* end, T& value) {
+    if (static_cast<size_t>(end - pos) < sizeof(value)) {
+        return false;
+    }
+    std::memcpy(&value, pos, sizeof(value));
+    pos += sizeof(value);
+    return true;
+}
+
+/**
+ * @brief Подстановка аргументов события в шаблон
+ * @param text Шаблон
+ * @param p Событие
+ * @param entry Запись с текстом сообщения и строковыми аргументами
+ * @return true - аргументы соответствуют шаблону
+ */
+bool render(const std::string& text, const Pending& p, BinaryLog::Entry& entry) {
+    const char* pos = p.body;
+    const char* end = p.body + p.length;
+    for (char c : text) {
+        if (c != BinaryLog::PLACEHOLDER) {
+            entry.message.push_back(c);
+            continue;
+        }
+        uint8_t type;
+        if (!readValue(pos, end, type)) {
+            return false;
+        }
+        switch (static_cast<BinaryLog::ArgType>(type)) {
+        case BinaryLog::ArgType::Int: {
+            int64_t v;
+            if (!readValue(pos, end, v)) {
+                return false;
+            }
+            entry.message += std::to_string(v);
+            break;
+        }
+        case BinaryLog::ArgType::Uint: {
+            uint64_t v;
+            if (!readValue(pos, end, v)) {
+                return false;
+            }
+            entry.message += std::to_string(v);
+            break;
+        }
+        case BinaryLog::ArgType::Double: {
+            double v;
+            if (!readValue(pos, end, v)) {
+                return false;
+            }
+            entry.message += std::to_string(v);
+            break;
+        }
+        case BinaryLog::ArgType::Bool:
+        case BinaryLog::ArgType::Char: {
+            char v;
+            if (!readValue(pos, end, v)) {
+                return false;
+            }
+            if (static_cast<BinaryLog::ArgType>(type) == BinaryLog::ArgType::Bool) {
+                entry.message += v ? "true" : "false";
+            } else {
+                entry.message.push_back(v);
+            }
+            break;
+        }
+        case BinaryLog::ArgType::String: {
+            uint32_t length;
+            if (!readValue(pos, end, length) || static_cast<size_t>(end - pos) < length) {
+                return false;
+            }
+            entry.strings.emplace_back(pos, length);
+            entry.message.append(pos, length);
+            pos += length;
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return pos == end;
+}
+
+/**
+ * @brief Сопоставление событий сегмента с шаблонами
+ * @param templates Шаблоны сегмента
+ * @param pending События сегмента (очищается)
+ * @param entries Разобранные записи
+ */
+void flushSegment(const std::unordered_map<uint32_t, std::string>& templates, std::vector<Pending>& pending,
+                  std::vector<BinaryLog::Entry>& entries) {
+    for (const Pending& p : pending) {
+        BinaryLog::Entry entry{p.level, p.timestamp, std::string(), {}};
+        auto it = templates.find(p.event);
+        if (it == templates.end() || !render(it->second, p, entry)) {
+            entry.message = "<undecodable event " + std::to_string(p.event) + ">";
+            entry.strings.clear();
+        }
+        entries.push_back(std::move(entry));
+    }
+    pending.clear();
+}
+
+}
+
+/**
+ * @brief Проверка начала двоичного журнала
+ * @param data Начало файла
+ * @param size Длина данных
+ * @return true - данные начинаются с записи Segment
+ */
+bool BinaryLog::isBinary(const char* data, size_t size) {
+    return size >= HEADER_SIZE + sizeof(MAGIC) && data[0] == static_cast<char>(Kind::Segment) &&
+           std::memcmp(data + HEADER_SIZE, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+/**
+ * @brief Разбор двоичного журнала
+ * @param data Содержимое файла
+ * @param size Длина содержимого
+ * @param entries Разобранные записи в порядке файла
+ * @param error Описание ошибки формата
+ * @return true - файл разобран целиком, false - файл не является двоичным
+ *         журналом или обрывается (entries содержит записи до места ошибки)
+ * @details События сегмента накапливаются и сопоставляются с шаблонами в конце
+ *          сегмента, поэтому порядок объявления шаблона и события не важен
+ */
+bool BinaryLog::decode(const char* data, size_t size, std::vector<Entry>& entries, std::string& error) {
+    if (!isBinary(data, size)) {
+        error = "not a binary log";
+        return false;
+    }
+    std::unordered_map<uint32_t, std::string> templates;
+    std::vector<Pending> pending;
+    size_t offset = 0;
+    while (offset < size) {
+        if (size - offset < HEADER_SIZE) {
+            error = "truncated record header at offset " + std::to_string(offset);
+            break;
+        }
+        const char* header = data + offset;
+        Kind kind = static_cast<Kind>(header[0]);
+        uint8_t level = static_cast<uint8_t>(header[1]);
+        uint32_t event;
+        uint64_t timestamp;
+        uint32_t length;
+        std::memcpy(&event, header + 4, sizeof(event));
+        std::memcpy(&timestamp, header + 8, sizeof(timestamp));
+        std::memcpy(&length, header + 16, sizeof(length));
+        if (size - offset - HEADER_SIZE < length) {
+            error = "truncated record at offset " + std::to_string(offset);
+            break;
+        }
+        const char* body = header + HEADER_SIZE;
+        if (kind == Kind::Segment) {
+            flushSegment(templates, pending, entries);
+            templates.clear();
+        } else if (kind == Kind::Template) {
+            templates[event].assign(body, length);
+        } else if (kind == Kind::Event) {
+            pending.push_back(Pending{level, event, timestamp, body, length});
+        } else {
+            error = "unknown record kind " + std::to_string(static_cast<unsigned>(kind)) + " at offset " +
+                    std::to_string(offset);
+            break;
+        }
+        offset += HEADER_SIZE + length;
+    }
+    flushSegment(templates, pending, entries);
+    return offset == size;
+}
+
+/**
+ * @brief Форматирование записи в текстовом формате журнала
+ * @param entry Запись
+ * @return Строка "YYYY-MM-DD HH:MM:SS; УРОВЕНЬ; СООБЩЕНИЕ" (местное время)
+ */
+std::string BinaryLog::formatLine(const Entry& entry) {
+    time_t seconds = static_cast<time_t>(entry.timestamp / 1000000000);
+    std::tm tm{};
+    localtime_r(&seconds, &tm);
+    char timestamp[32];
+    size_t length = std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &tm);
+    Logger::Level level = entry.level < static_cast<uint8_t>(Logger::Level::Off)
+                          ? static_cast<Logger::Level>(entry.level) : Logger::Level::Critical;
+    return std::string(timestamp, length) + "; " + Logger::levelName(level) + "; " + entry.message;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file BufferPool.cpp
+ * @brief Реализация класса BufferPool - пула буферов для данных векторов
+ */
+
+#include "BufferPool.h"
+#include <new>
+#include <cstdlib>
+#include <sys/mman.h>
+
+/**
+ * @brief Возврат текущего буфера в пул и перенос буфера из другого объекта
+ * @param other Перемещаемый буфер
+ * @return Ссылка на текущий объект
+ */
+BufferPool::Buffer& BufferPool::Buffer::operator=(Buffer&& other) noexcept {
+    if (this != &other) {
+        reset();
+        pool = other.pool;
+        ptr = other.ptr;
+        sizeClass = other.sizeClass;
+        other.ptr = nullptr;
+    }
+    return *this;
+}
+
+/**
+ * @brief Возврат буфера в пул
+ */
+void BufferPool::Buffer::reset() {
+    if (ptr) {
+        pool->release(ptr, sizeClass);
+        ptr = nullptr;
+    }
+}
+
+/**
+ * @brief Конструктор пула
+ * @param huge_pages Использовать большие страницы для буферов от HUGE_PAGE_SIZE
+ * @param cache_limit Предел объема свободных буферов в пуле
+ */
+BufferPool::BufferPool(bool huge_pages, size_t cache_limit)
+    : hugePages(huge_pages), cacheLimit(cache_limit), cached(0), allocationCount(0)
+{
+}
+
+/**
+ * @brief Деструктор
+ * @details Освобождает свободные буферы
+ */
+BufferPool::~BufferPool() {
+    for (unsigned c = 0; c < CLASS_COUNT; ++c) {
+        for (char* ptr : freeLists[c]) {
+            deallocate(ptr, c);
+        }
+    }
+}
+
+/**
+ * @brief Получение буфера
+ * @param size Требуемый размер в байтах
+ * @return Буфер емкостью не меньше size с неинициализированным содержимым
+ * @throw std::bad_alloc при нехватке памяти или слишком большом размере
+ * @details Выбирает наименьший подходящий класс и выдает свободный буфер этого
+ *          класса, а при его отсутствии выделяет новый
+ */
+BufferPool::Buffer BufferPool::acquire(size_t size) {
+    unsigned size_class = 0;
+    while (size_class < CLASS_COUNT && classSize(size_class) < size) {
+        ++size_class;
+    }
+    if (size_class == CLASS_COUNT) {
+        throw std::bad_alloc();
+    }
+    std::vector<char*>& list = freeLists[size_class];
+    if (!list.empty()) {
+        char* ptr = list.back();
+        list.pop_back();
+        cached -= classSize(size_class);
+        return Buffer(this, ptr, size_class);
+    }
+    return Buffer(this, allocate(size_class), size_class);
+}
+
+/**
+ * @brief Выделение памяти под буфер класса
+ * @param size_class Класс размера
+ * @return Указатель на память
+ * @throw std::bad_alloc при нехватке памяти
+ * @details Небольшие буферы выделяются aligned_alloc без инициализации, крупные -
+ *          через mmap, чтобы освобождение возвращало память системе целиком
+ */
+char* BufferPool::allocate(unsigned size_class) {
+    size_t size = classSize(size_class);
+    void* ptr;
+    if (size < HUGE_PAGE_SIZE) {
+        ptr = std::aligned_alloc(64, size);
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+    } else {
+        ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (ptr == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        if (hugePages) {
+            madvise(ptr, size, MADV_HUGEPAGE); // ошибка не критична: останутся обычные страницы
+        }
+    }
+    ++allocationCount;
+    return static_cast<char*>(ptr);
+}
+
+/**
+ * @brief Освобождение памяти буфера класса
+ * @param ptr Указатель на память
+ * @param size_class Класс размера
+ */
+void BufferPool::deallocate(char* ptr, unsigned size_class) {
+    size_t size = classSize(size_class);
+    if (size < HUGE_PAGE_SIZE) {
+        std::free(ptr);
+    } else {
+        munmap(ptr, size);
+    }
+}
+
+/**
+ * @brief Возврат буфера в пул
+ * @param ptr Указатель на память
+ * @param size_class Класс размера
+ * @details Буфер, не помещающийся в предел объема свободных буферов, освобождается
+ */
+void BufferPool::release(char* ptr, unsigned size_class) {
+    size_t size = classSize(size_class);
+    if (cached + size > cacheLimit) {
+        deallocate(ptr, size_class);
+        return;
+    }
+    try {
+        freeLists[size_class].push_back(ptr);
+    } catch (const std::bad_alloc&) {
+        deallocate(ptr, size_class);
+        return;
+    }
+    cached += size;
+}
@@ -0,0 +1,385 @@
+/**
+ * @file Connection.cpp
+ * @brief Реализация класса Connection - конечного автомата протокола клиента
+ */
+
+#include "Connection.h"
+#include "Server.h"
+#include "Metrics.h"
+#include "Tracer.h"
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/socket.h>
+
+/**
+ * @brief Конструктор соединения
+ * @param sock Неблокирующий сокет клиента
+ * @param peer Адрес клиента для записи в журнал
+ * @param logger Ссылка на журнал
+ * @param userDb Ссылка на базу данных пользователей
+ * @param authenticator Ссылка на аутентификатор
+ * @param processor Ссылка на обработчик данных
+ * @param pool Пул буферов для данных векторов (пул потока, обслуживающего соединение)
+ * @param streaming Потоковое суммирование векторов без их сохранения
+ * @param metrics Метрики векторов и закрытых соединений (nullptr - не учитывать)
+ */
+Connection::Connection(int sock, const std::string& peer, Logger& logger, UserDatabase& userDb,
+                       Authenticator& authenticator, DataProcessor& processor, BufferPool& pool,
+                       bool streaming, Metrics* metrics)
+    : sock(sock), peer(peer), logger(logger), userDb(userDb),
+      authenticator(authenticator), processor(processor), pool(pool), streaming(streaming), stats(metrics),
+      state(State::ReadAuth), pendingInput(false), header(0),
+      numVectors(0), vectorIndex(0), payloadBytes(0), payloadRead(0), payloadStarted(0), outOffset(0),
+      traceSession(0), authStarted(0)
+{
+}
+
+/**
+ * @brief Деструктор соединения
+ * @details Закрывает сокет клиента и учитывает закрытие в метриках
+ */
+Connection::~Connection() {
+    close(sock);
+    if (stats) {
+        stats->add(Metrics::Counter::ConnectionsClosed);
+    }
+}
+
+/**
+ * @brief Обработка готовности сокета к чтению
+ * @return true - соединение активно,
+ *         false - соединение нужно закрыть
+ * @details Принимает данные во входной буфер и разбирает накопленные кадры.
+ *          Данные большого вектора, начинающиеся с пустого входного буфера, в обычном
+ *          режиме принимаются прямо в память вектора без промежуточного копирования.
+ *          Чтение прекращается на EAGAIN либо по исчерпании READ_BUDGET, чтобы
+ *          один быстрый клиент не задерживал остальные
+ * @note Строка аутентификации считается принятой при получении '\n' или когда
+ *       клиент замолчал, передав не менее authDataLength() символов
+ */
+bool Connection::onReadable() {
+    Tracer::Scope scope(traceSession);
+    pendingInput = false;
+    size_t budget = READ_BUDGET;
+    try {
+        while (state != State::Closing) {
+            size_t remaining = payloadBytes - payloadRead;
+            bool direct = state == State::ReadPayload && !streaming && input.buffered() == 0 &&
+                          remaining >= input.buffer().capacity();
+            ssize_t rc;
+            if (direct) {
+                rc = recv(sock, payload.data() + payloadRead,
+                          std::min(remaining, budget), 0);
+            } else {
+                rc = input.buffer().receive(sock, budget);
+            }
+            if (rc == 0) {
+                if (state == State::ReadAuth) {
+                    logger.logError("Client disconnected during authentication", false);
+                } else {
+                    logger.error("Client ", peer, " disconnected");
+                }
+                return false;
+            }
+            if (rc == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    if (state == State::ReadAuth && input.buffered() >= authenticator.authDataLength()) {
+                        processInput(true);
+                        continue;
+                    }
+                    break;
+                }
+                logger.logError("recv error: " + std::string(strerror(errno)), false);
+                return false;
+            }
+
+            if (direct) {
+                payloadRead += rc;
+                if (payloadRead == payloadBytes) {
+                    completePayload();
+                }
+            }
+            processInput(false);
+
+            budget -= std::min(budget, static_cast<size_t>(rc));
+            if (budget == 0) {
+                pendingInput = (state != State::Closing);
+                break;
+            }
+        }
+    } catch (const std::exception& e) {
+        logger.logError("Error in client session: " + std::string(e.what()), false);
+        fail("Protocol processing error");
+    }
+
+    if (!flush()) {
+        return false;
+    }
+    return !(state == State::Closing && outBuffer.empty());
+}
+
+/**
+ * @brief Обработка данных, уже принятых вызывающей стороной
+ * @param data Принятые данные
+ * @param len Длина данных
+ * @return true - соединение активно,
+ *         false - соединение можно закрыть после отправки ответов
+ * @details Передает данные во входной буфер и продвигает автомат протокола. Данные
+ *          вектора при пустом входном буфере обрабатываются на месте, без копирования.
+ *          Ответы только ставятся в очередь: их отправкой управляет вызывающая сторона
+ *          через pendingOutput() и outputSent(). Окончание порции данных для строки
+ *          аутентификации трактуется так же, как EAGAIN в onReadable()
+ */
+bool Connection::onData(const char* data, size_t len) {
+    Tracer::Scope scope(traceSession);
+    try {
+        while (len > 0 && state != State::Closing) {
+            size_t n;
+            if (state == State::ReadPayload && input.buffered() == 0) {
+                n = std::min(len, payloadBytes - payloadRead);
+                consumePayload(data, n);
+            } else {
+                n = input.buffer().write(data, len);
+                processInput(false);
+            }
+            data += n;
+            len -= n;
+        }
+        if (state == State::ReadAuth && input.buffered() >= authenticator.authDataLength()) {
+            processInput(true);
+        }
+    } catch (const std::exception& e) {
+        logger.logError("Error in client session: " + std::string(e.what()), false);
+        fail("Protocol processing error");
+    }
+    return !isFinished();
+}
+
+/**
+ * @brief Разбор накопленных во входном буфере кадров
+ * @param flush_auth Принять неполную строку аутентификации (клиент замолчал)
+ * @details Извлекает кадры, пока их хватает данных, поэтому несколько кадров,
+ *          пришедших одним чтением, обрабатываются за один вызов. Ошибка шага
+ *          протокола отправляет "ERR" и переводит соединение в состояние закрытия
+ */
+void Connection::processInput(bool flush_auth) {
+    while (state != State::Closing) {
+        switch (state) {
+        case State::ReadAuth:
+            if (!input.nextLine(authMessage, BUFLEN - 1, flush_auth)) {
+                return;
+            }
+            if (SessionStatus status = completeAuth(); !status) {
+                fail(status);
+            }
+            break;
+        case State::ReadCount:
+        case State::ReadLength:
+            if (!input.nextU32(header)) {
+                return;
+            }
+            if (SessionStatus status = completeHeader(); !status) {
+                fail(status);
+            }
+            break;
+        case State::ReadPayload:
+            if (input.nextPayload(payloadBytes - payloadRead,
+                                  [this](const char* data, size_t len) { consumePayload(data, len); }) == 0) {
+                return;
+            }
+            break;
+        case State::Closing:
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Учет отправленных вызывающей стороной байт
+ * @param len Количество отправленных байт
+ */
+void Connection::outputSent(size_t len) {
+    outOffset += len;
+    if (outOffset == outBuffer.size()) {
+        outBuffer.clear();
+        outOffset = 0;
+    }
+}
+
+/**
+ * @brief Обработка готовности сокета к записи
+ * @return true - соединение активно,
+ *         false - соединение нужно закрыть
+ */
+bool Connection::onWritable() {
+    if (!flush()) {
+        return false;
+    }
+    return !(state == State::Closing && outBuffer.empty());
+}
+
+/**
+ * @brief Проверка клиента по принятой строке аутентификации
+ * @return Успех или код ошибки аутентификации
+ * @details Удаляет символы перевода строки и передает строку аутентификатору.
+ *          При успехе отправляет "OK", за которым при включенных билетах следует билет
+ */
+SessionStatus Connection::completeAuth() {
+    Tracer::record(Tracer::Stage::ReadAuth, traceSession, authStarted, Tracer::now());
+    std::string& full_msg = authMessage;
+    full_msg.erase(std::remove_if(full_msg.begin(), full_msg.end(),
+                                  [](char c){ return c == '\n' || c == '\r'; }), full_msg.end());
+    std::string login;
+    SessionStatus status = authenticator.authenticate(full_msg, peer, userDb, logger, login);
+    if (!status) {
+        return status;
+    }
+    std::string reply = "OK" + authenticator.issueTicket(full_msg, login);
+    queue(reply.data(), reply.size());
+    logger.info("Client '", login, "' authenticated successfully");
+    state = State::ReadCount;
+    return status;
+}
+
+/**
+ * @brief Обработка принятого поля количества или длины
+ * @return Успех или InvalidLength при невалидной длине вектора
+ */
+SessionStatus Connection::completeHeader() {
+    if (state == State::ReadCount) {
+        numVectors = header;
+        logger.info("Receiving ", numVectors, " vectors");
+        state = (numVectors == 0) ? State::Closing : State::ReadLength;
+        return SessionStatus();
+    }
+
+    uint32_t vector_len = header;
+    size_t total_bytes_needed = vector_len * sizeof(int32_t);
+    if (vector_len == 0 || total_bytes_needed > 4000000000) {
+        return SessionStatus(SessionStatus::Code::InvalidLength);
+    }
+    payloadBytes = total_bytes_needed;
+    payloadRead = 0;
+    if (stats || traceSession) {
+        payloadStarted = Metrics::now();
+    }
+    if (streaming) {
+        accumulator.reset();
+    } else {
+        payload = pool.acquire(total_bytes_needed);
+    }
+    state = State::ReadPayload;
+    return SessionStatus();
+}
+
+/**
+ * @brief Обработка порции данных вектора, уже находящейся в памяти
+ * @param data Данные
+ * @param len Длина данных (не больше оставшейся части вектора)
+ * @details В потоковом режиме порция добавляется к сумме, иначе копируется в вектор
+ */
+void Connection::consumePayload(const char* data, size_t len) {
+    if (streaming) {
+        accumulator.feedBytes(data, len);
+    } else {
+        std::memcpy(payload.data() + payloadRead, data, len);
+    }
+    payloadRead += len;
+    if (payloadRead == payloadBytes) {
+        completePayload();
+    }
+}
+
+/**
+ * @brief Обработка полностью принятого вектора
+ * @details Вычисляет среднее арифметическое, возвращает буфер вектора в пул
+ *          и ставит результат в очередь отправки. При подключенных метриках учитывает
+ *          вектор, его байты, время приема и время вычисления
+ */
+void Connection::completePayload() {
+    uint64_t received = (stats || traceSession) ? Metrics::now() : 0;
+    Tracer::record(Tracer::Stage::Receive, traceSession, payloadStarted, received);
+    int32_t result;
+    if (streaming) {
+        result = processor.finalize(accumulator, logger);
+    } else {
+        result = processor.calculateAverage(reinterpret_cast<const int32_t*>(payload.data()),
+                                            payloadBytes / sizeof(int32_t), logger);
+        payload.reset();
+    }
+    if (stats) {
+        stats->record(Metrics::Latency::VectorReceive, received - payloadStarted);
+        stats->record(Metrics::Latency::Compute, Metrics::now() - received);
+        stats->add(Metrics::Counter::VectorsProcessed);
+        stats->add(Metrics::Counter::BytesProcessed, payloadBytes);
+    }
+    queue(&result, sizeof(result));
+    logger.info("Processed vector ", vectorIndex + 1, ", result: ", result);
+
+    if (++vectorIndex == numVectors) {
+        state = State::Closing;
+    } else {
+        state = State::ReadLength;
+    }
+}
+
+/**
+ * @brief Постановка ответа в очередь отправки
+ * @param data Указатель на данные
+ * @param len Длина данных
+ */
+void Connection::queue(const void* data, size_t len) {
+    outBuffer.append(static_cast<const char*>(data), len);
+}
+
+/**
+ * @brief Отправка накопленных ответов
+ * @return true - соединение активно (возможно, часть данных ждет EPOLLOUT),
+ *         false - ошибка отправки
+ */
+bool Connection::flush() {
+    if (outBuffer.empty()) {
+        return true;
+    }
+    Tracer::Span span(Tracer::Stage::Send);
+    while (outOffset < outBuffer.size()) {
+        ssize_t rc = send(sock, outBuffer.data() + outOffset, outBuffer.size() - outOffset, MSG_NOSIGNAL);
+        if (rc == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return true;
+            }
+            logger.logError("send error: " + std::string(strerror(errno)), false);
+            return false;
+        }
+        outOffset += rc;
+    }
+    outBuffer.clear();
+    outOffset = 0;
+    return true;
+}
+
+/**
+ * @brief Отправка "ERR" клиенту и перевод соединения в состояние закрытия
+ * @param message Текст сообщения для записи в журнал
+ */
+void Connection::fail(const std::string& message) {
+    queue("ERR", 3);
+    logger.logError("Error sent to client: " + message, false);
+    state = State::Closing;
+}
+
+/**
+ * @brief Отправка "ERR" клиенту по результату шага протокола
+ * @param status Результат с кодом ошибки
+ */
+void Connection::fail(const SessionStatus& status) {
+    fail(status.message());
+}
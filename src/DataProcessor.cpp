@@ -5,6 +5,201 @@
 
 #include "DataProcessor.h"
 #include "Logger.h"
+#include "ThreadPool.h"
+#include "Metrics.h"
+#include "Tracer.h"
+#include <cstring>
+#include <algorithm>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DATAPROCESSOR_X86 1 ///< Доступны векторные ядра суммирования x86
+#endif
+
+namespace {
+
+/**
+ * @brief Переносимое ядро суммирования
+ * @param data Указатель на элементы int32_t (выравнивание не требуется)
+ * @param count Количество элементов
+ * @return Сумма элементов в int64_t
+ */
+int64_t sumScalar(const char* data, size_t count) {
+    int64_t sum = 0; //предотвращение промежуточного переполнения
+    for (size_t i = 0; i < count; ++i) {
+        int32_t val;
+        std::memcpy(&val, data + i * sizeof(int32_t), sizeof(val));
+        sum += val;
+    }
+    return sum;
+}
+
+#ifdef DATAPROCESSOR_X86
+/**
+ * @brief Ядро суммирования SSE4.1
+ * @details Каждые 4 элемента расширяются знаком до двух пар 64-битных элементов
+ *          (pmovsxdq) и складываются в два 64-битных аккумулятора
+ */
+__attribute__((target("sse4.1")))
+int64_t sumSse41(const char* data, size_t count) {
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * sizeof(int32_t)));
+        acc0 = _mm_add_epi64(acc0, _mm_cvtepi32_epi64(v));
+        acc1 = _mm_add_epi64(acc1, _mm_cvtepi32_epi64(_mm_unpackhi_epi64(v, v)));
+    }
+    __m128i acc = _mm_add_epi64(acc0, acc1);
+    int64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return lanes[0] + lanes[1] + sumScalar(data + i * sizeof(int32_t), count - i);
+}
+
+/**
+ * @brief Ядро суммирования AVX2
+ * @details За итерацию обрабатывает 16 элементов: две загрузки по 8 элементов,
+ *          расширение знаком до 64 бит и сложение в четыре независимых аккумулятора
+ */
+__attribute__((target("avx2")))
+int64_t sumAvx2(const char* data, size_t count) {
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    __m256i acc2 = _mm256_setzero_si256();
+    __m256i acc3 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const char* p = data + i * sizeof(int32_t);
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+        acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(a)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(a, 1)));
+        acc2 = _mm256_add_epi64(acc2, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(b)));
+        acc3 = _mm256_add_epi64(acc3, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(b, 1)));
+    }
+    __m256i acc = _mm256_add_epi64(_mm256_add_epi64(acc0, acc1), _mm256_add_epi64(acc2, acc3));
+    int64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumScalar(data + i * sizeof(int32_t), count - i);
+}
+
+/**
+ * @brief Ядро суммирования AVX-512
+ * @details За итерацию обрабатывает 32 элемента: четыре загрузки по 8 элементов,
+ *          расширение знаком до 64 бит (vpmovsxdq) и сложение в четыре аккумулятора
+ */
+__attribute__((target("avx512f")))
+int64_t sumAvx512(const char* data, size_t count) {
+    __m512i acc0 = _mm512_setzero_si512();
+    __m512i acc1 = _mm512_setzero_si512();
+    __m512i acc2 = _mm512_setzero_si512();
+    __m512i acc3 = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i* p = reinterpret_cast<const __m256i*>(data + i * sizeof(int32_t));
+        // maskz-форма с полной маской совпадает с _mm512_cvtepi32_epi64, но не использует
+        // неопределенный исходный регистр (ложное предупреждение GCC -Wmaybe-uninitialized)
+        acc0 = _mm512_add_epi64(acc0, _mm512_maskz_cvtepi32_epi64(0xFF, _mm256_loadu_si256(p)));
+        acc1 = _mm512_add_epi64(acc1, _mm512_maskz_cvtepi32_epi64(0xFF, _mm256_loadu_si256(p + 1)));
+        acc2 = _mm512_add_epi64(acc2, _mm512_maskz_cvtepi32_epi64(0xFF, _mm256_loadu_si256(p + 2)));
+        acc3 = _mm512_add_epi64(acc3, _mm512_maskz_cvtepi32_epi64(0xFF, _mm256_loadu_si256(p + 3)));
+    }
+    __m512i acc = _mm512_add_epi64(_mm512_add_epi64(acc0, acc1), _mm512_add_epi64(acc2, acc3));
+    int64_t lanes[8];
+    _mm512_storeu_si512(lanes, acc);
+    int64_t sum = 0;
+    for (int64_t lane : lanes) {
+        sum += lane;
+    }
+    return sum + sumScalar(data + i * sizeof(int32_t), count - i);
+}
+#endif
+
+/**
+ * @brief Описание ядра суммирования
+ */
+struct SumKernel {
+    const char* name; ///< Название ядра
+    int64_t (*sum)(const char*, size_t); ///< Функция суммирования
+    bool (*supported)(); ///< Проверка поддержки процессором
+};
+
+/**
+ * @brief Ядра суммирования в порядке убывания предпочтения
+ */
+const SumKernel kernels[] = {
+#ifdef DATAPROCESSOR_X86
+    {"avx512", sumAvx512, []() { return static_cast<bool>(__builtin_cpu_supports("avx512f")); }},
+    {"avx2", sumAvx2, []() { return static_cast<bool>(__builtin_cpu_supports("avx2")); }},
+    {"sse4.1", sumSse41, []() { return static_cast<bool>(__builtin_cpu_supports("sse4.1")); }},
+#endif
+    {"scalar", sumScalar, []() { return true; }},
+};
+
+/**
+ * @brief Выбор лучшего ядра, поддерживаемого процессором
+ * @return Указатель на описание ядра
+ */
+const SumKernel* detectKernel() {
+#ifdef DATAPROCESSOR_X86
+    __builtin_cpu_init();
+#endif
+    for (const SumKernel& k : kernels) {
+        if (k.supported()) {
+            return &k;
+        }
+    }
+    return &kernels[sizeof(kernels) / sizeof(kernels[0]) - 1];
+}
+
+const SumKernel* activeKernel = detectKernel(); ///< Ядро, выбранное при запуске программы
+
+}
+
+/**
+ * @brief Добавление целых элементов
+ * @param data Указатель на элементы
+ * @param count Количество элементов
+ */
+void DataProcessor::Accumulator::feed(const int32_t* data, size_t count) {
+    total += activeKernel->sum(reinterpret_cast<const char*>(data), count);
+    elements += count;
+}
+
+/**
+ * @brief Добавление произвольного фрагмента байтового потока
+ * @param data Указатель на байты (выравнивание не требуется)
+ * @param len Количество байт
+ * @details Сначала дополняет неполный элемент, оставшийся от предыдущего фрагмента,
+ *          затем суммирует целые элементы выбранным ядром и сохраняет хвост
+ *          короче sizeof(int32_t) до следующего вызова
+ */
+void DataProcessor::Accumulator::feedBytes(const char* data, size_t len) {
+    if (partialLen != 0) {
+        size_t take = sizeof(int32_t) - partialLen;
+        if (take > len) {
+            take = len;
+        }
+        std::memcpy(partial + partialLen, data, take);
+        partialLen += take;
+        data += take;
+        len -= take;
+        if (partialLen < sizeof(int32_t)) {
+            return;
+        }
+        int32_t val;
+        std::memcpy(&val, partial, sizeof(val));
+        total += val;
+        elements++;
+        partialLen = 0;
+    }
+
+    size_t count = len / sizeof(int32_t);
+    total += activeKernel->sum(data, count);
+    elements += count;
+
+    partialLen = len - count * sizeof(int32_t);
+    std::memcpy(partial, data + count * sizeof(int32_t), partialLen);
+}
 
 /**
  * @brief Вычисление среднего арифметического значений вектора
@@ -22,26 +217,121 @@
  * @warning При пустом векторе возвращает 0 и записывает предупреждение в журнал
  */
 int32_t DataProcessor::calculateAverage(const std::vector<int32_t>& vector, Logger& logger) {
-    if (vector.empty()) {
+    return calculateAverage(vector.data(), vector.size(), logger);
+}
+
+/**
+ * @brief Вычисление среднего арифметического значений массива
+ * @param data Указатель на элементы
+ * @param count Количество элементов
+ * @param logger Ссылка на журнал для записи ошибок
+ * @return Среднее арифметическое
+ * @details Используется для данных во внешних буферах (например, из BufferPool).
+ *          Если задан пул потоков и длина не меньше порога, массив делится на части
+ *          по PARALLEL_CHUNK элементов, которые суммируются в пуле параллельно
+ */
+int32_t DataProcessor::calculateAverage(const int32_t* data, size_t count, Logger& logger) {
+    Tracer::Span span(Tracer::Stage::Average);
+    Accumulator acc;
+    if (pool != nullptr && count >= parallelThreshold) {
+        size_t chunks = (count + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+        std::vector<int64_t> partial(chunks);
+        const SumKernel* kernel = activeKernel;
+        pool->parallelFor(chunks, [&](size_t i) {
+            size_t begin = i * PARALLEL_CHUNK;
+            size_t len = std::min(PARALLEL_CHUNK, count - begin);
+            partial[i] = kernel->sum(reinterpret_cast<const char*>(data + begin), len);
+        });
+        int64_t sum = 0;
+        for (int64_t s : partial) {
+            sum += s;
+        }
+        acc.merge(sum, count);
+    } else {
+        acc.feed(data, count);
+    }
+    return finalize(acc, logger);
+}
+
+/**
+ * @brief Настройка параллельного суммирования больших векторов
+ * @param pool Пул потоков вычислений (nullptr - только последовательное суммирование)
+ * @param threshold Минимальная длина вектора в элементах для параллельной обработки
+ */
+void DataProcessor::setParallel(ThreadPool* pool, size_t threshold) {
+    this->pool = pool;
+    parallelThreshold = std::max<size_t>(threshold, 1);
+}
+
+/**
+ * @brief Вычисление среднего арифметического по накопителю
+ * @param acc Накопитель с суммой и количеством элементов
+ * @param logger Ссылка на журнал для записи ошибок
+ * @return Среднее арифметическое
+ * @details Деление суммы на количество элементов и проверка границ int32_t
+ * @warning При пустом накопителе возвращает 0 и записывает предупреждение в журнал
+ */
+int32_t DataProcessor::finalize(const Accumulator& acc, Logger& logger) {
+    Tracer::Span span(Tracer::Stage::Finalize);
+    if (acc.count() == 0) {
         logger.logError("Vector is empty", false);
         return 0;
     }
-    
-    int64_t sum = 0; //предотвращение промежуточного переполнения
-    for (int32_t val : vector) {
-        sum += val;
-    }
-    
-    int64_t avrg = sum / static_cast<int64_t>(vector.size());
+
+    int64_t avrg = acc.sum() / static_cast<int64_t>(acc.count());
     
     if (avrg > 2147483647) { // 2^(31-1)
+        if (stats) {
+            stats->add(Metrics::Counter::OverflowClamps);
+        }
         logger.logError("Overflow detected (upwards)", false);
         return 2147483647;
     }
     if (avrg < -2147483648) { // -2^31
+        if (stats) {
+            stats->add(Metrics::Counter::OverflowClamps);
+        }
         logger.logError("Overflow detected (downwards)", false);
         return -2147483648;
     }
     
     return static_cast<int32_t>(avrg);
 }
+
+/**
+ * @brief Получение названия используемого ядра суммирования
+ * @return Название ядра ("avx512", "avx2", "sse4.1" или "scalar")
+ */
+const char* DataProcessor::kernelName() {
+    return activeKernel->name;
+}
+
+/**
+ * @brief Получение списка ядер суммирования, поддерживаемых процессором
+ * @return Названия ядер в порядке убывания предпочтения
+ */
+std::vector<std::string> DataProcessor::availableKernels() {
+    std::vector<std::string> names;
+    for (const SumKernel& k : kernels) {
+        if (k.supported()) {
+            names.push_back(k.name);
+        }
+    }
+    return names;
+}
+
+/**
+ * @brief Принудительный выбор ядра суммирования
+ * @param name Название ядра
+ * @return true - ядро выбрано, false - ядро неизвестно или не поддерживается процессором
+ * @warning Не потокобезопасно: вызывается до запуска рабочих потоков
+ */
+bool DataProcessor::selectKernel(const std::string& name) {
+    for (const SumKernel& k : kernels) {
+        if (name == k.name && k.supported()) {
+            activeKernel = &k;
+            return true;
+        }
+    }
+    return false;
+}
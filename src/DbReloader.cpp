@@ -0,0 +1,156 @@
+/**
+ * @file DbReloader.cpp
+ * @brief Реализация класса DbReloader - фоновой перезагрузки базы пользователей
+ */
+
+#include "DbReloader.h"
+#include "UserDatabase.h"
+#include "Logger.h"
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+
+/**
+ * @brief Конструктор
+ * @param db База пользователей (должна быть загружена)
+ * @param logger Ссылка на журнал
+ */
+DbReloader::DbReloader(UserDatabase& db, Logger& logger)
+    : db(db), logger(logger), eventFd(-1), inotifyFd(-1), stopping(false), reloadCount(0), failureCount(0)
+{
+}
+
+/**
+ * @brief Деструктор
+ * @details Останавливает поток перезагрузки
+ */
+DbReloader::~DbReloader() {
+    stop();
+}
+
+/**
+ * @brief Запуск потока перезагрузки
+ * @param watch_file Перезагружать базу при изменении файла
+ * @return true - поток запущен,
+ *         false - не удалось создать дескрипторы событий
+ * @details Ошибка настройки inotify не мешает перезагрузке по запросу:
+ *          она записывается в журнал, и поток запускается без наблюдения
+ */
+bool DbReloader::start(bool watch_file) {
+    eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (eventFd == -1) {
+        logger.logError("DbReloader: eventfd failed: " + std::string(strerror(errno)), false);
+        return false;
+    }
+    if (watch_file) {
+        std::string path = db.path();
+        size_t slash = path.find_last_of('/');
+        std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+        fileName = slash == std::string::npos ? path : path.substr(slash + 1);
+        inotifyFd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+        if (inotifyFd == -1 || inotify_add_watch(inotifyFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) == -1) {
+            logger.logError("DbReloader: cannot watch " + dir + ": " + strerror(errno), false);
+            if (inotifyFd != -1) {
+                close(inotifyFd);
+                inotifyFd = -1;
+            }
+        } else {
+            logger.logInfo("DbReloader: watching " + path);
+        }
+    }
+    thread = std::thread(&DbReloader::run, this);
+    return true;
+}
+
+/**
+ * @brief Запрос перезагрузки базы
+ */
+void DbReloader::requestReload() {
+    uint64_t one = 1;
+    if (eventFd != -1 && write(eventFd, &one, sizeof(one)) == -1 && errno != EAGAIN) {
+        logger.logError("DbReloader: reload request failed: " + std::string(strerror(errno)), false);
+    }
+}
+
+/**
+ * @brief Остановка потока перезагрузки
+ */
+void DbReloader::stop() {
+    if (thread.joinable()) {
+        stopping.store(true);
+        requestReload();
+        thread.join();
+    }
+    if (inotifyFd != -1) {
+        close(inotifyFd);
+        inotifyFd = -1;
+    }
+    if (eventFd != -1) {
+        close(eventFd);
+        eventFd = -1;
+    }
+}
+
+/**
+ * @brief Тело потока перезагрузки
+ * @details Запрос через eventfd выполняется сразу, изменение файла - после паузы
+ *          RELOAD_DELAY_MS без новых событий, чтобы не загружать недописанный файл
+ */
+void DbReloader::run() {
+    bool pending = false;
+    alignas(inotify_event) char events[4096];
+    while (true) {
+        pollfd fds[2] = {{eventFd, POLLIN, 0}, {inotifyFd, POLLIN, 0}};
+        int rc = poll(fds, inotifyFd == -1 ? 1 : 2, pending ? RELOAD_DELAY_MS : -1);
+        if (rc == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            logger.logError("DbReloader: poll failed: " + std::string(strerror(errno)), false);
+            return;
+        }
+        if (rc == 0) {
+            pending = false;
+            reload();
+            continue;
+        }
+        if (fds[0].revents & POLLIN) {
+            uint64_t requests;
+            while (read(eventFd, &requests, sizeof(requests)) > 0) {
+            }
+            if (stopping.load()) {
+                return;
+            }
+            pending = false;
+            reload();
+        }
+        if (inotifyFd != -1 && (fds[1].revents & POLLIN)) {
+            ssize_t len;
+            while ((len = read(inotifyFd, events, sizeof(events))) > 0) {
+                for (ssize_t pos = 0; pos < len; ) {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(events + pos);
+                    if (event->len > 0 && fileName == event->name) {
+                        pending = true;
+                    }
+                    pos += sizeof(inotify_event) + event->len;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Перезагрузка базы с учетом результата
+ * @details Успешные и неудачные перезагрузки учитываются раздельно
+ */
+void DbReloader::reload() {
+    if (db.reload(logger)) {
+        reloadCount.fetch_add(1);
+    } else {
+        failureCount.fetch_add(1);
+    }
+}
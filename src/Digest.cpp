@@ -0,0 +1,157 @@
+/**
+ * @file Digest.cpp
+ * @brief Реализация хеш-функций аутентификации на основе Crypto++
+ */
+
+#include "Digest.h"
+#include <cryptopp/sha.h>
+
+namespace CPP = CryptoPP;
+
+namespace {
+
+/**
+ * @brief Значение шестнадцатеричной цифры
+ * @param c Символ
+ * @return Значение 0-15 или -1 для недопустимого символа
+ */
+inline int hexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief Хеш-функция на основе класса Crypto++
+ * @tparam Hash Класс хеш-функции Crypto++ (CryptoPP::SHA1, CryptoPP::SHA256)
+ */
+template <typename Hash>
+class CryptoDigest : public Digest {
+public:
+    void update(const void* data, size_t size) override {
+        hash.Update(static_cast<const CPP::byte*>(data), size);
+    }
+
+    void final(unsigned char* out) override {
+        hash.Final(out); // Final() возвращает объект в начальное состояние
+    }
+
+    size_t size() const override {
+        return Hash::DIGESTSIZE;
+    }
+
+    std::string provider() const override {
+        return hash.AlgorithmProvider();
+    }
+
+private:
+    Hash hash; ///< Объект Crypto++
+};
+
+}
+
+/**
+ * @brief Создание объекта хеш-функции
+ * @param algorithm Алгоритм
+ * @return Новый объект
+ */
+std::unique_ptr<Digest> Digest::create(Algorithm algorithm) {
+    if (algorithm == Algorithm::Sha256) {
+        return std::unique_ptr<Digest>(new CryptoDigest<CPP::SHA256>);
+    }
+    return std::unique_ptr<Digest>(new CryptoDigest<CPP::SHA1>);
+}
+
+/**
+ * @brief Разбор названия алгоритма
+ * @param name Название: "sha1" или "sha256"
+ * @param out_algorithm Алгоритм
+ * @return true - название известно
+ */
+bool Digest::parse(const std::string& name, Algorithm& out_algorithm) {
+    if (name == "sha1") {
+        out_algorithm = Algorithm::Sha1;
+        return true;
+    }
+    if (name == "sha256") {
+        out_algorithm = Algorithm::Sha256;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Получение названия алгоритма
+ * @param algorithm Алгоритм
+ * @return Название для журнала
+ */
+const char* Digest::name(Algorithm algorithm) {
+    return algorithm == Algorithm::Sha256 ? "SHA-256" : "SHA-1";
+}
+
+/**
+ * @brief Получение размера хеша алгоритма
+ * @param algorithm Алгоритм
+ * @return Размер хеша в байтах
+ */
+size_t Digest::size(Algorithm algorithm) {
+    return algorithm == Algorithm::Sha256 ? static_cast<size_t>(CPP::SHA256::DIGESTSIZE)
+                                          : static_cast<size_t>(CPP::SHA1::DIGESTSIZE);
+}
+
+/**
+ * @brief Декодирование hex-строки в байты
+ * @param hex Hex-строка длиной 2 * size
+ * @param out Буфер результата размером size
+ * @param size Количество байтов
+ * @return true - строка содержит только hex-символы
+ */
+bool Digest::decodeHex(const char* hex, unsigned char* out, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        int hi = hexValue(hex[2 * i]);
+        int lo = hexValue(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        out[i] = static_cast<unsigned char>((hi << 4) | lo);
+    }
+    return true;
+}
+
+/**
+ * @brief Кодирование байтов в hex-строку
+ * @param data Байты
+ * @param size Количество байтов
+ * @param out Буфер результата размером 2 * size
+ */
+void Digest::encodeHex(const unsigned char* data, size_t size, char* out) {
+    static const char digits[] = "0123456789ABCDEF";
+    for (size_t i = 0; i < size; ++i) {
+        out[2 * i] = digits[data[i] >> 4];
+        out[2 * i + 1] = digits[data[i] & 0x0F];
+    }
+}
+
+/**
+ * @brief Сравнение буферов за время, не зависящее от содержимого
+ * @param a Первый буфер
+ * @param b Второй буфер
+ * @param size Размер буферов
+ * @return true - буферы совпадают
+ * @details Просматриваются все байты, поэтому время сравнения не выдает длину
+ *          совпавшего префикса хеша
+ */
+bool Digest::equal(const unsigned char* a, const unsigned char* b, size_t size) {
+    volatile unsigned char diff = 0;
+    for (size_t i = 0; i < size; ++i) {
+        diff = diff | (a[i] ^ b[i]);
+    }
+    return diff == 0;
+}
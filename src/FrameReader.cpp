@@ -0,0 +1,42 @@
+/**
+ * @file FrameReader.cpp
+ * @brief Реализация класса FrameReader - разбора кадров протокола
+ */
+
+#include "FrameReader.h"
+
+/**
+ * @brief Извлечение текстовой строки
+ * @param line Строка без завершающего '\n' (память строки переиспользуется)
+ * @param max_len Максимальная длина строки
+ * @param partial Вернуть неполную строку, если в буфере есть данные
+ * @return true - строка извлечена, false - данных недостаточно
+ */
+bool FrameReader::nextLine(std::string& line, size_t max_len, bool partial) {
+    size_t len = input.find('\n', max_len);
+    size_t skip = 1;
+    if (len == RingBuffer::npos) {
+        if (input.size() < max_len && !(partial && input.size() > 0)) {
+            return false;
+        }
+        len = std::min(input.size(), max_len);
+        skip = 0;
+    }
+    line.resize(len);
+    input.read(&line[0], len);
+    input.consume(skip);
+    return true;
+}
+
+/**
+ * @brief Извлечение поля uint32_t
+ * @param value Значение поля
+ * @return true - поле извлечено, false - данных недостаточно
+ */
+bool FrameReader::nextU32(uint32_t& value) {
+    if (input.size() < sizeof(value)) {
+        return false;
+    }
+    input.read(&value, sizeof(value));
+    return true;
+}
@@ -4,19 +4,52 @@
  */
 
 #include "Interface.h"
+#include "Digest.h"
+#include "Logger.h"
+#include "TicketManager.h"
 #include <iostream>
 #include <stdexcept>
 
 /**
  * @brief Конструктор класса Interface
- * @details Инициализирует парсер командной строки опциями: help, file, log, port
+ * @details Инициализирует парсер командной строки опциями: help, file, log, port, io, workers, stream, huge-pages,
+ *          parallel-threshold, compute-threads, async-log, log-queue, log-overflow, log-level, log-format,
+ *          log-rotate-size, log-rotate-interval, log-keep, log-compress, pipeline,
+ *          watch-db, hash, tickets, ticket-lifetime, ticket-secret, auth-throttle, auth-throttle-window,
+ *          metrics-port, trace-file, trace-sample
  */
 Interface::Interface() : desc("Allowed options") {
     desc.add_options()
     ("help,h", "Show help")
     ("file,f", po::value<std::string>(&params.dbFile)->default_value("etc/vcalc.conf"), "User database file")
     ("log,l", po::value<std::string>(&params.logFile)->default_value("var/log/vcalc.log"), "Log file")
-    ("port,p", po::value<unsigned short>(&params.port)->default_value(33333), "Server port");
+    ("port,p", po::value<unsigned short>(&params.port)->default_value(33333), "Server port")
+    ("io,i", po::value<std::string>(&params.ioMode)->default_value("epoll"), "I/O mode: epoll, uring or blocking")
+    ("workers,w", po::value<unsigned>(&params.workers)->default_value(1), "Worker threads, each with its own SO_REUSEPORT socket (0 - one per CPU core)")
+    ("stream,s", po::bool_switch(&params.streaming), "Sum vectors while receiving instead of buffering them whole")
+    ("huge-pages", po::bool_switch(&params.hugePages), "Back large vector buffers with transparent huge pages")
+    ("pipeline", po::bool_switch(&params.pipeline), "Receive the next vector while the previous one is reduced on a helper thread and coalesce result sends (blocking I/O only)")
+    ("parallel-threshold", po::value<size_t>(&params.parallelThreshold)->default_value(4 * 1024 * 1024), "Vector length (elements) from which sums are computed in parallel (0 - never)")
+    ("compute-threads", po::value<unsigned>(&params.computeThreads)->default_value(0), "Threads for parallel sums, including the calling one (0 - one per CPU core)")
+    ("async-log", po::bool_switch(&params.asyncLog), "Write the log from a background thread through a lock-free queue")
+    ("log-queue", po::value<size_t>(&params.logQueue)->default_value(65536), "Async log queue capacity (records)")
+    ("log-overflow", po::value<std::string>(&params.logOverflow)->default_value("block"), "Async log queue overflow policy: block or drop")
+    ("log-level", po::value<std::string>(&params.logLevel)->default_value("info"), "Minimum log level: trace, debug, info, warning, error, critical or off")
+    ("log-format", po::value<std::string>(&params.logFormat)->default_value("text"), "Log file format: text or binary (decode with vcalc-logcat)")
+    ("log-rotate-size", po::value<uint64_t>(&params.logRotateSize)->default_value(0), "Rotate the log file before it grows past this size (bytes, 0 - never)")
+    ("log-rotate-interval", po::value<unsigned>(&params.logRotateInterval)->default_value(0), "Rotate the log file this often (seconds, 0 - never)")
+    ("log-keep", po::value<unsigned>(&params.logKeep)->default_value(5), "Rotated log files to keep")
+    ("log-compress", po::bool_switch(&params.logCompress), "Compress rotated log files with gzip in the background")
+    ("watch-db", po::bool_switch(&params.watchDb), "Reload the user database when its file changes (SIGHUP always reloads)")
+    ("hash", po::value<std::string>(&params.hash)->default_value("sha1"), "Authentication hash: sha1 or sha256")
+    ("tickets", po::bool_switch(&params.tickets), "Issue session resumption tickets after authentication")
+    ("ticket-lifetime", po::value<unsigned>(&params.ticketLifetime)->default_value(300), "Session ticket lifetime (seconds, at most 3600)")
+    ("ticket-secret", po::value<std::string>(&params.ticketSecret)->default_value(""), "File with the ticket signing secret shared by server processes (default - random per process)")
+    ("auth-throttle", po::value<unsigned>(&params.authThrottle)->default_value(0), "Failed authentications after which a client address, or a login from that address, is rejected (0 - no limit)")
+    ("auth-throttle-window", po::value<unsigned>(&params.authThrottleWindow)->default_value(60), "Half-life of failed authentication counters (seconds)")
+    ("metrics-port", po::value<unsigned short>(&params.metricsPort)->default_value(0), "Serve Prometheus metrics over HTTP on this port (0 - off)")
+    ("trace-file", po::value<std::string>(&params.traceFile)->default_value(""), "Record per-stage session spans and write them to this Chrome trace JSON file on SIGUSR1 and at exit (default - off)")
+    ("trace-sample", po::value<unsigned>(&params.traceSample)->default_value(1), "Trace every N-th session");
 }
 
 /**
@@ -24,7 +57,7 @@ Interface::Interface() : desc("Allowed options") {
  * @param argc Количество аргументов
  * @param argv Массив аргументов
  * @return true - успешный парсинг рабочих параметров,
- *         false - запрошена справка (help)
+ *         false - запрошена справка (help) или значение параметра недопустимо
  * @throw po::error при ошибках парсинга
  * @throw std::exception при других ошибках
  */
@@ -35,6 +68,60 @@ bool Interface::Parser(int argc, char** argv) {
             return false; //печать справки
         }
         po::notify(vm);
+        if (params.ioMode != "epoll" && params.ioMode != "uring" && params.ioMode != "blocking") {
+            throw po::error("invalid I/O mode '" + params.ioMode + "'");
+        }
+        if (params.pipeline && params.ioMode != "blocking") {
+            throw po::error("--pipeline requires --io blocking");
+        }
+        if (params.pipeline && params.streaming) {
+            throw po::error("--pipeline cannot be combined with --stream");
+        }
+        if (params.workers > MAX_WORKERS) {
+            throw po::error("too many workers (max " + std::to_string(MAX_WORKERS) + ")");
+        }
+        if (params.computeThreads > MAX_WORKERS) {
+            throw po::error("too many compute threads (max " + std::to_string(MAX_WORKERS) + ")");
+        }
+        if (params.logQueue == 0) {
+            throw po::error("log queue capacity must be positive");
+        }
+        if (params.logOverflow != "block" && params.logOverflow != "drop") {
+            throw po::error("invalid log overflow policy '" + params.logOverflow + "'");
+        }
+        Logger::Level log_level;
+        if (!Logger::parseLevel(params.logLevel, log_level)) {
+            throw po::error("invalid log level '" + params.logLevel + "'");
+        }
+        if (params.logFormat != "text" && params.logFormat != "binary") {
+            throw po::error("invalid log format '" + params.logFormat + "'");
+        }
+        if (params.logKeep == 0) {
+            throw po::error("number of kept log files must be positive");
+        }
+        if (params.ticketLifetime == 0) {
+            throw po::error("ticket lifetime must be positive");
+        }
+        if (params.ticketLifetime > TicketManager::KEY_ROTATION) {
+            throw po::error("ticket lifetime must not exceed the " + std::to_string(TicketManager::KEY_ROTATION) +
+                            " s key rotation period");
+        }
+        if (params.authThrottleWindow == 0) {
+            throw po::error("auth throttle window must be positive");
+        }
+        if (params.metricsPort != 0 && (params.metricsPort < 1024 || params.metricsPort > 49151)) {
+            throw po::error("metrics port out of range 1024-49151");
+        }
+        if (params.metricsPort != 0 && params.metricsPort == params.port) {
+            throw po::error("metrics port must differ from the server port");
+        }
+        if (params.traceSample == 0) {
+            throw po::error("trace sample period must be positive");
+        }
+        Digest::Algorithm algorithm;
+        if (!Digest::parse(params.hash, algorithm)) {
+            throw po::error("invalid hash algorithm '" + params.hash + "'");
+        }
     } catch (const std::exception& e) {
         std::cerr << "Error parsing arguments: " << e.what() << std::endl;
         return false;
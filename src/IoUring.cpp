@@ -0,0 +1,267 @@
+/**
+ * @file IoUring.cpp
+ * @brief Реализация класса IoUring - обертки над интерфейсом io_uring
+ */
+
+#include "IoUring.h"
+#include <system_error>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/socket.h>
+
+namespace {
+
+/**
+ * @brief Системный вызов io_uring_setup
+ */
+int sysSetup(unsigned entries, io_uring_params* p) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, p));
+}
+
+/**
+ * @brief Системный вызов io_uring_enter
+ */
+int sysEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+/**
+ * @brief Системный вызов io_uring_register
+ */
+int sysRegister(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+}
+
+/**
+ * @brief Создание кольца и регистрация буферов приема
+ * @param entries Размер очереди заявок
+ * @param buffer_count Количество буферов приема (степень двойки)
+ * @param buffer_size Размер одного буфера приема
+ * @throw std::system_error если ядро не поддерживает io_uring или кольца буферов
+ * @details Отображает кольца SQ/CQ и массив заявок в память процесса, затем выделяет
+ *          буферы приема и регистрирует их кольцом с номером группы 0
+ */
+IoUring::IoUring(unsigned entries, unsigned buffer_count, unsigned buffer_size)
+    : ringFd(-1), sqEntries(0), sqRing(MAP_FAILED), sqRingSize(0), cqRing(MAP_FAILED), cqRingSize(0),
+      sqes(static_cast<io_uring_sqe*>(MAP_FAILED)), sqHead(nullptr), sqTail(nullptr), sqMask(nullptr),
+      sqArray(nullptr), cqHead(nullptr), cqTail(nullptr), cqMask(nullptr), cqes(nullptr),
+      sqeTail(0), bufRing(static_cast<io_uring_buf*>(MAP_FAILED)), bufRingSize(0),
+      bufferMemory(static_cast<char*>(MAP_FAILED)), bufferCount(buffer_count), bufferSize(buffer_size), bufTail(0)
+{
+    io_uring_params params{};
+    params.flags = IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN;
+    ringFd = sysSetup(entries, &params);
+    if (ringFd == -1 && errno == EINVAL) {
+        params = io_uring_params{}; // старое ядро без дополнительных флагов
+        ringFd = sysSetup(entries, &params);
+    }
+    if (ringFd == -1) {
+        throw std::system_error(errno, std::generic_category(), "io_uring_setup failed");
+    }
+    sqEntries = params.sq_entries;
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+        sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+    }
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) {
+        int err = errno;
+        release();
+        throw std::system_error(err, std::generic_category(), "io_uring SQ ring mmap failed");
+    }
+    cqRing = single_mmap ? sqRing
+             : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+    if (cqRing == MAP_FAILED) {
+        int err = errno;
+        release();
+        throw std::system_error(err, std::generic_category(), "io_uring CQ ring mmap failed");
+    }
+    sqes = static_cast<io_uring_sqe*>(mmap(nullptr, params.sq_entries * sizeof(io_uring_sqe),
+                                           PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES));
+    if (sqes == MAP_FAILED) {
+        int err = errno;
+        release();
+        throw std::system_error(err, std::generic_category(), "io_uring SQE mmap failed");
+    }
+
+    char* sq = static_cast<char*>(sqRing);
+    sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    char* cq = static_cast<char*>(cqRing);
+    cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    sqeTail = *sqTail;
+
+    bufRingSize = buffer_count * sizeof(io_uring_buf);
+    bufRing = static_cast<io_uring_buf*>(mmap(nullptr, bufRingSize, PROT_READ | PROT_WRITE,
+                                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    bufferMemory = static_cast<char*>(mmap(nullptr, static_cast<size_t>(buffer_count) * buffer_size,
+                                           PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (bufRing == MAP_FAILED || bufferMemory == MAP_FAILED) {
+        int err = errno;
+        release();
+        throw std::system_error(err, std::generic_category(), "io_uring buffer allocation failed");
+    }
+
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<uint64_t>(bufRing);
+    reg.ring_entries = buffer_count;
+    reg.bgid = 0;
+    if (sysRegister(ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) == -1) {
+        int err = errno;
+        release();
+        throw std::system_error(err, std::generic_category(), "io_uring buffer ring registration failed");
+    }
+    for (unsigned bid = 0; bid < buffer_count; ++bid) {
+        recycle(bid);
+    }
+    publishBuffers();
+}
+
+/**
+ * @brief Деструктор
+ */
+IoUring::~IoUring() {
+    release();
+}
+
+/**
+ * @brief Освобождение ресурсов кольца
+ */
+void IoUring::release() {
+    if (bufferMemory != MAP_FAILED) {
+        munmap(bufferMemory, static_cast<size_t>(bufferCount) * bufferSize);
+        bufferMemory = static_cast<char*>(MAP_FAILED);
+    }
+    if (bufRing != MAP_FAILED) {
+        munmap(bufRing, bufRingSize);
+        bufRing = static_cast<io_uring_buf*>(MAP_FAILED);
+    }
+    if (sqes != MAP_FAILED) {
+        munmap(sqes, sqEntries * sizeof(io_uring_sqe));
+        sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    }
+    if (cqRing != MAP_FAILED && cqRing != sqRing) {
+        munmap(cqRing, cqRingSize);
+    }
+    cqRing = MAP_FAILED;
+    if (sqRing != MAP_FAILED) {
+        munmap(sqRing, sqRingSize);
+        sqRing = MAP_FAILED;
+    }
+    if (ringFd != -1) {
+        close(ringFd);
+        ringFd = -1;
+    }
+}
+
+/**
+ * @brief Получение свободной заявки
+ * @return Обнуленная заявка в очереди SQ
+ * @details Если очередь заполнена, накопленные заявки отправляются в ядро без ожидания
+ */
+io_uring_sqe* IoUring::nextSqe() {
+    unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    while (sqeTail - head >= sqEntries) {
+        __atomic_store_n(sqTail, sqeTail, __ATOMIC_RELEASE);
+        if (sysEnter(ringFd, sqeTail - head, 0, 0) == -1 && errno != EINTR && errno != EAGAIN) {
+            throw std::system_error(errno, std::generic_category(), "io_uring_enter failed");
+        }
+        head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    }
+    unsigned index = sqeTail & *sqMask;
+    io_uring_sqe* sqe = &sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqArray[index] = index;
+    ++sqeTail;
+    return sqe;
+}
+
+/**
+ * @brief Постановка многократного accept
+ * @param listen_sock Слушающий сокет
+ * @param user_data Метка завершений
+ * @details Одна заявка порождает завершение на каждое новое подключение
+ *          (флаг IORING_CQE_F_MORE, пока заявка активна)
+ */
+void IoUring::prepareAcceptMultishot(int listen_sock, uint64_t user_data) {
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listen_sock;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = user_data;
+}
+
+/**
+ * @brief Постановка приема в буфер из кольца предоставленных буферов
+ * @param sock Сокет клиента
+ * @param user_data Метка завершений
+ * @param multishot Многократный прием
+ * @details Номер выбранного ядром буфера возвращается в старших битах флагов завершения
+ */
+void IoUring::prepareRecv(int sock, uint64_t user_data, bool multishot) {
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = sock;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = 0;
+    sqe->ioprio = multishot ? IORING_RECV_MULTISHOT : 0;
+    sqe->user_data = user_data;
+}
+
+/**
+ * @brief Постановка отправки данных
+ * @param sock Сокет клиента
+ * @param data Данные (должны оставаться доступными до завершения)
+ * @param len Длина данных
+ * @param user_data Метка завершения
+ */
+void IoUring::prepareSend(int sock, const void* data, size_t len, uint64_t user_data) {
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = sock;
+    sqe->addr = reinterpret_cast<uint64_t>(data);
+    sqe->len = static_cast<uint32_t>(len);
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = user_data;
+}
+
+/**
+ * @brief Отправка накопленных заявок и ожидание хотя бы одного завершения
+ * @throw std::system_error при ошибке io_uring_enter
+ * @details Все заявки, накопленные за итерацию цикла, уходят в ядро одним системным вызовом
+ */
+void IoUring::submitAndWait() {
+    __atomic_store_n(sqTail, sqeTail, __ATOMIC_RELEASE);
+    unsigned to_submit = sqeTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    if (sysEnter(ringFd, to_submit, 1, IORING_ENTER_GETEVENTS) == -1 &&
+        errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+        throw std::system_error(errno, std::generic_category(), "io_uring_enter failed");
+    }
+}
+
+/**
+ * @brief Возврат буфера приема в кольцо
+ * @param bid Номер буфера
+ */
+void IoUring::recycle(unsigned bid) {
+    io_uring_buf& buf = bufRing[bufTail & (bufferCount - 1)];
+    buf.addr = reinterpret_cast<uint64_t>(bufferMemory + static_cast<size_t>(bid) * bufferSize);
+    buf.len = bufferSize;
+    buf.bid = static_cast<uint16_t>(bid);
+    ++bufTail;
+}
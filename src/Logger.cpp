@@ -8,6 +8,129 @@
 #include <chrono>
 #include <iomanip>
 #include <ctime>
+#include <cerrno>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <climits>
+
+namespace {
+
+const size_t WRITE_BATCH = 64; ///< Максимум записей, передаваемых в один вызов writev
+
+const char* levelNames[] = {"TRACE", "DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL", "OFF"};
+const char* levelOptions[] = {"trace", "debug", "info", "warning", "error", "critical", "off"};
+
+/**
+ * @brief Источник номеров объектов Logger
+ */
+std::atomic<uint64_t> nextLoggerId{1};
+
+/**
+ * @brief Шаблон сообщения из одного аргумента (logInfo(), logError())
+ */
+const std::string PLAIN_TEMPLATE(1, BinaryLog::PLACEHOLDER);
+
+/**
+ * @brief Шаблон сообщения фонового потока об отброшенных записях
+ */
+const std::string DROP_TEMPLATE = std::string(1, BinaryLog::PLACEHOLDER) + " log records dropped (queue full)";
+
+/**
+ * @brief Получение текущего времени для двоичных записей
+ * @return Наносекунды от эпохи Unix
+ */
+uint64_t nowNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Форматирование текущего времени
+ * @param buf Буфер не короче 20 байт
+ * @return Длина строки "YYYY-MM-DD HH:MM:SS"
+ * @details localtime_r вызывается не чаще раза в секунду для каждого потока:
+ *          строка предыдущей секунды хранится в кэше потока
+ */
+size_t formatTimestamp(char* buf) {
+    thread_local time_t cached_second = -1;
+    thread_local char cached_text[32];
+    thread_local size_t cached_len = 0;
+
+    time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    if (now != cached_second) {
+        std::tm tm{};
+        localtime_r(&now, &tm);
+        cached_len = std::strftime(cached_text, sizeof(cached_text), "%Y-%m-%d %H:%M:%S", &tm);
+        cached_second = now;
+    }
+    std::memcpy(buf, cached_text, cached_len);
+    return cached_len;
+}
+
+/**
+ * @brief Проверка окончания имени ротированного файла
+ * @param rest Часть имени после "PATH."
+ * @return true - "YYYYmmdd-HHMMSS", возможно с "-N" и ".gz"
+ */
+bool isRotatedSuffix(std::string rest) {
+    if (rest.size() > 3 && rest.compare(rest.size() - 3, 3, ".gz") == 0) {
+        rest.resize(rest.size() - 3);
+    }
+    if (rest.size() < 15 || rest[8] != '-') {
+        return false;
+    }
+    for (size_t i = 0; i < rest.size(); ++i) {
+        bool separator = i == 8 || i == 15;
+        if (separator ? rest[i] != '-' : !std::isdigit(static_cast<unsigned char>(rest[i]))) {
+            return false;
+        }
+    }
+    return rest.size() != 16;
+}
+
+}
+
+/**
+ * @brief Конструктор журнала
+ * @details Журнал создается в синхронном режиме с порогом INFO
+ */
+Logger::Logger()
+    : threshold(Level::Info), binary(false), id(nextLoggerId.fetch_add(1)), dropEvent(0), fd(-1), fileBytes(0),
+      rotateAt(0), rotateBytes(0), rotateSeconds(0), rotateKeep(0), rotateCompress(false), rotateSequence(0),
+      housekeepStopping(false),
+      ringMask(0), ringTail(0), ringHead(0), asyncMode(false), activeProducers(0),
+      overflow(OverflowPolicy::Block), dropped(0), stopping(false), writerSleeping(false)
+{
+}
+
+/**
+ * @brief Деструктор
+ * @details Останавливает асинхронный режим, дописывая все накопленные записи,
+ *          дожидается обслуживания уже ротированных файлов и закрывает файл журнала
+ */
+Logger::~Logger() {
+    stop();
+    {
+        std::lock_guard<std::mutex> lock(housekeepMutex);
+        housekeepStopping = true;
+    }
+    housekeepWake.notify_one();
+    if (housekeeper.joinable()) {
+        housekeeper.join();
+    }
+    if (fd != -1) {
+        close(fd);
+    }
+}
 
 /**
  * @brief Инициализация журнала с указанием пути к файлу журнала
@@ -18,53 +141,748 @@ void Logger::init(const std::string& log_path) {
 }
 
 /**
- * @brief Запись сообщения об ошибке в журнал
- * @param message Текст сообщения об ошибке
- * @param isCritical Флаг критичности ошибки
- * @details Формат записи: "YYYY-MM-DD HH:MM:SS; УРОВЕНЬ; СООБЩЕНИЕ"
+ * @brief Настройка ротации файла журнала
+ * @param max_bytes Размер файла, при превышении которого он ротируется (0 - без ограничения)
+ * @param interval_seconds Период ротации в секундах (0 - без ротации по времени)
+ * @param keep Количество хранимых ротированных файлов
+ * @param compress Сжимать ротированные файлы gzip в фоновом потоке
+ * @details Проверка выполняется перед каждой записью: файл ротируется, если
+ *          запись вывела бы его за max_bytes или истек период с открытия файла.
+ *          Пустой файл не ротируется. При включенной ротации запускается поток
+ *          обслуживания ротированных файлов
  */
-void Logger::logError(const std::string& message, bool isCritical) {
-    std::string level;
-    if (isCritical) {
-        level = "CRITICAL";
-    } else {
-        level = "ERROR";
+void Logger::setRotation(uint64_t max_bytes, unsigned interval_seconds, unsigned keep, bool compress) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    rotateBytes = max_bytes;
+    rotateSeconds = interval_seconds;
+    rotateKeep = keep;
+    rotateCompress = compress;
+    rotateAt = fd != -1 && interval_seconds != 0 ? time(nullptr) + interval_seconds : 0;
+    if ((max_bytes != 0 || interval_seconds != 0) && !housekeeper.joinable()) {
+        housekeeper = std::thread(&Logger::housekeepLoop, this);
+    }
+}
+
+/**
+ * @brief Включение асинхронного режима
+ * @param capacity Емкость очереди записей (округляется до степени двойки)
+ * @param policy Поведение при переполнении очереди
+ * @return true - режим включен, false - не удалось открыть файл журнала
+ * @details Открывает файл журнала на все время работы и запускает фоновый поток записи.
+ *          В двоичном формате заранее объявляет шаблон сообщения об отброшенных
+ *          записях: фоновый поток не может ставить записи в свою же очередь
+ */
+bool Logger::startAsync(size_t capacity, OverflowPolicy policy) {
+    if (asyncMode.load()) {
+        return true;
+    }
+    if (binary.load()) {
+        dropEvent = templateId(DROP_TEMPLATE);
+    }
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        bool started;
+        if (!prepareFile(0, started)) {
+            return false;
+        }
+    }
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    ring.reset(new Record[size]);
+    for (size_t i = 0; i < size; ++i) {
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    ringMask = size - 1;
+    ringTail.store(0, std::memory_order_relaxed);
+    ringHead = 0;
+    overflow = policy;
+    dropped.store(0, std::memory_order_relaxed);
+    stopping.store(false);
+    writer = std::thread(&Logger::writerLoop, this);
+    asyncMode.store(true, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Выключение асинхронного режима
+ * @details Новые записи с этого момента выполняются синхронно. После выхода
+ *          производителей, уже начавших запись в очередь, фоновый поток дописывает
+ *          все записи, сбрасывает файл на диск и закрывает его
+ */
+void Logger::stop() {
+    if (!asyncMode.exchange(false)) {
+        return;
+    }
+    while (activeProducers.load() != 0) {
+        std::this_thread::yield();
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping.store(true);
+    }
+    wakeUp.notify_one();
+    writer.join();
+}
+
+/**
+ * @brief Запись строки журнала
+ * @param level Уровень сообщения
+ * @param message Текст сообщения
+ * @details Формат записи: "YYYY-MM-DD HH:MM:SS; УРОВЕНЬ; СООБЩЕНИЕ".
+ *          В асинхронном режиме строка помещается в очередь, иначе дописывается
+ *          в открытый файл одним вызовом writev под мьютексом, поэтому строки
+ *          из разных потоков не перемешиваются
+ */
+void Logger::write(const char* level, const std::string& message) {
+    activeProducers.fetch_add(1);
+    if (asyncMode.load()) {
+        enqueue(level, message);
+        activeProducers.fetch_sub(1);
+        return;
+    }
+    activeProducers.fetch_sub(1);
+
+    char timestamp[32];
+    size_t ts_len = formatTimestamp(timestamp);
+
+    iovec iov[] = {
+        {timestamp, ts_len},
+        {const_cast<char*>("; "), 2},
+        {const_cast<char*>(level), std::strlen(level)},
+        {const_cast<char*>("; "), 2},
+        {const_cast<char*>(message.data()), message.size()},
+        {const_cast<char*>("\n"), 1}
+    };
+    std::lock_guard<std::mutex> lock(writeMutex);
+    appendFile(iov, 6);
+}
+
+/**
+ * @brief Помещение записи в очередь асинхронного журнала
+ * @param level Уровень сообщения
+ * @param message Текст сообщения
+ * @details Строка форматируется прямо в память ячейки, которая переиспользуется,
+ *          поэтому после прогрева запись не выделяет память
+ */
+void Logger::enqueue(const char* level, const std::string& message) {
+    size_t pos;
+    Record* record = claim(pos);
+    if (record == nullptr) {
+        return;
+    }
+
+    char timestamp[32];
+    size_t ts_len = formatTimestamp(timestamp);
+    std::string& line = record->line;
+    line.clear();
+    line.append(timestamp, ts_len);
+    line.append("; ");
+    line.append(level);
+    line.append("; ");
+    line.append(message);
+    line.push_back('\n');
+    publish(record, pos);
+}
+
+/**
+ * @brief Занятие ячейки очереди асинхронного журнала
+ * @param pos Позиция занятой ячейки
+ * @return Ячейка или nullptr, если запись отброшена при переполнении
+ * @details Позиция в очереди занимается сравнением с обменом (CAS) без блокировок.
+ *          При заполненной очереди запись либо ожидает места, либо отбрасывается
+ *          (OverflowPolicy)
+ */
+Logger::Record* Logger::claim(size_t& pos) {
+    Record* record = nullptr;
+    pos = ringTail.load(std::memory_order_relaxed);
+    while (true) {
+        record = &ring[pos & ringMask];
+        size_t seq = record->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (ringTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            if (overflow == OverflowPolicy::Drop) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            if (writerSleeping.load()) {
+                std::lock_guard<std::mutex> lock(wakeMutex);
+                wakeUp.notify_one();
+            }
+            std::this_thread::yield();
+            pos = ringTail.load(std::memory_order_relaxed);
+        } else {
+            pos = ringTail.load(std::memory_order_relaxed);
+        }
+    }
+    return record;
+}
+
+/**
+ * @brief Публикация заполненной ячейки для фонового потока
+ * @param record Ячейка
+ * @param pos Позиция ячейки
+ */
+void Logger::publish(Record* record, size_t pos) {
+    record->sequence.store(pos + 1, std::memory_order_release);
+
+    if (writerSleeping.load()) {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wakeUp.notify_one();
+    }
+}
+
+/**
+ * @brief Тело фонового потока записи
+ * @details Записывает готовые записи пачками, при пустой очереди засыпает до
+ *          оповещения производителя. Сообщает в журнал о записях, отброшенных
+ *          при переполнении. Без записей проверяет ротацию по времени.
+ *          При остановке дописывает очередь, выполняет fsync и закрывает файл
+ */
+void Logger::writerLoop() {
+    uint64_t reported_drops = 0;
+    while (true) {
+        size_t written = drainBatch();
+
+        uint64_t drops = dropped.load(std::memory_order_relaxed);
+        if (drops != reported_drops) {
+            std::string line;
+            if (binary.load()) {
+                std::string body;
+                BinaryLog::appendValue(body, BinaryLog::ArgType::Uint, drops - reported_drops);
+                BinaryLog::appendHeader(line, BinaryLog::Kind::Event, static_cast<uint8_t>(Level::Error), dropEvent,
+                                        nowNanoseconds(), static_cast<uint32_t>(body.size()));
+                line += body;
+            } else {
+                char timestamp[32];
+                size_t ts_len = formatTimestamp(timestamp);
+                line.assign(timestamp, ts_len);
+                line += "; ERROR; " + std::to_string(drops - reported_drops) + " log records dropped (queue full)\n";
+            }
+            iovec iov{const_cast<char*>(line.data()), line.size()};
+            std::lock_guard<std::mutex> lock(writeMutex);
+            appendFile(&iov, 1);
+            reported_drops = drops;
+        }
+        if (written > 0) {
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(writeMutex);
+            bool started;
+            prepareFile(0, started);
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        writerSleeping.store(true);
+        const Record& next = ring[ringHead & ringMask];
+        bool ready = next.sequence.load(std::memory_order_acquire) == ringHead + 1;
+        if (!ready && stopping.load()) {
+            writerSleeping.store(false);
+            break;
+        }
+        if (!ready) {
+            wakeUp.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        writerSleeping.store(false);
+    }
+
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (fd == -1) {
+        return;
+    }
+    if (fsync(fd) == -1) {
+        std::cerr << "LOGGER ERROR: fsync failed: " << strerror(errno) << std::endl;
+    }
+    close(fd);
+    fd = -1;
+}
+
+/**
+ * @brief Запись пачки готовых записей из очереди
+ * @return Количество записанных записей
+ * @details Строки передаются в writev прямо из ячеек очереди; ячейки освобождаются
+ *          для производителей только после записи. Ротация выполняется здесь же,
+ *          в фоновом потоке, поэтому производители ее не ожидают
+ */
+size_t Logger::drainBatch() {
+    iovec iov[WRITE_BATCH];
+    size_t count = 0;
+    while (count < WRITE_BATCH) {
+        Record& record = ring[(ringHead + count) & ringMask];
+        if (record.sequence.load(std::memory_order_acquire) != ringHead + count + 1) {
+            break;
+        }
+        iov[count].iov_base = const_cast<char*>(record.line.data());
+        iov[count].iov_len = record.line.size();
+        ++count;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        appendFile(iov, static_cast<int>(count));
+    }
+    for (size_t i = 0; i < count; ++i) {
+        ring[ringHead & ringMask].sequence.store(ringHead + ringMask + 1, std::memory_order_release);
+        ++ringHead;
+    }
+    return count;
+}
+
+/**
+ * @brief Запись данных в файл журнала с учетом частичной записи
+ * @param file Дескриптор файла
+ * @param iov Массив фрагментов (изменяется при частичной записи)
+ * @param count Количество фрагментов
+ */
+void Logger::writeAll(int file, iovec* iov, int count) {
+    while (count > 0) {
+        ssize_t rc = writev(file, iov, count);
+        if (rc == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "LOGGER ERROR: Cannot write log to " << logPath << ": " << strerror(errno) << std::endl;
+            return;
+        }
+        size_t left = static_cast<size_t>(rc);
+        while (count > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+            iov->iov_len -= left;
+        }
+    }
+}
+
+/**
+ * @brief Разбор названия уровня
+ * @param name Название: "trace", "debug", "info", "warning", "error", "critical" или "off"
+ * @param level Результат разбора
+ * @return true - название распознано
+ */
+bool Logger::parseLevel(const std::string& name, Level& level) {
+    for (size_t i = 0; i <= static_cast<size_t>(Level::Off); ++i) {
+        if (name == levelOptions[i]) {
+            level = static_cast<Level>(i);
+            return true;
+        }
     }
+    return false;
+}
+
+/**
+ * @brief Получение названия уровня в записи журнала
+ * @param level Уровень
+ * @return "TRACE", "DEBUG", "INFO", "WARNING", "ERROR" или "CRITICAL"
+ */
+const char* Logger::levelName(Level level) {
+    return levelNames[static_cast<size_t>(level)];
+}
 
-    std::ofstream file(logPath, std::ios::app);
-    if (file.is_open()) {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        file << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S")
-             << "; " << level << "; " << message << std::endl;
-        file.flush();
-        file.close();
+/**
+ * @brief Запись сообщения, прошедшего порог
+ * @param level Уровень сообщения
+ * @param message Текст сообщения
+ * @details Формат записи: "YYYY-MM-DD HH:MM:SS; УРОВЕНЬ; СООБЩЕНИЕ".
+ *          Ошибки и критические ошибки дублируются в stderr
+ */
+void Logger::emit(Level level, const std::string& message) {
+    if (binary.load(std::memory_order_relaxed)) {
+        std::string& body = binaryBuffer();
+        body.clear();
+        BinaryLog::appendString(body, message);
+        writeEvent(level, templateId(PLAIN_TEMPLATE), body);
     } else {
-        std::cerr << "LOGGER ERROR: Cannot write log to " << logPath << std::endl;
+        write(levelName(level), message);
     }
+    echo(level, message);
+}
 
-    if (isCritical) {
+/**
+ * @brief Дублирование ошибки в stderr
+ * @param level Уровень сообщения (ниже ERROR не выводится)
+ * @param message Текст сообщения
+ */
+void Logger::echo(Level level, const std::string& message) {
+    if (level < Level::Error) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(stderrMutex);
+    if (level == Level::Critical) {
         std::cerr << "CRITICAL ERROR: " << message << std::endl;
     } else {
         std::cerr << "ERROR: " << message << std::endl;
     }
 }
 
+/**
+ * @brief Запись сообщения об ошибке в журнал
+ * @param message Текст сообщения об ошибке
+ * @param isCritical Флаг критичности ошибки
+ * @details Формат записи: "YYYY-MM-DD HH:MM:SS; УРОВЕНЬ; СООБЩЕНИЕ"
+ */
+void Logger::logError(const std::string& message, bool isCritical) {
+    Level level = isCritical ? Level::Critical : Level::Error;
+    if (enabled(level)) {
+        emit(level, message);
+    }
+}
+
 /**
  * @brief Запись информационного сообщения в журнал
  * @param message Текст информационного сообщения
  * @details Формат записи: "YYYY-MM-DD HH:MM:SS; INFO; СООБЩЕНИЕ"
  */
 void Logger::logInfo(const std::string& message) {
-    std::ofstream file(logPath, std::ios::app);
-    if (file.is_open()) {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        file << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S")
-             << "; INFO; " << message << std::endl;
-        file.flush();
-        file.close();
-    } else {
+    if (enabled(Level::Info)) {
+        emit(Level::Info, message);
+    }
+}
+
+/**
+ * @brief Получение номера шаблона
+ * @param text Текст шаблона
+ * @return Номер шаблона (с единицы)
+ * @details Номера кэшируются в thread_local, поэтому таблица под мьютексом
+ *          используется только при первой встрече шаблона потоком. Новый шаблон
+ *          записывается в журнал записью Template
+ */
+uint32_t Logger::templateId(const std::string& text) {
+    static thread_local uint64_t cached_owner = 0;
+    static thread_local std::unordered_map<std::string, uint32_t> cache;
+    if (cached_owner != id) {
+        cache.clear();
+        cached_owner = id;
+    }
+    auto cached = cache.find(text);
+    if (cached != cache.end()) {
+        return cached->second;
+    }
+
+    uint32_t event;
+    bool created;
+    {
+        std::lock_guard<std::mutex> lock(templateMutex);
+        auto result = templates.emplace(text, static_cast<uint32_t>(templateTexts.size() + 1));
+        event = result.first->second;
+        created = result.second;
+        if (created) {
+            templateTexts.push_back(text);
+        }
+    }
+    if (created) {
+        std::string record;
+        BinaryLog::appendHeader(record, BinaryLog::Kind::Template, 0, event, 0, static_cast<uint32_t>(text.size()));
+        record += text;
+        writeRecord(record);
+    }
+    cache.emplace(text, event);
+    return event;
+}
+
+/**
+ * @brief Запись двоичного события
+ * @param level Уровень
+ * @param event Номер шаблона
+ * @param body Аргументы
+ */
+void Logger::writeEvent(Level level, uint32_t event, const std::string& body) {
+    static thread_local std::string record;
+    record.clear();
+    BinaryLog::appendHeader(record, BinaryLog::Kind::Event, static_cast<uint8_t>(level), event, nowNanoseconds(),
+                            static_cast<uint32_t>(body.size()));
+    record += body;
+    writeRecord(record);
+}
+
+/**
+ * @brief Запись готовой двоичной записи
+ * @param bytes Заголовок и тело записи
+ * @details В асинхронном режиме запись копируется в ячейку очереди, иначе
+ *          дописывается в файл под мьютексом. Открытие файла начинает сегмент;
+ *          объявление шаблона, уже вошедшего в новый сегмент, не повторяется
+ */
+void Logger::writeRecord(const std::string& bytes) {
+    activeProducers.fetch_add(1);
+    if (asyncMode.load()) {
+        size_t pos;
+        if (Record* record = claim(pos)) {
+            record->line.assign(bytes);
+            publish(record, pos);
+        }
+        activeProducers.fetch_sub(1);
+        return;
+    }
+    activeProducers.fetch_sub(1);
+
+    iovec iov{const_cast<char*>(bytes.data()), bytes.size()};
+    std::lock_guard<std::mutex> lock(writeMutex);
+    appendFile(&iov, 1, bytes[0] == static_cast<char>(BinaryLog::Kind::Template));
+}
+
+/**
+ * @brief Начало сегмента двоичного журнала
+ * @param file Дескриптор файла журнала
+ * @details Записывает запись Segment и все известные шаблоны, поэтому сегмент
+ *          разбирается независимо от предыдущих; вызывается под writeMutex.
+ *          Длина сегмента не входит в fileBytes: файл без записей не ротируется
+ */
+void Logger::startSegment(int file) {
+    std::string records;
+    BinaryLog::appendHeader(records, BinaryLog::Kind::Segment, 0, 0, nowNanoseconds(), sizeof(BinaryLog::MAGIC));
+    records.append(BinaryLog::MAGIC, sizeof(BinaryLog::MAGIC));
+    {
+        std::lock_guard<std::mutex> lock(templateMutex);
+        for (size_t i = 0; i < templateTexts.size(); ++i) {
+            const std::string& text = templateTexts[i];
+            BinaryLog::appendHeader(records, BinaryLog::Kind::Template, 0, static_cast<uint32_t>(i + 1), 0,
+                                    static_cast<uint32_t>(text.size()));
+            records += text;
+        }
+    }
+    iovec iov{const_cast<char*>(records.data()), records.size()};
+    writeAll(file, &iov, 1);
+}
+
+/**
+ * @brief Запись фрагментов в файл журнала с проверкой ротации
+ * @param iov Массив фрагментов (изменяется при частичной записи)
+ * @param count Количество фрагментов
+ * @param declaration Запись объявляет шаблон: в только что открытый файл она не
+ *                    пишется, так как шаблон уже вошел в новый сегмент
+ * @details Вызывается под writeMutex
+ */
+void Logger::appendFile(iovec* iov, int count, bool declaration) {
+    size_t length = 0;
+    for (int i = 0; i < count; ++i) {
+        length += iov[i].iov_len;
+    }
+    bool started;
+    if (!prepareFile(length, started) || (started && declaration)) {
+        return;
+    }
+    writeAll(fd, iov, count);
+    fileBytes += length;
+}
+
+/**
+ * @brief Подготовка файла к записи
+ * @param incoming Длина дописываемых данных
+ * @param started Результат: открыт новый файл (в двоичном формате - начат сегмент)
+ * @return true - файл открыт
+ * @details Открывает файл при первой записи. Открытый непустой файл ротируется,
+ *          если запись вывела бы его за rotateBytes или наступило время rotateAt;
+ *          вызывается под writeMutex
+ */
+bool Logger::prepareFile(size_t incoming, bool& started) {
+    started = false;
+    if (fd == -1) {
+        started = openFile();
+        return started;
+    }
+    if (fileBytes == 0) {
+        return true;
+    }
+    bool by_size = rotateBytes != 0 && fileBytes + incoming > rotateBytes;
+    bool by_time = rotateAt != 0 && time(nullptr) >= rotateAt;
+    if (by_size || by_time) {
+        started = rotate();
+    }
+    return true;
+}
+
+/**
+ * @brief Открытие файла журнала
+ * @return true - файл открыт
+ * @details При ошибке fd не изменяется. В двоичном формате новый файл начинается
+ *          с сегмента
+ */
+bool Logger::openFile() {
+    int file = open(logPath.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (file == -1) {
         std::cerr << "LOGGER ERROR: Cannot write log to " << logPath << std::endl;
+        return false;
+    }
+    struct stat st;
+    fd = file;
+    fileBytes = fstat(file, &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+    rotateAt = rotateSeconds != 0 ? time(nullptr) + rotateSeconds : 0;
+    if (binary.load(std::memory_order_relaxed)) {
+        startSegment(file);
+    }
+    return true;
+}
+
+/**
+ * @brief Ротация файла журнала
+ * @return true - открыт новый файл
+ * @details Файл переименовывается в PATH.YYYYmmdd-HHMMSS (с суффиксом -N при
+ *          повторной ротации в ту же секунду), затем открывается новый PATH, и только
+ *          после этого закрывается прежний дескриптор: записи не теряются и при ошибке
+ *          открытия продолжают идти в прежний файл. Файл, удаленный извне, просто
+ *          открывается заново. Переименование не заменяет существующий файл, поэтому
+ *          каталог не просматривается: при совпадении имени увеличивается суффикс.
+ *          Ротированный файл передается потоку обслуживания; вызывается под writeMutex
+ */
+bool Logger::rotate() {
+    time_t now = time(nullptr);
+    std::tm tm{};
+    localtime_r(&now, &tm);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+    if (rotateStamp == stamp) {
+        ++rotateSequence;
+    } else {
+        rotateStamp = stamp;
+        rotateSequence = 0;
+    }
+    std::string rotated;
+    int error;
+    while (true) {
+        rotated = logPath + "." + rotateStamp;
+        if (rotateSequence != 0) {
+            rotated += "-" + std::to_string(rotateSequence);
+        }
+        error = renameat2(AT_FDCWD, logPath.c_str(), AT_FDCWD, rotated.c_str(), RENAME_NOREPLACE) == 0 ? 0 : errno;
+        if (error == EINVAL) { // файловая система без RENAME_NOREPLACE
+            error = rename(logPath.c_str(), rotated.c_str()) == 0 ? 0 : errno;
+        }
+        if (error != EEXIST) {
+            break;
+        }
+        ++rotateSequence;
+    }
+
+    int previous = fd;
+    if (error != 0 && error != ENOENT) {
+        std::cerr << "LOGGER ERROR: Cannot rotate " << logPath << ": " << strerror(error) << std::endl;
+    } else if (openFile()) {
+        close(previous);
+        if (error == 0) {
+            {
+                std::lock_guard<std::mutex> lock(housekeepMutex);
+                rotatedQueue.push_back(rotated);
+            }
+            housekeepWake.notify_one();
+        }
+        return true;
+    }
+    fileBytes = 0;
+    rotateAt = rotateSeconds != 0 ? now + rotateSeconds : 0;
+    return false;
+}
+
+/**
+ * @brief Удаление ротированных файлов сверх rotateKeep
+ * @details Ротированные файлы - PATH.YYYYmmdd-HHMMSS[-N][.gz] в каталоге журнала.
+ *          Файл и его сжатая копия считаются одним файлом; сохраняются rotateKeep
+ *          файлов с наибольшим временем изменения. Вызывается потоком обслуживания
+ */
+void Logger::removeRotated() {
+    size_t slash = logPath.rfind('/');
+    std::string dir = slash == std::string::npos ? std::string() : logPath.substr(0, slash + 1);
+    std::string prefix = logPath.substr(dir.size()) + ".";
+    DIR* handle = opendir(dir.empty() ? "." : dir.c_str());
+    if (handle == nullptr) {
+        return;
+    }
+    std::map<std::string, int64_t> newest;
+    while (dirent* entry = readdir(handle)) {
+        std::string name = entry->d_name;
+        if (name.compare(0, prefix.size(), prefix) != 0 || !isRotatedSuffix(name.substr(prefix.size()))) {
+            continue;
+        }
+        struct stat st;
+        if (stat((dir + name).c_str(), &st) != 0) {
+            continue;
+        }
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, ".gz") == 0) {
+            name.resize(name.size() - 3);
+        }
+        int64_t mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+        auto result = newest.emplace(name, mtime);
+        if (!result.second && result.first->second < mtime) {
+            result.first->second = mtime;
+        }
+    }
+    closedir(handle);
+
+    std::vector<std::pair<int64_t, std::string>> files;
+    for (const auto& file : newest) {
+        files.emplace_back(file.second, file.first);
+    }
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a > b; });
+    for (size_t i = rotateKeep; i < files.size(); ++i) {
+        std::string path = dir + files[i].second;
+        unlink(path.c_str());
+        unlink((path + ".gz").c_str());
+    }
+}
+
+/**
+ * @brief Сжатие ротированного файла
+ * @param path Путь к файлу
+ * @details Файл сжимается процессом "gzip -f"; дочерний процесс получает пустую
+ *          маску сигналов
+ */
+void Logger::compressFile(const std::string& path) {
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    sigset_t none;
+    sigemptyset(&none);
+    posix_spawnattr_setsigmask(&attr, &none);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK);
+    char* argv[] = {const_cast<char*>("gzip"), const_cast<char*>("-f"), const_cast<char*>("--"),
+                    const_cast<char*>(path.c_str()), nullptr};
+    pid_t pid;
+    int rc = posix_spawnp(&pid, "gzip", nullptr, &attr, argv, environ);
+    posix_spawnattr_destroy(&attr);
+    if (rc != 0) {
+        std::cerr << "LOGGER ERROR: Cannot run gzip: " << strerror(rc) << std::endl;
+        return;
+    }
+    int status = 0;
+    while (waitpid(pid, &status, 0) == -1 && errno == EINTR) {
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::cerr << "LOGGER ERROR: Cannot compress " << path << std::endl;
+    }
+}
+
+/**
+ * @brief Тело потока обслуживания ротированных файлов
+ * @details Для каждого ротированного файла из очереди по порядку: сжатие (если
+ *          включено), затем удаление файлов сверх rotateKeep. Оба шага выполняет один
+ *          поток, поэтому удаление не затрагивает сжимаемый файл, а файл, уже удаленный
+ *          по ограничению числа файлов, не сжимается. При остановке дообслуживает очередь
+ */
+void Logger::housekeepLoop() {
+    std::unique_lock<std::mutex> lock(housekeepMutex);
+    while (true) {
+        housekeepWake.wait(lock, [this] { return housekeepStopping || !rotatedQueue.empty(); });
+        if (rotatedQueue.empty()) {
+            return;
+        }
+        std::string path = std::move(rotatedQueue.front());
+        rotatedQueue.pop_front();
+        lock.unlock();
+
+        if (rotateCompress && access(path.c_str(), F_OK) == 0) {
+            compressFile(path);
+        }
+        removeRotated();
+        lock.lock();
     }
 }
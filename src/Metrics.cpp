@@ -0,0 +1,356 @@
+/**
+ * @file Metrics.cpp
+ * @brief Реализация класса Metrics - счетчиков и гистограмм задержек сервера
+ */
+
+#include "Metrics.h"
+#include <chrono>
+#include <cstdio>
+#include <utility>
+
+namespace {
+
+/**
+ * @brief Источник номеров объектов Metrics
+ * @details Номера не повторяются, поэтому кэш потока, оставшийся от удаленного
+ *          объекта, никогда не совпадет с новым
+ */
+std::atomic<uint64_t> nextMetricsId{1};
+
+/**
+ * @brief Увеличение счетчика потоком-владельцем
+ * @param cell Счетчик блока потока
+ * @param value Приращение
+ * @details Счетчик пишет только один поток, поэтому достаточно load и store:
+ *          атомарность нужна лишь для согласованного чтения потоком экспорта
+ */
+inline void bump(std::atomic<uint64_t>& cell, uint64_t value) {
+    cell.store(cell.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Описание счетчика для экспорта
+ */
+struct CounterInfo {
+    const char* name; ///< Имя метрики
+    const char* help; ///< Описание
+};
+
+const CounterInfo counterInfo[] = {
+    {"vcalc_connections_accepted_total", "Client connections accepted"},
+    {"vcalc_connections_closed_total", "Client connections closed"},
+    {"vcalc_auth_successes_total", "Successful authentications"},
+    {"vcalc_auth_failures_total", "Failed authentications"},
+    {"vcalc_vectors_processed_total", "Vectors averaged"},
+    {"vcalc_bytes_processed_total", "Vector payload bytes averaged"},
+    {"vcalc_overflow_clamps_total", "Averages clamped to the int32_t range"},
+};
+
+const CounterInfo latencyInfo[] = {
+    {"vcalc_auth_duration_seconds", "Authentication check latency"},
+    {"vcalc_vector_receive_duration_seconds", "Time from vector length to the last payload byte"},
+    {"vcalc_compute_duration_seconds", "Average computation latency"},
+};
+
+const char* latencyLabel[] = {"auth", "vector_receive", "compute"};
+
+const unsigned EXPORT_MIN_EXPONENT = 10; ///< Наименьшая граница le при экспорте: 2^10 нс (около 1 мкс)
+
+/**
+ * @brief Добавление строки с заголовком метрики
+ * @param out Текст экспорта
+ * @param name Имя метрики
+ * @param help Описание
+ * @param type Тип Prometheus
+ */
+void header(std::string& out, const char* name, const char* help, const char* type) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+/**
+ * @brief Форматирование числа для экспорта
+ * @param value Значение
+ * @return Строка в формате %.9g
+ */
+std::string number(double value) {
+    char buf[32];
+    std::snprintf(buf, sizeof buf, "%.9g", value);
+    return buf;
+}
+
+}
+
+/**
+ * @brief Счетчики одного потока
+ * @details Выравнивание по строке кэша исключает ложное разделение
+ *          с блоками соседних потоков
+ */
+struct alignas(64) Metrics::Shard {
+    /**
+     * @brief Гистограмма задержек одного потока
+     */
+    struct alignas(64) Latencies {
+        std::atomic<uint64_t> buckets[BUCKETS]; ///< Количество значений в интервалах
+        std::atomic<uint64_t> count; ///< Количество значений
+        std::atomic<uint64_t> sum; ///< Сумма значений, нс
+    };
+
+    std::atomic<uint64_t> counters[static_cast<size_t>(Counter::Count)]; ///< Счетчики событий
+    Latencies latencies[static_cast<size_t>(Latency::Count)]; ///< Гистограммы задержек
+};
+
+/**
+ * @brief Конструктор
+ */
+Metrics::Metrics() : id(nextMetricsId.fetch_add(1)) {
+}
+
+/**
+ * @brief Деструктор
+ */
+Metrics::~Metrics() = default;
+
+/**
+ * @brief Получение текущего времени для измерения задержек
+ * @return Наносекунды монотонных часов
+ */
+uint64_t Metrics::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Получение блока счетчиков текущего потока
+ * @return Блок, созданный при первой записи потока
+ * @details Последний использованный блок кэшируется в thread_local, поэтому
+ *          обычная запись стоит одного сравнения. Блок создается под мьютексом
+ *          один раз на поток и живет до удаления объекта Metrics
+ */
+Metrics::Shard& Metrics::local() {
+    static thread_local uint64_t cached_id = 0;
+    static thread_local Shard* cached = nullptr;
+    static thread_local std::vector<std::pair<uint64_t, Shard*>> known;
+    if (cached_id == id) {
+        return *cached;
+    }
+    for (const auto& entry : known) {
+        if (entry.first == id) {
+            cached_id = id;
+            cached = entry.second;
+            return *cached;
+        }
+    }
+    std::unique_ptr<Shard> shard(new Shard());
+    Shard* raw = shard.get();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        shards.push_back(std::move(shard));
+    }
+    known.emplace_back(id, raw);
+    cached_id = id;
+    cached = raw;
+    return *raw;
+}
+
+/**
+ * @brief Увеличение счетчика
+ * @param counter Счетчик
+ * @param value Приращение
+ */
+void Metrics::add(Counter counter, uint64_t value) {
+    bump(local().counters[static_cast<size_t>(counter)], value);
+}
+
+/**
+ * @brief Запись задержки
+ * @param latency Гистограмма
+ * @param nanoseconds Задержка в наносекундах
+ */
+void Metrics::record(Latency latency, uint64_t nanoseconds) {
+    Shard::Latencies& h = local().latencies[static_cast<size_t>(latency)];
+    bump(h.buckets[bucketIndex(nanoseconds)], 1);
+    bump(h.count, 1);
+    bump(h.sum, nanoseconds);
+}
+
+/**
+ * @brief Получение суммарного значения счетчика
+ * @param counter Счетчик
+ * @return Сумма по всем потокам
+ */
+uint64_t Metrics::value(Counter counter) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t total = 0;
+    for (const auto& shard : shards) {
+        total += shard->counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+/**
+ * @brief Получение снимка гистограммы
+ * @param latency Гистограмма
+ * @return Сумма интервалов по всем потокам
+ */
+Metrics::Histogram Metrics::histogram(Latency latency) const {
+    Histogram result;
+    result.buckets.assign(BUCKETS, 0);
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& shard : shards) {
+        const Shard::Latencies& h = shard->latencies[static_cast<size_t>(latency)];
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            result.buckets[i] += h.buckets[i].load(std::memory_order_relaxed);
+        }
+        result.count += h.count.load(std::memory_order_relaxed);
+        result.sum += h.sum.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+/**
+ * @brief Оценка квантиля
+ * @param q Уровень квантиля (0..1)
+ * @return Наибольшее значение интервала, содержащего квантиль, нс (0 - значений нет)
+ * @details Количество значений берется из суммы интервалов, а не из count:
+ *          поток экспорта читает их без синхронизации с записью
+ */
+uint64_t Metrics::Histogram::quantile(double q) const {
+    uint64_t total = 0;
+    for (uint64_t b : buckets) {
+        total += b;
+    }
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total));
+    if (rank >= total) {
+        rank = total - 1;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen > rank) {
+            return bucketLowerBound(i + 1) - 1;
+        }
+    }
+    return bucketLowerBound(buckets.size()) - 1;
+}
+
+/**
+ * @brief Получение номера интервала гистограммы
+ * @param nanoseconds Значение
+ * @return Номер интервала (значения вне диапазона попадают в последний)
+ * @details Значения меньше 2 * SUB_BUCKETS хранятся точно. Для больших значений
+ *          номер состоит из порядка старшего бита и следующих SUB_BITS бит
+ */
+size_t Metrics::bucketIndex(uint64_t nanoseconds) {
+    if (nanoseconds < 2 * SUB_BUCKETS) {
+        return static_cast<size_t>(nanoseconds);
+    }
+    unsigned exponent = 63 - __builtin_clzll(nanoseconds);
+    if (exponent >= MAX_EXPONENT) {
+        return BUCKETS - 1;
+    }
+    unsigned shift = exponent - SUB_BITS;
+    return (shift + 1) * SUB_BUCKETS + static_cast<size_t>(nanoseconds >> shift) - SUB_BUCKETS;
+}
+
+/**
+ * @brief Получение нижней границы интервала гистограммы
+ * @param index Номер интервала (BUCKETS - граница диапазона)
+ * @return Наименьшее значение интервала, нс
+ */
+uint64_t Metrics::bucketLowerBound(size_t index) {
+    if (index < 2 * SUB_BUCKETS) {
+        return index;
+    }
+    unsigned shift = static_cast<unsigned>(index / SUB_BUCKETS) - 1;
+    return static_cast<uint64_t>(index % SUB_BUCKETS + SUB_BUCKETS) << shift;
+}
+
+/**
+ * @brief Регистрация значения, вычисляемого при экспорте
+ * @param name Имя метрики в формате Prometheus
+ * @param help Описание метрики
+ * @param counter true - монотонный счетчик, false - текущее значение (gauge)
+ * @param fn Функция получения значения
+ */
+void Metrics::addCallback(const std::string& name, const std::string& help, bool counter,
+                          std::function<double()> fn) {
+    std::lock_guard<std::mutex> lock(mutex);
+    callbacks.push_back(Callback{name, help, counter, std::move(fn)});
+}
+
+/**
+ * @brief Формирование текста метрик в формате Prometheus
+ * @return Текст для ответа на запрос /metrics
+ * @details Гистограммы экспортируются с границами le на степенях двойки от 2^10 нс:
+ *          они совпадают с границами интервалов, поэтому значения bucket точны.
+ *          Квантили p50, p99 и p999 вычисляются по полному разрешению гистограммы
+ *          и экспортируются отдельной метрикой vcalc_latency_quantile_seconds
+ */
+std::string Metrics::exposition() const {
+    std::string out;
+    uint64_t values[static_cast<size_t>(Counter::Count)];
+    for (size_t i = 0; i < static_cast<size_t>(Counter::Count); ++i) {
+        values[i] = value(static_cast<Counter>(i));
+        header(out, counterInfo[i].name, counterInfo[i].help, "counter");
+        out += counterInfo[i].name;
+        out += ' ' + std::to_string(values[i]) + '\n';
+    }
+    uint64_t accepted = values[static_cast<size_t>(Counter::ConnectionsAccepted)];
+    uint64_t closed = values[static_cast<size_t>(Counter::ConnectionsClosed)];
+    header(out, "vcalc_connections_active", "Client connections currently open", "gauge");
+    out += "vcalc_connections_active " + std::to_string(accepted > closed ? accepted - closed : 0) + '\n';
+
+    std::string quantiles;
+    for (size_t l = 0; l < static_cast<size_t>(Latency::Count); ++l) {
+        Histogram h = histogram(static_cast<Latency>(l));
+        const char* name = latencyInfo[l].name;
+        header(out, name, latencyInfo[l].help, "histogram");
+        uint64_t cumulative = 0;
+        size_t bucket = 0;
+        for (unsigned e = EXPORT_MIN_EXPONENT; e <= MAX_EXPONENT; ++e) {
+            size_t end = e == MAX_EXPONENT ? BUCKETS : bucketIndex(uint64_t(1) << e);
+            for (; bucket < end; ++bucket) {
+                cumulative += h.buckets[bucket];
+            }
+            out += std::string(name) + "_bucket{le=\"" + number(static_cast<double>(uint64_t(1) << e) * 1e-9) +
+                   "\"} " + std::to_string(cumulative) + '\n';
+        }
+        out += std::string(name) + "_bucket{le=\"+Inf\"} " + std::to_string(cumulative) + '\n';
+        out += std::string(name) + "_sum " + number(static_cast<double>(h.sum) * 1e-9) + '\n';
+        out += std::string(name) + "_count " + std::to_string(cumulative) + '\n';
+
+        const struct {
+            const char* label;
+            double q;
+        } levels[] = {{"0.5", 0.5}, {"0.99", 0.99}, {"0.999", 0.999}};
+        for (const auto& level : levels) {
+            quantiles += std::string("vcalc_latency_quantile_seconds{operation=\"") + latencyLabel[l] +
+                         "\",quantile=\"" + level.label + "\"} " +
+                         number(static_cast<double>(h.quantile(level.q)) * 1e-9) + '\n';
+        }
+    }
+    header(out, "vcalc_latency_quantile_seconds", "Latency quantiles at full histogram resolution", "gauge");
+    out += quantiles;
+
+    std::vector<Callback> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        snapshot = callbacks;
+    }
+    for (const Callback& c : snapshot) {
+        header(out, c.name.c_str(), c.help.c_str(), c.counter ? "counter" : "gauge");
+        out += c.name + ' ' + number(c.fn()) + '\n';
+    }
+    return out;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file MetricsServer.cpp
+ * @brief Реализация класса MetricsServer - HTTP-экспорта метрик
+ */
+
+#include "MetricsServer.h"
+#include "Metrics.h"
+#include "Logger.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+/**
+ * @brief Конструктор
+ * @param metrics Экспортируемые метрики
+ * @param logger Ссылка на журнал
+ */
+MetricsServer::MetricsServer(const Metrics& metrics, Logger& logger)
+    : metrics(metrics), logger(logger), listenFd(-1), eventFd(-1), scrapeCount(0)
+{
+}
+
+/**
+ * @brief Деструктор
+ * @details Останавливает поток экспорта
+ */
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+/**
+ * @brief Запуск потока экспорта
+ * @param port Порт HTTP
+ * @return true - порт открыт и поток запущен,
+ *         false - не удалось открыть порт (причина записана в журнал)
+ */
+bool MetricsServer::start(unsigned short port) {
+    eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (eventFd == -1 || listenFd == -1) {
+        logger.logError("Metrics: socket setup failed: " + std::string(strerror(errno)), false);
+        stop();
+        return false;
+    }
+    int on = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof on);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = INADDR_ANY;
+    if (bind(listenFd, reinterpret_cast<const sockaddr*>(&addr), sizeof addr) == -1 ||
+        listen(listenFd, 16) == -1) {
+        logger.logError("Metrics: cannot listen on port " + std::to_string(port) + ": " + strerror(errno), false);
+        stop();
+        return false;
+    }
+    thread = std::thread(&MetricsServer::run, this);
+    logger.logInfo("Metrics: serving /metrics on port " + std::to_string(port));
+    return true;
+}
+
+/**
+ * @brief Остановка потока экспорта
+ */
+void MetricsServer::stop() {
+    if (thread.joinable()) {
+        uint64_t one = 1;
+        if (write(eventFd, &one, sizeof(one)) == -1) {
+            logger.logError("Metrics: stop request failed: " + std::string(strerror(errno)), false);
+        }
+        thread.join();
+    }
+    if (listenFd != -1) {
+        close(listenFd);
+        listenFd = -1;
+    }
+    if (eventFd != -1) {
+        close(eventFd);
+        eventFd = -1;
+    }
+}
+
+/**
+ * @brief Тело потока экспорта
+ * @details Ждет подключения или запроса остановки через eventfd
+ */
+void MetricsServer::run() {
+    while (true) {
+        pollfd fds[2] = {{eventFd, POLLIN, 0}, {listenFd, POLLIN, 0}};
+        if (poll(fds, 2, -1) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            logger.logError("Metrics: poll failed: " + std::string(strerror(errno)), false);
+            return;
+        }
+        if (fds[0].revents & POLLIN) {
+            return;
+        }
+        if (fds[1].revents & POLLIN) {
+            int sock = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (sock != -1) {
+                serve(sock);
+                close(sock);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Обслуживание одного подключения
+ * @param sock Сокет клиента
+ * @details Читает строку запроса до конца заголовков (не больше 4 КБ) и отправляет
+ *          ответ с Connection: close. Метод и путь проверяются по строке запроса:
+ *          GET /metrics - метрики, другой путь - 404, другой метод - 405
+ */
+void MetricsServer::serve(int sock) {
+    timeval timeout{REQUEST_TIMEOUT_MS / 1000, (REQUEST_TIMEOUT_MS % 1000) * 1000};
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof timeout);
+    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof timeout);
+
+    std::string request;
+    char buf[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 4096) {
+        ssize_t rc = recv(sock, buf, sizeof buf, 0);
+        if (rc == -1 && errno == EINTR) {
+            continue;
+        }
+        if (rc <= 0) {
+            break;
+        }
+        request.append(buf, rc);
+    }
+    size_t line_end = request.find("\r\n");
+    if (line_end == std::string::npos) {
+        return;
+    }
+    std::string line = request.substr(0, line_end);
+
+    std::string status = "200 OK";
+    std::string body;
+    if (line.compare(0, 4, "GET ") != 0) {
+        status = "405 Method Not Allowed";
+    } else if (line.compare(4, 9, "/metrics ") != 0 && line.compare(4, 9, "/metrics?") != 0) {
+        status = "404 Not Found";
+    } else {
+        body = metrics.exposition();
+        scrapeCount.fetch_add(1);
+    }
+    std::string response = "HTTP/1.1 " + status + "\r\n"
+                           "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                           "Connection: close\r\n\r\n" + body;
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t rc = send(sock, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (rc == -1 && errno == EINTR) {
+            continue;
+        }
+        if (rc <= 0) {
+            return;
+        }
+        sent += rc;
+    }
+}
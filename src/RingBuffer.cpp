@@ -0,0 +1,105 @@
+/**
+ * @file RingBuffer.cpp
+ * @brief Реализация класса RingBuffer - кольцевого буфера входящих данных
+ */
+
+#include "RingBuffer.h"
+#include <cstring>
+#include <algorithm>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+/**
+ * @brief Конструктор буфера
+ * @param capacity Минимальная емкость в байтах
+ * @details Емкость округляется вверх до степени двойки (не меньше 16 байт)
+ */
+RingBuffer::RingBuffer(size_t capacity) : mask(0), head(0), tail(0) {
+    size_t size = 16;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    memory.reset(new char[size]);
+    mask = size - 1;
+}
+
+/**
+ * @brief Копирование данных в буфер
+ * @param data Данные
+ * @param len Длина данных
+ * @return Количество скопированных байт (не больше space())
+ */
+size_t RingBuffer::write(const char* data, size_t len) {
+    len = std::min(len, space());
+    size_t offset = tail & mask;
+    size_t first = std::min(len, capacity() - offset);
+    std::memcpy(memory.get() + offset, data, first);
+    std::memcpy(memory.get(), data + first, len - first);
+    tail += len;
+    return len;
+}
+
+/**
+ * @brief Прием данных из сокета в свободное место буфера
+ * @param sock Сокет
+ * @param max_len Максимум принимаемых байт
+ * @param flags Флаги recvmsg (например, MSG_DONTWAIT)
+ * @return Результат recvmsg: количество байт, 0 при закрытии соединения или -1 при ошибке (errno)
+ * @details Свободное место описывается двумя элементами iovec, поэтому данные,
+ *          переходящие через конец памяти, принимаются одним системным вызовом
+ */
+ssize_t RingBuffer::receive(int sock, size_t max_len, int flags) {
+    size_t len = std::min(max_len, space());
+    size_t offset = tail & mask;
+    size_t first = std::min(len, capacity() - offset);
+    iovec iov[2];
+    iov[0].iov_base = memory.get() + offset;
+    iov[0].iov_len = first;
+    iov[1].iov_base = memory.get();
+    iov[1].iov_len = len - first;
+
+    msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = (len > first) ? 2 : 1;
+    ssize_t rc = recvmsg(sock, &msg, flags);
+    if (rc > 0) {
+        tail += rc;
+    }
+    return rc;
+}
+
+/**
+ * @brief Копирование данных без их извлечения
+ * @param dst Буфер назначения
+ * @param len Количество байт
+ * @return Количество скопированных байт (не больше size())
+ */
+size_t RingBuffer::peek(void* dst, size_t len) const {
+    len = std::min(len, size());
+    size_t offset = head & mask;
+    size_t first = std::min(len, capacity() - offset);
+    std::memcpy(dst, memory.get() + offset, first);
+    std::memcpy(static_cast<char*>(dst) + first, memory.get(), len - first);
+    return len;
+}
+
+/**
+ * @brief Поиск байта среди первых байт буфера
+ * @param c Искомый байт
+ * @param limit Количество просматриваемых байт
+ * @return Смещение найденного байта от начала данных или npos
+ */
+size_t RingBuffer::find(char c, size_t limit) const {
+    limit = std::min(limit, size());
+    size_t offset = head & mask;
+    size_t first = std::min(limit, capacity() - offset);
+    const void* hit = std::memchr(memory.get() + offset, c, first);
+    if (hit) {
+        return static_cast<const char*>(hit) - (memory.get() + offset);
+    }
+    hit = std::memchr(memory.get(), c, limit - first);
+    if (hit) {
+        return first + (static_cast<const char*>(hit) - memory.get());
+    }
+    return npos;
+}
@@ -4,19 +4,102 @@
  */
 
 #include "Server.h"
+#include "IoUring.h"
+#include "AuthThrottle.h"
+#include "Metrics.h"
+#include "Tracer.h"
+#include "VectorPipeline.h"
 #include <cstring>
 #include <system_error>
+#include <cerrno>
 #include <arpa/inet.h>
 #include <vector>
 #include <unistd.h>
+#include <fcntl.h>
 #include <algorithm>
 #include <iostream>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <sys/epoll.h>
+#include <thread>
 
-#define BUFLEN 1024 ///< Максимальный размер буфера для текстового сообщения аутентификации
-#define QLEN 10 ///< Стандартная очередь для listen
-#define AUTH_DATA_LENGTH (16 + 40) ///< 16 символов SALT + 40 символов HASH
+#define QLEN SOMAXCONN ///< Очередь для listen (ограничивается net.core.somaxconn)
+#define MAX_EVENTS 256 ///< Максимальное количество событий за один вызов epoll_wait
+#define URING_ENTRIES 1024 ///< Размер очереди заявок io_uring
+#define URING_BUFFERS 512 ///< Количество буферов приема в кольце io_uring
+#define URING_BUFFER_SIZE 16384 ///< Размер одного буфера приема io_uring
+#define RESULT_BATCH 64 ///< Максимум результатов конвейерного режима в одной отправке
+
+namespace {
+
+/**
+ * @brief Владение файловым дескриптором в пределах области видимости
+ */
+struct FdGuard {
+    int fd; ///< Дескриптор (-1 - отсутствует)
+    ~FdGuard() {
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+};
+
+/**
+ * @brief Преобразование адреса клиента в строку
+ * @param addr Адрес клиента
+ * @return IP-адрес в точечной нотации
+ * @note В отличие от inet_ntoa безопасна при вызове из нескольких потоков
+ */
+std::string addressToString(const sockaddr_in& addr) {
+    char buf[INET_ADDRSTRLEN];
+    if (inet_ntop(AF_INET, &addr.sin_addr, buf, sizeof buf) == nullptr) {
+        return "unknown";
+    }
+    return buf;
+}
+
+/**
+ * @brief Блокирующий прием очередной порции данных во входной буфер
+ * @param sock Сокет клиента
+ * @param reader Входной буфер соединения
+ * @return true - данные приняты, false - соединение закрыто или ошибка приема
+ */
+bool receiveMore(int sock, FrameReader& reader) {
+    while (true) {
+        ssize_t rc = reader.buffer().receive(sock, reader.buffer().space());
+        if (rc > 0) {
+            return true;
+        }
+        if (rc == -1 && errno == EINTR) {
+            continue;
+        }
+        return false;
+    }
+}
+
+/**
+ * @brief Отправка данных целиком блокирующими вызовами
+ * @param sock Сокет клиента
+ * @param data Данные
+ * @param len Длина данных
+ * @return true - данные отправлены, false - ошибка отправки
+ */
+bool sendAll(int sock, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t rc = send(sock, data, len, MSG_NOSIGNAL);
+        if (rc == -1 && errno == EINTR) {
+            continue;
+        }
+        if (rc <= 0) {
+            return false;
+        }
+        data += rc;
+        len -= rc;
+    }
+    return true;
+}
+
+}
 
 /**
  * @brief Конструктор сервера
@@ -25,13 +108,15 @@
  * @param userDb Ссылка на базу данных пользователей
  * @param authenticator Ссылка на аутентификатор
  * @param processor Ссылка на обработчик данных
+ * @param config Параметры работы сервера
  * @throw std::runtime_error при невалидном порте
  */
 Server::Server(unsigned short port, Logger& logger, UserDatabase& userDb, 
-               Authenticator& authenticator, DataProcessor& processor)
+               Authenticator& authenticator, DataProcessor& processor,
+               const ServerConfig& config)
     : port(port), logger(logger), userDb(userDb), 
-      authenticator(authenticator), processor(processor), 
-      listen_sock(-1), self_addr(new sockaddr_in), foreign_addr(new sockaddr_in)
+      authenticator(authenticator), processor(processor), config(config),
+      self_addr(new sockaddr_in)
 {
     validatePort(port); 
 }
@@ -41,7 +126,7 @@ Server::Server(unsigned short port, Logger& logger, UserDatabase& userDb,
  * @details Закрывает сокеты и освобождает ресурсы
  */
 Server::~Server() {
-    if (listen_sock != -1) {
+    for (int listen_sock : listen_socks) {
         close(listen_sock);
         logger.logInfo("Server socket closed");
     }
@@ -70,40 +155,79 @@ void Server::validatePort(unsigned short p) const {
  */
 void Server::sendError(int client_sock, const std::string& message) const {
     const char* err_msg = "ERR";
-    send(client_sock, err_msg, strlen(err_msg), 0);
+    send(client_sock, err_msg, strlen(err_msg), MSG_NOSIGNAL);
     logger.logError("Error sent to client: " + message, false);
 }
 
+/**
+ * @brief Проверка адреса нового клиента ограничителем неудачных попыток
+ * @param client_sock Сокет подключенного клиента
+ * @param peer Адрес клиента
+ * @return true - клиент принят, false - адрес отклонен, сокет закрыт
+ * @details Отклоненное подключение закрывается сразу, без чтения, ответа и записи
+ *          в журнал: под перебором паролей его стоимость ограничена accept и close.
+ *          Отказы учитываются счетчиком AuthThrottle::rejectedAddresses(), принятые
+ *          подключения - метрикой ConnectionsAccepted
+ */
+bool Server::admit(int client_sock, const std::string& peer) const {
+    AuthThrottle* throttle = authenticator.throttle();
+    if (throttle == nullptr || throttle->allowAddress(peer)) {
+        if (config.metrics) {
+            config.metrics->add(Metrics::Counter::ConnectionsAccepted);
+        }
+        return true;
+    }
+    close(client_sock);
+    return false;
+}
+
 /**
  * @brief Чтение текстового сообщения от клиента
  * @param sock Сокет клиента
- * @return Прочитанная строка
- * @throw std::system_error при ошибках чтения
- * @details Удаляет символы перевода строки из полученного сообщения
- */
-std::string Server::readTextMessage(int sock) const {
-    char buffer[BUFLEN];
-    ssize_t rc = recv(sock, buffer, BUFLEN - 1, 0); 
-    if (rc == -1) {
-        throw std::system_error(errno, std::generic_category(), "recv error reading MSG");
-    }
-    if (rc == 0) return "";
-    
-    buffer[rc] = '\0';
-    std::string message(buffer);
-    
+ * @param reader Входной буфер соединения
+ * @param message Прочитанная строка
+ * @return Успех, Disconnected - клиент отключился, не передав строку,
+ *         ReceiveFailed - ошибка чтения
+ * @details Строка считается принятой при получении '\n', при накоплении BUFLEN - 1
+ *          символов или когда клиент замолчал, передав не менее authDataLength() символов.
+ *          Данные, пришедшие после строки, остаются во входном буфере.
+ *          Удаляет символы перевода строки из полученного сообщения
+ */
+SessionStatus Server::readTextMessage(int sock, FrameReader& reader, std::string& message) const {
+    while (!reader.nextLine(message, BUFLEN - 1)) {
+        bool enough = reader.buffered() >= authenticator.authDataLength();
+        ssize_t rc = reader.buffer().receive(sock, BUFLEN, enough ? MSG_DONTWAIT : 0);
+        if (rc > 0) {
+            continue;
+        }
+        if (rc == -1 && errno == EINTR) {
+            continue;
+        }
+        if (rc == -1 && !(enough && (errno == EAGAIN || errno == EWOULDBLOCK))) {
+            return SessionStatus(SessionStatus::Code::ReceiveFailed, strerror(errno));
+        }
+        if (!reader.nextLine(message, BUFLEN - 1, true)) {
+            return SessionStatus(SessionStatus::Code::Disconnected);
+        }
+        break;
+    }
+
     message.erase(std::remove_if(message.begin(), message.end(), 
                                  [](char c){ return c == '\n' || c == '\r'; }), message.end());
-    return message;
+    return SessionStatus();
 }
 
 /**
  * @brief Инициализация и запуск сокета
+ * @return Дескриптор слушающего сокета
  * @throw std::system_error при ошибках создания сокета
- * @details Создает TCP сокет, привязывает к указанному порту, устанавливает флаг SO_REUSEADDR
+ * @details Создает TCP сокет, привязывает к указанному порту, устанавливает флаг SO_REUSEADDR.
+ *          При нескольких рабочих потоках устанавливает SO_REUSEPORT: каждый поток получает
+ *          свой сокет на том же порту, и ядро распределяет входящие подключения между ними
+ *          без общей блокировки accept
  */
-void Server::startListening() {
-    listen_sock = socket(AF_INET, SOCK_STREAM, 0);
+int Server::startListening() {
+    int listen_sock = socket(AF_INET, SOCK_STREAM, 0);
     if (listen_sock == -1) {
         throw std::system_error(errno, std::generic_category(), "socket creation failed");
     }
@@ -112,6 +236,11 @@ void Server::startListening() {
     if (setsockopt(listen_sock, SOL_SOCKET, SO_REUSEADDR, (const char*)&on, sizeof on) == -1) {
         logger.logError("setsockopt SO_REUSEADDR failed, continuing", false);
     }
+    if (config.workers > 1 &&
+        setsockopt(listen_sock, SOL_SOCKET, SO_REUSEPORT, (const char*)&on, sizeof on) == -1) {
+        close(listen_sock);
+        throw std::system_error(errno, std::generic_category(), "setsockopt SO_REUSEPORT failed");
+    }
 
     self_addr->sin_family = AF_INET;
     self_addr->sin_port = htons(port);
@@ -125,34 +254,414 @@ void Server::startListening() {
         close(listen_sock);
         throw std::system_error(errno, std::generic_category(), "listen failed");
     }
+    listen_socks.push_back(listen_sock);
     logger.logInfo("Server started and listening on port " + std::to_string(port));
+    return listen_sock;
 }
 
 /**
  * @brief Основной метод запуска сервера
- * @details Запускает бесконечный цикл обработки подключений
+ * @details Создает по слушающему сокету на каждый рабочий поток и запускает потоки.
+ *          Нулевой рабочий поток выполняется в вызывающем потоке
  * @note Метод не возвращает управление в нормальных условиях
  * @throw std::system_error при ошибках сетевого взаимодействия
  */
 void Server::run() {
-    startListening();
+    unsigned workers = std::max(config.workers, 1u);
+    std::vector<int> socks;
+    for (unsigned i = 0; i < workers; ++i) {
+        socks.push_back(startListening());
+    }
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < workers; ++i) {
+        threads.emplace_back(&Server::runWorker, this, i, socks[i]);
+    }
+    runWorker(0, socks[0]);
+    for (std::thread& t : threads) {
+        t.join();
+    }
+}
+
+/**
+ * @brief Тело рабочего потока
+ * @param id Номер рабочего потока
+ * @param listen_sock Слушающий сокет потока
+ * @details Создает пул буферов потока, общий для всех его соединений.
+ *          Ошибка одного потока записывается в журнал и не останавливает остальные
+ */
+void Server::runWorker(unsigned id, int listen_sock) {
+    try {
+        BufferPool pool(config.hugePages);
+        if (config.ioMode == IoMode::Uring) {
+            std::unique_ptr<IoUring> ring;
+            try {
+                ring.reset(new IoUring(URING_ENTRIES, URING_BUFFERS, URING_BUFFER_SIZE));
+            } catch (const std::system_error& e) {
+                logger.logError("io_uring unavailable (" + std::string(e.what()) + "), falling back to epoll", false);
+            }
+            if (ring) {
+                runUringLoop(listen_sock, *ring, pool);
+                return;
+            }
+        }
+        if (config.ioMode == IoMode::Blocking) {
+            runBlocking(listen_sock, pool);
+        } else {
+            runEventLoop(listen_sock, pool);
+        }
+    } catch (const std::exception& e) {
+        logger.logError("Worker " + std::to_string(id) + " stopped: " + std::string(e.what()), true);
+    }
+}
+
+/**
+ * @brief Цикл обработки событий epoll
+ * @throw std::system_error при ошибках epoll
+ * @details Слушающий сокет и сокеты клиентов переводятся в неблокирующий режим и
+ *          регистрируются в epoll в режиме edge-triggered. Каждое соединение ведет
+ *          свой конечный автомат протокола (Connection), поэтому медленный клиент
+ *          не задерживает остальных. Соединения, прервавшие чтение по бюджету,
+ *          обрабатываются повторно на следующей итерации без ожидания событий
+ */
+void Server::runEventLoop(int listen_sock, BufferPool& pool) {
+    int flags = fcntl(listen_sock, F_GETFL, 0);
+    if (flags == -1 || fcntl(listen_sock, F_SETFL, flags | O_NONBLOCK) == -1) {
+        throw std::system_error(errno, std::generic_category(), "fcntl O_NONBLOCK failed");
+    }
+    FdGuard epoll_guard{epoll_create1(EPOLL_CLOEXEC)};
+    int epoll_fd = epoll_guard.fd;
+    if (epoll_fd == -1) {
+        throw std::system_error(errno, std::generic_category(), "epoll_create1 failed");
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.fd = listen_sock;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_sock, &ev) == -1) {
+        throw std::system_error(errno, std::generic_category(), "epoll_ctl listen socket failed");
+    }
+
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    std::vector<int> pending; // соединения с недочитанными данными
+    std::vector<int> pending_next;
+    epoll_event events[MAX_EVENTS];
+
+    while (true) {
+        int timeout = pending.empty() ? -1 : 0;
+        int n = epoll_wait(epoll_fd, events, MAX_EVENTS, timeout);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "epoll_wait failed");
+        }
+
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == listen_sock) {
+                acceptClients(listen_sock, epoll_fd, connections, pool);
+                continue;
+            }
+            auto it = connections.find(fd);
+            if (it == connections.end()) {
+                continue;
+            }
+            Connection& conn = *it->second;
+            bool alive = true;
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                alive = conn.onReadable();
+                if (alive && conn.hasPendingInput()) {
+                    pending_next.push_back(fd);
+                }
+            }
+            if (alive && (events[i].events & EPOLLOUT)) {
+                alive = conn.onWritable();
+            }
+            if (!alive) {
+                connections.erase(it);
+                logger.logInfo("Connection closed");
+            }
+        }
+
+        for (int fd : pending) {
+            auto it = connections.find(fd);
+            if (it == connections.end() || !it->second->hasPendingInput()) {
+                continue;
+            }
+            if (!it->second->onReadable()) {
+                connections.erase(it);
+                logger.logInfo("Connection closed");
+            } else if (it->second->hasPendingInput()) {
+                pending_next.push_back(fd);
+            }
+        }
+        pending.swap(pending_next);
+        pending_next.clear();
+    }
+}
+
+/**
+ * @brief Прием всех ожидающих подключений
+ * @param listen_sock Слушающий сокет потока
+ * @param epoll_fd Дескриптор epoll потока
+ * @param connections Таблица активных соединений потока
+ * @param pool Пул буферов потока
+ * @details Принимает подключения до EAGAIN (edge-triggered) и регистрирует
+ *          каждый сокет клиента в epoll на чтение и запись
+ */
+void Server::acceptClients(int listen_sock, int epoll_fd,
+                           std::unordered_map<int, std::unique_ptr<Connection>>& connections,
+                           BufferPool& pool) {
+    while (true) {
+        sockaddr_in foreign_addr{};
+        socklen_t socklen = sizeof(sockaddr_in);
+        int work_sock = accept4(listen_sock, reinterpret_cast<sockaddr*>(&foreign_addr), &socklen,
+                                SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (work_sock == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                logger.logError("Accept error: " + std::string(strerror(errno)), false);
+            }
+            return;
+        }
+        uint64_t accepted = Tracer::active() ? Tracer::now() : 0;
+        std::string ip_addr = addressToString(foreign_addr);
+        if (!admit(work_sock, ip_addr)) {
+            continue;
+        }
+        uint64_t session = Tracer::startSession();
+        logger.info("Connection established with ", ip_addr);
+
+        std::unique_ptr<Connection> conn(new Connection(work_sock, ip_addr, logger, userDb, authenticator, processor,
+                                                        pool, config.streaming, config.metrics));
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.fd = work_sock;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, work_sock, &ev) == -1) {
+            logger.logError("epoll_ctl client socket failed: " + std::string(strerror(errno)), false);
+            continue;
+        }
+        conn->setTraceSession(session);
+        Tracer::record(Tracer::Stage::Accept, session, accepted, Tracer::now());
+        connections[work_sock] = std::move(conn);
+    }
+}
+
+/**
+ * @brief Цикл обработки завершений io_uring
+ * @param listen_sock Слушающий сокет потока
+ * @param ring Кольцо io_uring потока
+ * @param pool Пул буферов потока
+ * @throw std::system_error при ошибках io_uring
+ * @details Подключения принимаются одной заявкой multishot accept, данные клиентов
+ *          принимаются multishot recv в буферы из зарегистрированного кольца буферов,
+ *          ответы отправляются заявками send. Все заявки, сформированные при обработке
+ *          пачки завершений, отправляются в ядро одним вызовом io_uring_enter.
+ *          Метка завершения содержит номер сессии и тип операции; сессия удаляется
+ *          только после завершения всех ее заявок, чтобы ядро не обращалось
+ *          к освобожденной памяти
+ */
+void Server::runUringLoop(int listen_sock, IoUring& ring, BufferPool& pool) {
+    /**
+     * @brief Состояние соединения в цикле io_uring
+     */
+    struct UringSession {
+        std::unique_ptr<Connection> conn; ///< Автомат протокола
+        std::string sending; ///< Данные отправки, находящейся в ядре
+        size_t sendOffset = 0; ///< Отправлено байт из sending
+        uint64_t sendStarted = 0; ///< Время постановки отправки (только при трассировке)
+        bool recvArmed = false; ///< Заявка recv активна
+        bool closing = false; ///< Соединение закрывается
+    };
+    enum : uint64_t { OP_ACCEPT = 0, OP_RECV = 1, OP_SEND = 2, OP_BITS = 2 };
+
+    std::unordered_map<uint64_t, UringSession> sessions;
+    uint64_t next_id = 1;
+    bool recv_multishot = true;
+    bool accept_armed = false;
+
+    auto post_send = [&](uint64_t id, UringSession& s) {
+        if (!s.sending.empty()) {
+            return;
+        }
+        size_t len = 0;
+        const char* data = s.conn->pendingOutput(len);
+        if (len == 0) {
+            return;
+        }
+        s.sending.assign(data, len);
+        s.sendOffset = 0;
+        s.sendStarted = s.conn->traceSessionId() ? Tracer::now() : 0;
+        s.conn->outputSent(len);
+        ring.prepareSend(s.conn->socket(), s.sending.data(), s.sending.size(), (id << OP_BITS) | OP_SEND);
+    };
+    auto begin_close = [&](UringSession& s) {
+        if (!s.closing) {
+            s.closing = true;
+            shutdown(s.conn->socket(), SHUT_RDWR);
+        }
+    };
+    auto try_release = [&](uint64_t id) {
+        auto it = sessions.find(id);
+        if (it != sessions.end() && it->second.closing && !it->second.recvArmed && it->second.sending.empty()) {
+            sessions.erase(it);
+            logger.logInfo("Connection closed");
+        }
+    };
+
+    while (true) {
+        if (!accept_armed) {
+            ring.prepareAcceptMultishot(listen_sock, OP_ACCEPT);
+            accept_armed = true;
+        }
+        ring.submitAndWait();
+        ring.forEachCompletion([&](uint64_t user_data, int res, unsigned flags) {
+            uint64_t op = user_data & ((1u << OP_BITS) - 1);
+            uint64_t id = user_data >> OP_BITS;
+            bool more = flags & IORING_CQE_F_MORE;
+
+            if (op == OP_ACCEPT) {
+                accept_armed = more;
+                if (res < 0) {
+                    logger.logError("Accept error: " + std::string(strerror(-res)), false);
+                    return;
+                }
+                uint64_t accepted = Tracer::active() ? Tracer::now() : 0;
+                sockaddr_in foreign_addr{};
+                socklen_t socklen = sizeof(sockaddr_in);
+                std::string ip_addr = "unknown";
+                if (getpeername(res, reinterpret_cast<sockaddr*>(&foreign_addr), &socklen) == 0) {
+                    ip_addr = addressToString(foreign_addr);
+                }
+                if (!admit(res, ip_addr)) {
+                    return;
+                }
+                logger.info("Connection established with ", ip_addr);
+                uint64_t sid = next_id++;
+                UringSession& s = sessions[sid];
+                s.conn.reset(new Connection(res, ip_addr, logger, userDb, authenticator, processor,
+                                                pool, config.streaming, config.metrics));
+                uint64_t session = Tracer::startSession();
+                s.conn->setTraceSession(session);
+                Tracer::record(Tracer::Stage::Accept, session, accepted, Tracer::now());
+                s.recvArmed = true;
+                ring.prepareRecv(res, (sid << OP_BITS) | OP_RECV, recv_multishot);
+                return;
+            }
+
+            auto it = sessions.find(id);
+            if (op == OP_RECV) {
+                const char* data = nullptr;
+                if (flags & IORING_CQE_F_BUFFER) {
+                    data = ring.buffer(flags >> IORING_CQE_BUFFER_SHIFT);
+                }
+                if (it == sessions.end()) {
+                    if (data) {
+                        ring.recycle(flags >> IORING_CQE_BUFFER_SHIFT);
+                    }
+                    return;
+                }
+                UringSession& s = it->second;
+                s.recvArmed = more;
+                if (res > 0 && data && !s.closing) {
+                    s.conn->onData(data, res);
+                    post_send(id, s);
+                    if (s.sending.empty() && s.conn->isFinished()) {
+                        begin_close(s);
+                    }
+                } else if (res == -EINVAL && recv_multishot) {
+                    recv_multishot = false; // ядро без IORING_RECV_MULTISHOT
+                } else if (res == 0) {
+                    begin_close(s);
+                } else if (res < 0 && res != -ENOBUFS) {
+                    if (!s.closing) {
+                        logger.logError("recv error: " + std::string(strerror(-res)), false);
+                    }
+                    begin_close(s);
+                }
+                if (data) {
+                    ring.recycle(flags >> IORING_CQE_BUFFER_SHIFT);
+                }
+                if (!s.recvArmed && !s.closing) {
+                    s.recvArmed = true;
+                    ring.prepareRecv(s.conn->socket(), (id << OP_BITS) | OP_RECV, recv_multishot);
+                }
+                try_release(id);
+                return;
+            }
+
+            if (op == OP_SEND && it != sessions.end()) {
+                UringSession& s = it->second;
+                if (res < 0) {
+                    if (!s.closing) {
+                        logger.logError("send error: " + std::string(strerror(-res)), false);
+                    }
+                    s.sending.clear();
+                    begin_close(s);
+                } else {
+                    s.sendOffset += res;
+                    if (s.sendOffset < s.sending.size() && !s.closing) {
+                        ring.prepareSend(s.conn->socket(), s.sending.data() + s.sendOffset,
+                                         s.sending.size() - s.sendOffset, (id << OP_BITS) | OP_SEND);
+                        return;
+                    }
+                    Tracer::record(Tracer::Stage::Send, s.conn->traceSessionId(), s.sendStarted, Tracer::now());
+                    s.sending.clear();
+                    if (!s.closing) {
+                        post_send(id, s);
+                        if (s.sending.empty() && s.conn->isFinished()) {
+                            begin_close(s);
+                        }
+                    }
+                }
+                try_release(id);
+            }
+        });
+    }
+}
+
+/**
+ * @brief Последовательная обработка клиентов блокирующими вызовами
+ * @param listen_sock Слушающий сокет потока
+ * @param pool Пул буферов потока
+ * @details Принимает очередного клиента и обслуживает его до конца сессии
+ */
+void Server::runBlocking(int listen_sock, BufferPool& pool) {
+    std::unique_ptr<VectorPipeline> pipeline;
+    if (config.pipeline) {
+        pipeline.reset(new VectorPipeline(processor, logger));
+    }
+    sockaddr_in foreign_addr{};
     socklen_t socklen = sizeof(sockaddr_in);
     while(true) {
         int work_sock = -1;
         try {
             logger.logInfo("Waiting for new client...");
-            work_sock = accept(listen_sock, reinterpret_cast<sockaddr*>(foreign_addr.get()), &socklen);
+            work_sock = accept(listen_sock, reinterpret_cast<sockaddr*>(&foreign_addr), &socklen);
             if (work_sock == -1) {
                 logger.logError("Accept error: " + std::string(strerror(errno)), false);continue; 
             }
-            std::string ip_addr(inet_ntoa(foreign_addr->sin_addr));
-            logger.logInfo("Connection established with " + ip_addr);
-            handleClient(work_sock);
+            uint64_t accepted = Tracer::active() ? Tracer::now() : 0;
+            std::string ip_addr = addressToString(foreign_addr);
+            if (!admit(work_sock, ip_addr)) {
+                work_sock = -1;
+                continue;
+            }
+            uint64_t session = Tracer::startSession();
+            Tracer::Scope scope(session);
+            logger.info("Connection established with ", ip_addr);
+            Tracer::record(Tracer::Stage::Accept, session, accepted, Tracer::now());
+            handleClient(work_sock, ip_addr, pool, pipeline.get());
         } catch (const std::exception& e) {
             logger.logError("Error in server loop: " + std::string(e.what()), false);
         }
         if (work_sock != -1) {
             close(work_sock);
+            if (config.metrics) {
+                config.metrics->add(Metrics::Counter::ConnectionsClosed);
+            }
             logger.logInfo("Connection closed");
         }
     }
@@ -161,37 +670,47 @@ void Server::run() {
 /**
  * @brief Обработка одного клиента
  * @param client_sock Сокет подключенного клиента
- * @throw auth_error при ошибках аутентификации
- * @throw vector_error при ошибках обработки векторов
+ * @param peer Адрес клиента
+ * @param pool Пул буферов потока
+ * @param pipeline Поток вычисления векторов (nullptr - последовательная обработка)
  * @details Выполняет полный цикл взаимодействия:
  *          1. Чтение аутентификационного сообщения
  *          2. Проверка аутентификации
  *          3. Обработка векторов данных
+ *
+ *          Ошибки протокола возвращаются шагами сессии как SessionStatus: клиенту
+ *          отправляется "ERR", а в журнал - одна запись. Исключения (нехватка памяти)
+ *          передаются вызывающей стороне после отправки "ERR"
  */
-void Server::handleClient(int client_sock) {
+void Server::handleClient(int client_sock, const std::string& peer, BufferPool& pool, VectorPipeline* pipeline) {
     try {
-        std::string full_msg = readTextMessage(client_sock);
-        if (full_msg.empty()) {
+        FrameReader reader;
+        std::string full_msg;
+        SessionStatus status;
+        {
+            Tracer::Span span(Tracer::Stage::ReadAuth);
+            status = readTextMessage(client_sock, reader, full_msg);
+        }
+        if (status.code() == SessionStatus::Code::Disconnected) {
             logger.logError("Client disconnected during authentication", false);
             return;
         }
-        if (full_msg.length() < AUTH_DATA_LENGTH) {
-            throw auth_error("Auth message too short");
+        std::string login;
+        if (status) {
+            status = authenticator.authenticate(full_msg, peer, userDb, logger, login);
         }
-        std::string auth_data = full_msg.substr(full_msg.length() - AUTH_DATA_LENGTH);
-        std::string login = full_msg.substr(0, full_msg.length() - AUTH_DATA_LENGTH);
-
-        if (authenticator.verify(login, auth_data, userDb, logger)) {
-            const char* ok_msg = "OK";
-            send(client_sock, ok_msg, strlen(ok_msg), 0); 
-            logger.logInfo("Client '" + login + "' authenticated successfully");
-        } else {
-            throw auth_error("Authentication failed for login " + login);
+        if (status) {
+            std::string ok_msg = "OK" + authenticator.issueTicket(full_msg, login);
+            {
+                Tracer::Span span(Tracer::Stage::Send);
+                send(client_sock, ok_msg.data(), ok_msg.size(), MSG_NOSIGNAL);
+            }
+            logger.info("Client '", login, "' authenticated successfully");
+            status = processVectors(client_sock, reader, pool, pipeline);
+        }
+        if (!status) {
+            sendError(client_sock, status.message());
         }
-        processVectors(client_sock);
-    } catch (const auth_error& e) {
-        sendError(client_sock, e.what());
-        throw;
     } catch (const std::exception& e) {
         sendError(client_sock, "Protocol processing error");
         throw;
@@ -201,7 +720,10 @@ void Server::handleClient(int client_sock) {
 /**
  * @brief Обработка векторов данных от клиента
  * @param client_sock Сокет клиента
- * @throw vector_error при ошибках обработки векторов
+ * @param reader Входной буфер соединения
+ * @param pool Пул буферов потока
+ * @param pipeline Поток вычисления векторов (nullptr - последовательная обработка)
+ * @return Успех или код ошибки приема векторов
  * @details Протокол обработки векторов:
  *          1. Получение количества векторов (uint32_t)
  *          2. Для каждого вектора:
@@ -209,38 +731,234 @@ void Server::handleClient(int client_sock) {
  *             б. Получение данных вектора (int32_t[])
  *             в. Вычисление среднего арифметического
  *             г. Отправка результата клиенту
+ *          Каждое поле дочитывается до конца, сколько бы вызовов recv ни потребовалось.
+ *          Остаток данных вектора, не поместившийся во входной буфер, принимается
+ *          прямо в память вектора. Память векторов берется из пула буферов потока
+ *          без обнуления и возвращается в него после вычисления. При подключенных
+ *          метриках учитываются векторы, их байты, время приема и время вычисления.
+ *          С потоком вычисления (без потокового суммирования) векторы обрабатываются
+ *          конвейером: pipelineVectors()
  * @note Проверяет коректность размера вектора
  */
-void Server::processVectors(int sock) {
+SessionStatus Server::processVectors(int sock, FrameReader& reader, BufferPool& pool, VectorPipeline* pipeline) {
     uint32_t num_vectors;
-    ssize_t rc;
-
-    rc = recv(sock, &num_vectors, sizeof(num_vectors), 0);
-    if (rc != sizeof(num_vectors)) {
-        throw vector_error("Failed to receive number of vectors");
+    while (!reader.nextU32(num_vectors)) {
+        if (!receiveMore(sock, reader)) {
+            return SessionStatus(SessionStatus::Code::CountTruncated);
+        }
+    }
+    logger.info("Receiving ", num_vectors, " vectors");
+    if (pipeline != nullptr && !config.streaming) {
+        return pipelineVectors(sock, reader, pool, *pipeline, num_vectors);
     }
-    logger.logInfo("Receiving " + std::to_string(num_vectors) + " vectors");
     for (uint32_t i = 0; i < num_vectors; ++i) {
         uint32_t vector_len;
-        rc = recv(sock, &vector_len, sizeof(vector_len), 0);
-        if (rc != sizeof(vector_len)) {
-             throw vector_error("Failed to receive vector length");
+        while (!reader.nextU32(vector_len)) {
+            if (!receiveMore(sock, reader)) {
+                return SessionStatus(SessionStatus::Code::LengthTruncated);
+            }
         }
         
         size_t total_bytes_needed = vector_len * sizeof(int32_t);
 
         if (vector_len == 0 || total_bytes_needed > 4000000000) { 
-             throw vector_error("Vector size invalid or too large");
+            return SessionStatus(SessionStatus::Code::InvalidLength);
         }
-        std::vector<int32_t> data(vector_len);
-        rc = recv(sock, data.data(), total_bytes_needed, 0);
-        if (rc != (ssize_t)total_bytes_needed) {
-            throw vector_error("Vector data size mismatch");
+        uint64_t trace = Tracer::session();
+        uint64_t started = (config.metrics || trace) ? Metrics::now() : 0;
+        uint64_t payload_done = started;
+        int32_t result;
+        if (config.streaming) {
+            DataProcessor::Accumulator acc;
+            auto feed = [&acc](const char* chunk, size_t len) { acc.feedBytes(chunk, len); };
+            size_t received = reader.nextPayload(total_bytes_needed, feed);
+            while (received < total_bytes_needed) {
+                if (!receiveMore(sock, reader)) {
+                    return SessionStatus(SessionStatus::Code::DataTruncated);
+                }
+                received += reader.nextPayload(total_bytes_needed - received, feed);
+            }
+            if (config.metrics || trace) {
+                payload_done = Metrics::now();
+            }
+            result = processor.finalize(acc, logger);
+        } else {
+            BufferPool::Buffer data = pool.acquire(total_bytes_needed);
+            char* dst = data.data();
+            size_t received = reader.nextPayload(total_bytes_needed, [&](const char* chunk, size_t len) {
+                std::memcpy(dst, chunk, len);
+                dst += len;
+            });
+            while (received < total_bytes_needed) {
+                ssize_t rc = recv(sock, dst, total_bytes_needed - received, MSG_WAITALL);
+                if (rc == -1 && errno == EINTR) {
+                    continue;
+                }
+                if (rc <= 0) {
+                    return SessionStatus(SessionStatus::Code::DataTruncated);
+                }
+                dst += rc;
+                received += rc;
+            }
+            if (config.metrics || trace) {
+                payload_done = Metrics::now();
+            }
+            result = processor.calculateAverage(reinterpret_cast<const int32_t*>(data.data()), vector_len, logger);
+        }
+        Tracer::record(Tracer::Stage::Receive, trace, started, payload_done);
+        if (config.metrics) {
+            config.metrics->record(Metrics::Latency::VectorReceive, payload_done - started);
+            config.metrics->record(Metrics::Latency::Compute, Metrics::now() - payload_done);
+            config.metrics->add(Metrics::Counter::VectorsProcessed);
+            config.metrics->add(Metrics::Counter::BytesProcessed, total_bytes_needed);
         }
-        int32_t result = processor.calculateAverage(data, logger);
         int32_t net_result = (result);
-        send(sock, &net_result, sizeof(net_result), 0);
+        {
+            Tracer::Span span(Tracer::Stage::Send);
+            send(sock, &net_result, sizeof(net_result), MSG_NOSIGNAL);
+        }
         
-        logger.logInfo("Processed vector " + std::to_string(i+1) + ", result: " + std::to_string(result));
+        logger.info("Processed vector ", i + 1, ", result: ", result);
+    }
+    return SessionStatus();
+}
+
+/**
+ * @brief Конвейерная обработка векторов
+ * @param sock Сокет клиента
+ * @param reader Входной буфер соединения
+ * @param pool Пул буферов потока
+ * @param pipeline Поток вычисления векторов
+ * @param num_vectors Количество векторов
+ * @return Успех или код ошибки приема векторов
+ * @details Векторы принимаются попеременно в два буфера: пока поток вычисления
+ *          суммирует вектор i, принимается вектор i + 1. Результаты копятся по порядку
+ *          и отправляются одним вызовом send (до RESULT_BATCH за раз). Пока есть
+ *          вычисляемый вектор или неотправленные результаты, прием выполняется без
+ *          блокировки; когда данных в сокете нет, сервер дожидается вычисления и
+ *          отправляет результаты, а уже затем блокируется на приеме. Поэтому клиент,
+ *          ожидающий ответа на каждый вектор перед отправкой следующего, получает
+ *          ответы так же, как без конвейера. При ошибке приема результаты уже
+ *          принятых векторов отправляются до "ERR"
+ */
+SessionStatus Server::pipelineVectors(int sock, FrameReader& reader, BufferPool& pool, VectorPipeline& pipeline,
+                                      uint32_t num_vectors) {
+    BufferPool::Buffer buffers[2];
+    // Ожидание вычисления при любом выходе; объявлен после буферов и завершается раньше их освобождения
+    struct Drain {
+        VectorPipeline& pipeline;
+        ~Drain() {
+            pipeline.drain();
+        }
+    } drain{pipeline};
+
+    uint64_t trace = Tracer::session();
+    uint32_t computing = 0; // номер вычисляемого вектора (с единицы), 0 - нет
+    size_t computing_bytes = 0;
+    int32_t results[RESULT_BATCH];
+    size_t ready = 0;
+
+    auto flush = [&]() {
+        if (ready == 0) {
+            return;
+        }
+        Tracer::Span span(Tracer::Stage::Send);
+        sendAll(sock, reinterpret_cast<const char*>(results), ready * sizeof(int32_t));
+        ready = 0;
+    };
+    auto collect = [&]() {
+        if (computing == 0) {
+            return;
+        }
+        VectorPipeline::Result result = pipeline.wait();
+        if (config.metrics) {
+            config.metrics->record(Metrics::Latency::Compute, result.nanoseconds);
+            config.metrics->add(Metrics::Counter::VectorsProcessed);
+            config.metrics->add(Metrics::Counter::BytesProcessed, computing_bytes);
+        }
+        logger.info("Processed vector ", computing, ", result: ", result.value);
+        results[ready++] = result.value;
+        computing = 0;
+        if (ready == RESULT_BATCH) {
+            flush();
+        }
+    };
+    auto idle = [&]() {
+        return computing == 0 && ready == 0;
+    };
+    auto more = [&]() {
+        if (!idle()) {
+            ssize_t rc;
+            do {
+                rc = reader.buffer().receive(sock, reader.buffer().space(), MSG_DONTWAIT);
+            } while (rc == -1 && errno == EINTR);
+            if (rc > 0) {
+                return true;
+            }
+            if (rc == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                return false;
+            }
+            collect();
+            flush();
+        }
+        return receiveMore(sock, reader);
+    };
+    auto fail = [&](SessionStatus::Code code) {
+        collect();
+        flush();
+        return SessionStatus(code);
+    };
+
+    for (uint32_t i = 0; i < num_vectors; ++i) {
+        uint32_t vector_len;
+        while (!reader.nextU32(vector_len)) {
+            if (!more()) {
+                return fail(SessionStatus::Code::LengthTruncated);
+            }
+        }
+
+        size_t total_bytes_needed = vector_len * sizeof(int32_t);
+
+        if (vector_len == 0 || total_bytes_needed > 4000000000) {
+            return fail(SessionStatus::Code::InvalidLength);
+        }
+        uint64_t started = (config.metrics || trace) ? Metrics::now() : 0;
+        BufferPool::Buffer& data = buffers[i & 1];
+        data = pool.acquire(total_bytes_needed);
+        char* dst = data.data();
+        size_t received = reader.nextPayload(total_bytes_needed, [&](const char* chunk, size_t len) {
+            std::memcpy(dst, chunk, len);
+            dst += len;
+        });
+        while (received < total_bytes_needed) {
+            int flags = idle() ? MSG_WAITALL : MSG_DONTWAIT;
+            ssize_t rc = recv(sock, dst, total_bytes_needed - received, flags);
+            if (rc == -1 && errno == EINTR) {
+                continue;
+            }
+            if (rc == -1 && flags == MSG_DONTWAIT && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                collect();
+                flush();
+                continue;
+            }
+            if (rc <= 0) {
+                return fail(SessionStatus::Code::DataTruncated);
+            }
+            dst += rc;
+            received += rc;
+        }
+        uint64_t payload_done = (config.metrics || trace) ? Metrics::now() : 0;
+        Tracer::record(Tracer::Stage::Receive, trace, started, payload_done);
+        if (config.metrics) {
+            config.metrics->record(Metrics::Latency::VectorReceive, payload_done - started);
+        }
+
+        collect();
+        pipeline.submit(reinterpret_cast<const int32_t*>(data.data()), vector_len, trace);
+        computing = i + 1;
+        computing_bytes = total_bytes_needed;
     }
-}
\ No newline at end of file
+    collect();
+    flush();
+    return SessionStatus();
+}
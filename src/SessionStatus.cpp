@@ -0,0 +1,49 @@
+/**
+ * @file SessionStatus.cpp
+ * @brief Реализация класса SessionStatus - результата шага протокола
+ */
+
+#include "SessionStatus.h"
+
+/**
+ * @brief Проверка принадлежности к ошибкам аутентификации
+ * @return true - код AuthTooShort, AuthFailed, AuthThrottled или TicketRejected
+ */
+bool SessionStatus::isAuthError() const {
+    return statusCode == Code::AuthTooShort || statusCode == Code::AuthFailed ||
+           statusCode == Code::AuthThrottled || statusCode == Code::TicketRejected;
+}
+
+/**
+ * @brief Формирование текста для журнала
+ * @return Описание результата с подробностью
+ * @details Тексты совпадают с сообщениями прежних исключений auth_error и vector_error,
+ *          поэтому записи журнала сохраняют привычный вид
+ */
+std::string SessionStatus::message() const {
+    switch (statusCode) {
+    case Code::Ok:
+        return "OK";
+    case Code::Disconnected:
+        return "Client disconnected";
+    case Code::ReceiveFailed:
+        return "recv error: " + statusDetail;
+    case Code::AuthTooShort:
+        return "Auth error: Auth message too short";
+    case Code::AuthFailed:
+        return "Auth error: Authentication failed for login " + statusDetail;
+    case Code::AuthThrottled:
+        return "Auth error: Too many failed attempts for login " + statusDetail;
+    case Code::TicketRejected:
+        return "Auth error: Session ticket rejected for login " + statusDetail;
+    case Code::CountTruncated:
+        return "Vector error: Failed to receive number of vectors";
+    case Code::LengthTruncated:
+        return "Vector error: Failed to receive vector length";
+    case Code::InvalidLength:
+        return "Vector error: Vector size invalid or too large";
+    case Code::DataTruncated:
+        return "Vector error: Vector data size mismatch";
+    }
+    return "Unknown session status";
+}
@@ -0,0 +1,129 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief Реализация класса ThreadPool - пула потоков с перехватом задач
+ */
+
+#include "ThreadPool.h"
+
+/**
+ * @brief Конструктор пула
+ * @param threads Количество потоков пула
+ */
+ThreadPool::ThreadPool(unsigned threads) : queued(0), nextQueue(0), stopping(false) {
+    for (unsigned i = 0; i < threads; ++i) {
+        queues.emplace_back(new Queue);
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+/**
+ * @brief Деструктор
+ * @details Останавливает и дожидается потоков пула
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (std::thread& t : workers) {
+        t.join();
+    }
+}
+
+/**
+ * @brief Распределение частей по очередям и ожидание их выполнения
+ * @param batch Группа частей
+ * @param count Количество частей
+ * @details Части раздаются очередям непрерывными диапазонами, начиная с очереди,
+ *          следующей за использованной предыдущим вызовом. Пока части не выполнены,
+ *          вызывающий поток сам выполняет задачи из очередей
+ */
+void ThreadPool::run(const Batch& batch, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    if (queues.empty()) {
+        for (size_t i = 0; i < count; ++i) {
+            batch.fn(batch.ctx, i);
+        }
+        return;
+    }
+
+    size_t n = queues.size();
+    unsigned first = nextQueue.fetch_add(1, std::memory_order_relaxed);
+    queued.fetch_add(count, std::memory_order_release); // до публикации, чтобы счетчик не уходил ниже нуля
+    size_t index = 0;
+    for (size_t q = 0; q < n && index < count; ++q) {
+        size_t share = count / n + (q < count % n ? 1 : 0);
+        Queue& queue = *queues[(first + q) % n];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (size_t k = 0; k < share; ++k) {
+            queue.tasks.push_back(Task{&batch, index++});
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeUp.notify_all();
+
+    while (batch.pending->load(std::memory_order_acquire) != 0) {
+        if (!runOne(first % n)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+/**
+ * @brief Тело потока пула
+ * @param self Номер потока
+ * @details Выполняет задачи, пока они есть, затем засыпает до появления новых
+ */
+void ThreadPool::workerLoop(unsigned self) {
+    while (true) {
+        if (runOne(self)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this] {
+            return stopping || queued.load(std::memory_order_acquire) != 0;
+        });
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Выполнение одной задачи: своей или перехваченной
+ * @param self Номер очереди, с которой начинается поиск
+ * @return true - задача выполнена, false - все очереди пусты
+ * @details Из своей очереди задача берется с конца, из чужих - с начала
+ */
+bool ThreadPool::runOne(unsigned self) {
+    size_t n = queues.size();
+    for (size_t k = 0; k < n; ++k) {
+        Queue& queue = *queues[(self + k) % n];
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) {
+                continue;
+            }
+            if (k == 0) {
+                task = queue.tasks.back();
+                queue.tasks.pop_back();
+            } else {
+                task = queue.tasks.front();
+                queue.tasks.pop_front();
+            }
+        }
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        task.batch->fn(task.batch->ctx, task.index);
+        task.batch->pending->fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file TicketManager.cpp
+ * @brief Реализация класса TicketManager - билетов возобновления сессии
+ */
+
+#include "TicketManager.h"
+#include "Digest.h"
+#include <cryptopp/hmac.h>
+#include <cryptopp/sha.h>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+namespace CPP = CryptoPP;
+
+namespace {
+
+const size_t MAC_SIZE = CPP::SHA256::DIGESTSIZE; ///< Размер подписи билета
+
+/**
+ * @brief Запись числа в буфер в порядке big-endian
+ * @param value Число
+ * @param out Буфер
+ * @param size Количество байтов
+ */
+void putBigEndian(uint64_t value, unsigned char* out, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        out[size - 1 - i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+/**
+ * @brief Чтение числа из буфера в порядке big-endian
+ * @param data Буфер
+ * @param size Количество байтов
+ * @return Число
+ */
+uint64_t getBigEndian(const unsigned char* data, size_t size) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; ++i) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+}
+
+/**
+ * @brief Конструктор
+ * @param secret Секрет сервера
+ * @param lifetime Срок действия билета в секундах
+ */
+TicketManager::TicketManager(const std::string& secret, unsigned lifetime)
+    : secret(secret), ticketLifetime(lifetime)
+{
+}
+
+/**
+ * @brief Вычисление подписи билета
+ * @param login Логин
+ * @param expiry Срок действия
+ * @param key_id Номер ключа
+ * @param out Буфер подписи (32 байта)
+ * @details Сначала из секрета выводится ключ периода, затем им подписываются
+ *          срок действия, номер ключа и логин
+ */
+void TicketManager::sign(std::string_view login, uint64_t expiry, uint32_t key_id, unsigned char* out) const {
+    static const char KEY_LABEL[] = "vcalc-ticket-key";
+    unsigned char key[MAC_SIZE];
+    unsigned char fields[8 + 4];
+    putBigEndian(key_id, fields + 8, 4);
+
+    CPP::HMAC<CPP::SHA256> kdf(reinterpret_cast<const CPP::byte*>(secret.data()), secret.size());
+    kdf.Update(reinterpret_cast<const CPP::byte*>(KEY_LABEL), sizeof(KEY_LABEL) - 1);
+    kdf.Update(fields + 8, 4);
+    kdf.Final(key);
+
+    putBigEndian(expiry, fields, 8);
+    CPP::HMAC<CPP::SHA256> mac(key, sizeof(key));
+    mac.Update(fields, sizeof(fields));
+    mac.Update(reinterpret_cast<const CPP::byte*>(login.data()), login.size());
+    mac.Final(out);
+}
+
+/**
+ * @brief Выдача билета
+ * @param login Логин аутентифицированного пользователя
+ * @param now Текущее время
+ * @return Билет длиной TICKET_LENGTH
+ */
+std::string TicketManager::issue(std::string_view login, time_t now) const {
+    uint64_t expiry = static_cast<uint64_t>(now) + ticketLifetime;
+    uint32_t key_id = static_cast<uint32_t>(now / KEY_ROTATION);
+
+    unsigned char raw[8 + 4 + MAC_SIZE];
+    putBigEndian(expiry, raw, 8);
+    putBigEndian(key_id, raw + 8, 4);
+    sign(login, expiry, key_id, raw + 12);
+
+    std::string ticket(TICKET_LENGTH, '0');
+    Digest::encodeHex(raw, sizeof(raw), &ticket[0]);
+    return ticket;
+}
+
+/**
+ * @brief Проверка билета
+ * @param login Логин, предъявленный вместе с билетом
+ * @param ticket Билет
+ * @param now Текущее время
+ * @return true - билет выдан этому логину, не истек и подписан действующим ключом
+ * @details Подпись сравнивается за постоянное время
+ */
+bool TicketManager::validate(std::string_view login, std::string_view ticket, time_t now) const {
+    unsigned char raw[8 + 4 + MAC_SIZE];
+    if (ticket.size() != TICKET_LENGTH || !Digest::decodeHex(ticket.data(), raw, sizeof(raw))) {
+        return false;
+    }
+    uint64_t expiry = getBigEndian(raw, 8);
+    uint32_t key_id = static_cast<uint32_t>(getBigEndian(raw + 8, 4));
+    uint32_t current_key = static_cast<uint32_t>(now / KEY_ROTATION);
+    if (expiry <= static_cast<uint64_t>(now) || (key_id != current_key && key_id + 1 != current_key)) {
+        return false;
+    }
+    unsigned char expected[MAC_SIZE];
+    sign(login, expiry, key_id, expected);
+    return Digest::equal(expected, raw + 12, MAC_SIZE);
+}
+
+/**
+ * @brief Чтение секрета из файла
+ * @param path Путь к файлу секрета
+ * @param out_secret Содержимое файла
+ * @return true - файл прочитан и содержит не менее MIN_SECRET_LENGTH байт
+ */
+bool TicketManager::readSecret(const std::string& path, std::string& out_secret) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    out_secret.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return out_secret.size() >= MIN_SECRET_LENGTH;
+}
+
+/**
+ * @brief Генерация случайного секрета
+ * @return Секрет длиной 32 байта
+ */
+std::string TicketManager::generateSecret() {
+    std::random_device device;
+    std::string secret(32, '\0');
+    for (char& c : secret) {
+        c = static_cast<char>(device());
+    }
+    return secret;
+}
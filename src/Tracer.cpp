@@ -0,0 +1,255 @@
+/**
+ * @file Tracer.cpp
+ * @brief Реализация класса Tracer - трассировки этапов клиентских сессий
+ */
+
+#include "Tracer.h"
+#include <chrono>
+#include <cstdio>
+#include <utility>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Источник номеров объектов Tracer
+ */
+std::atomic<uint64_t> nextTracerId{1};
+
+const char* stageNames[] = {"accept", "read_auth", "verify", "receive", "calculate_average", "finalize", "send"};
+
+}
+
+/**
+ * @brief Кольцевой буфер интервалов одного потока
+ * @details Пишет только поток-владелец: поля интервала сохраняются до публикации
+ *          нового значения head, поэтому читатель видит заполненные интервалы
+ */
+struct Tracer::Ring {
+    /**
+     * @brief Интервал
+     */
+    struct Event {
+        std::atomic<uint64_t> start; ///< Начало, нс
+        std::atomic<uint64_t> end; ///< Конец, нс
+        std::atomic<uint64_t> tag; ///< Номер сессии << 8 | этап
+    };
+
+    std::unique_ptr<Event[]> events; ///< Интервалы
+    std::atomic<uint64_t> head{0}; ///< Количество записанных интервалов
+    unsigned thread = 0; ///< Номер дорожки потока в трассе
+};
+
+/**
+ * @brief Конструктор
+ * @param sample_every Трассировать каждую N-ю сессию (0 считается как 1)
+ * @param capacity Интервалов в буфере одного потока (округляется вверх до степени двойки)
+ */
+Tracer::Tracer(unsigned sample_every, size_t capacity)
+    : id(nextTracerId.fetch_add(1)), sampleEvery(sample_every == 0 ? 1 : sample_every),
+      capacity([capacity] {
+          size_t size = 1;
+          while (size < capacity) {
+              size <<= 1;
+          }
+          return size;
+      }()),
+      origin(now()), sessions(0)
+{
+}
+
+/**
+ * @brief Деструктор
+ * @details Снимает трассировщик, если он установлен
+ */
+Tracer::~Tracer() {
+    Tracer* self = this;
+    instance.compare_exchange_strong(self, nullptr);
+}
+
+/**
+ * @brief Установка трассировщика процесса
+ * @param tracer Трассировщик (nullptr - трассировка выключена)
+ */
+void Tracer::install(Tracer* tracer) {
+    instance.store(tracer, std::memory_order_release);
+}
+
+/**
+ * @brief Получение текущего времени
+ * @return Наносекунды монотонных часов
+ */
+uint64_t Tracer::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Выбор номера для новой сессии
+ * @return Номер трассируемой сессии или 0
+ * @details Номер - порядковый номер сессии с единицы, поэтому в трассе видно,
+ *          сколько сессий пропущено выборкой
+ */
+uint64_t Tracer::startSession() {
+    Tracer* tracer = active();
+    if (tracer == nullptr) {
+        return 0;
+    }
+    uint64_t n = tracer->sessions.fetch_add(1, std::memory_order_relaxed);
+    return n % tracer->sampleEvery == 0 ? n + 1 : 0;
+}
+
+/**
+ * @brief Запись интервала с явными границами
+ * @param stage Этап
+ * @param session Номер сессии (0 - интервал не записывается)
+ * @param start Начало, нс
+ * @param end Конец, нс
+ */
+void Tracer::record(Stage stage, uint64_t session, uint64_t start, uint64_t end) {
+    if (session == 0) {
+        return;
+    }
+    if (Tracer* tracer = active()) {
+        tracer->append(stage, session, start, end);
+    }
+}
+
+/**
+ * @brief Запись интервала в буфер потока
+ */
+void Tracer::Span::finish() {
+    record(stage, session, start, now());
+}
+
+/**
+ * @brief Получение названия этапа
+ * @param stage Этап
+ * @return Название для trace_event
+ */
+const char* Tracer::stageName(Stage stage) {
+    return stageNames[static_cast<size_t>(stage)];
+}
+
+/**
+ * @brief Получение буфера текущего потока
+ * @return Буфер, созданный при первой записи потока
+ * @details Последний использованный буфер кэшируется в thread_local; буфер
+ *          создается под мьютексом один раз на поток
+ */
+Tracer::Ring& Tracer::local() {
+    static thread_local uint64_t cached_id = 0;
+    static thread_local Ring* cached = nullptr;
+    static thread_local std::vector<std::pair<uint64_t, Ring*>> known;
+    if (cached_id == id) {
+        return *cached;
+    }
+    for (const auto& entry : known) {
+        if (entry.first == id) {
+            cached_id = id;
+            cached = entry.second;
+            return *cached;
+        }
+    }
+    std::unique_ptr<Ring> ring(new Ring());
+    ring->events.reset(new Ring::Event[capacity]());
+    Ring* raw = ring.get();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        raw->thread = static_cast<unsigned>(rings.size()) + 1;
+        rings.push_back(std::move(ring));
+    }
+    known.emplace_back(id, raw);
+    cached_id = id;
+    cached = raw;
+    return *raw;
+}
+
+/**
+ * @brief Запись интервала в буфер текущего потока
+ * @param stage Этап
+ * @param session Номер сессии
+ * @param start Начало, нс
+ * @param end Конец, нс
+ */
+void Tracer::append(Stage stage, uint64_t session, uint64_t start, uint64_t end) {
+    Ring& ring = local();
+    uint64_t h = ring.head.load(std::memory_order_relaxed);
+    Ring::Event& e = ring.events[h & (capacity - 1)];
+    e.start.store(start, std::memory_order_relaxed);
+    e.end.store(end, std::memory_order_relaxed);
+    e.tag.store(session << 8 | static_cast<uint64_t>(stage), std::memory_order_relaxed);
+    ring.head.store(h + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Получение количества сохраненных интервалов
+ * @return Интервалы во всех буферах
+ */
+size_t Tracer::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t total = 0;
+    for (const auto& ring : rings) {
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        total += static_cast<size_t>(head < capacity ? head : capacity);
+    }
+    return total;
+}
+
+/**
+ * @brief Сохранение интервалов в формате Chrome trace_event
+ * @param path Путь к файлу JSON
+ * @return true - файл записан, false - ошибка записи
+ * @details Интервалы выводятся событиями "X" (complete event) с ts и dur
+ *          в микросекундах от создания трассировщика. После копирования буфера
+ *          head читается повторно, и интервалы, которые поток мог перезаписать
+ *          за время чтения, отбрасываются. Из заполненного буфера поэтому
+ *          выводится не больше capacity - 1 интервалов: самая старая ячейка может
+ *          перезаписываться в этот момент
+ */
+bool Tracer::write(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+    int pid = static_cast<int>(getpid());
+    std::fprintf(file, "{\"traceEvents\": [\n");
+    std::fprintf(file, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"args\": {\"name\": \"vcalc server\"}}", pid);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& ring : rings) {
+        std::fprintf(file, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, \"tid\": %u, "
+                     "\"args\": {\"name\": \"thread %u\"}}", pid, ring->thread, ring->thread);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t first = head > capacity ? head - capacity : 0;
+        struct Copy {
+            uint64_t start, end, tag;
+        };
+        std::vector<Copy> copies;
+        copies.reserve(static_cast<size_t>(head - first));
+        for (uint64_t i = first; i < head; ++i) {
+            const Ring::Event& e = ring->events[i & (capacity - 1)];
+            copies.push_back(Copy{e.start.load(std::memory_order_relaxed), e.end.load(std::memory_order_relaxed),
+                                  e.tag.load(std::memory_order_relaxed)});
+        }
+        uint64_t after = ring->head.load(std::memory_order_acquire);
+        uint64_t valid_from = after + 1 > capacity ? after + 1 - capacity : 0;
+        for (uint64_t i = first; i < head; ++i) {
+            if (i < valid_from) {
+                continue;
+            }
+            const Copy& c = copies[static_cast<size_t>(i - first)];
+            size_t stage = static_cast<size_t>(c.tag & 0xFF);
+            if (stage >= static_cast<size_t>(Stage::Count) || c.start < origin || c.end < c.start) {
+                continue;
+            }
+            std::fprintf(file, ",\n{\"name\": \"%s\", \"cat\": \"session\", \"ph\": \"X\", \"ts\": %.3f, "
+                         "\"dur\": %.3f, \"pid\": %d, \"tid\": %u, \"args\": {\"session\": %llu}}",
+                         stageNames[stage], (c.start - origin) / 1000.0, (c.end - c.start) / 1000.0,
+                         pid, ring->thread, static_cast<unsigned long long>(c.tag >> 8));
+        }
+    }
+    std::fprintf(file, "\n],\n\"displayTimeUnit\": \"ms\"}\n");
+    bool ok = std::ferror(file) == 0;
+    return std::fclose(file) == 0 && ok;
+}
@@ -7,24 +7,209 @@
 #include "Logger.h"
 #include <fstream>
 #include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <limits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <chrono>
+
+const char UserDatabase::BINARY_MAGIC[8] = {'V', 'C', 'A', 'L', 'C', 'U', 'D', 'B'};
+
+namespace {
+
+/**
+ * @brief Хеширование логина (FNV-1a, 64 бита)
+ * @param login Логин
+ * @return 64-битный хеш: младшие биты задают ячейку, старшие хранятся в ячейке
+ * @details Хеш входит в двоичный формат базы, поэтому не должен зависеть
+ *          от реализации стандартной библиотеки
+ */
+inline uint64_t hashLogin(std::string_view login) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : login) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash ^ (hash >> 29); // перемешивание старших бит в младшие, задающие ячейку
+}
+
+/**
+ * @brief Запись буфера в файл целиком
+ * @param fd Дескриптор файла
+ * @param data Данные
+ * @param size Размер данных
+ * @return true - данные записаны
+ */
+bool writeAll(int fd, const void* data, size_t size) {
+    const char* ptr = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t rc = ::write(fd, ptr, size);
+        if (rc == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        ptr += rc;
+        size -= static_cast<size_t>(rc);
+    }
+    return true;
+}
+
+}
+
+/**
+ * @brief Деструктор снимка
+ * @details Снимает отображение двоичной базы
+ */
+UserDatabase::Snapshot::~Snapshot() {
+    if (mapping != nullptr) {
+        munmap(mapping, mappingSize);
+    }
+}
 
 /**
- * @brief Загрузка базы данных пользователей из текстового файла
+ * @brief Закрепление текущего снимка
+ * @param db База пользователей
+ * @details Читатель увеличивает счетчик своей эпохи и проверяет, что эпоха не сменилась;
+ *          только после этого он читает указатель на снимок. Поэтому писатель, сменивший
+ *          снимок и эпоху, дождется всех читателей, которые могли получить старый снимок
+ * @note Увеличение счетчика и проверка эпохи выполняются с memory_order_seq_cst, как и
+ *       смена эпохи и чтение счетчика писателем: при более слабом порядке запись и
+ *       последующее чтение другой переменной могут переставиться, и обе стороны
+ *       пропустят друг друга
+ */
+UserDatabase::Reader::Reader(const UserDatabase& db) {
+    while (true) {
+        unsigned e = db.epoch.load();
+        counter = &db.readers[e & 1].count;
+        counter->fetch_add(1, std::memory_order_seq_cst);
+        if (db.epoch.load(std::memory_order_seq_cst) == e) {
+            break;
+        }
+        counter->fetch_sub(1, std::memory_order_release);
+    }
+    snapshot = db.current.load();
+}
+
+/**
+ * @brief Деструктор
+ * @details Освобождает текущий снимок
+ */
+UserDatabase::~UserDatabase() {
+    delete current.load();
+}
+
+/**
+ * @brief Загрузка базы данных пользователей из файла
  * @param db_path Путь к файлу базы данных
  * @param logger Ссылка на журнал для записи ошибок
  * @return true - база успешно загружена,
  *         false - произошла критическая ошибка
+ * @details Файл, начинающийся с сигнатуры BINARY_MAGIC, отображается в память,
+ *          остальные файлы разбираются как текстовые. Новый снимок строится без
+ *          блокировок и публикуется только после успешной загрузки, поэтому при ошибке
+ *          действующая база сохраняется
+ */
+bool UserDatabase::load(const std::string& db_path, Logger& logger) {
+    int fd = open(db_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        logger.logError("Cannot open database file: " + db_path, true);
+        return false;
+    }
+    char magic[sizeof(BINARY_MAGIC)];
+    bool binary = pread(fd, magic, sizeof(magic), 0) == static_cast<ssize_t>(sizeof(magic)) &&
+                  std::memcmp(magic, BINARY_MAGIC, sizeof(magic)) == 0;
+    std::unique_ptr<Snapshot> snapshot;
+    if (binary) {
+        snapshot = loadBinary(fd, db_path, logger);
+        close(fd);
+    } else {
+        close(fd);
+        snapshot = loadText(db_path, logger);
+    }
+    if (!snapshot) {
+        return false;
+    }
+
+    size_t users = snapshot->userCount;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        publish(std::move(snapshot));
+        dbPath = db_path;
+    }
+    logger.logInfo("Loaded " + std::to_string(users) + " users from " +
+                   (binary ? "binary" : "text") + " database");
+    return true;
+}
+
+/**
+ * @brief Повторная загрузка базы из последнего загруженного файла
+ * @param logger Ссылка на объект журнала для записи ошибок
+ * @return true - новая база опубликована,
+ *         false - ошибка загрузки (действующая база сохраняется)
+ */
+bool UserDatabase::reload(Logger& logger) {
+    std::string db_path = path();
+    if (db_path.empty()) {
+        logger.logError("User database reload requested before initial load", false);
+        return false;
+    }
+    logger.logInfo("Reloading user database " + db_path);
+    return load(db_path, logger);
+}
+
+/**
+ * @brief Получение пути к загруженной базе
+ * @return Путь к файлу последней успешной загрузки
+ */
+std::string UserDatabase::path() {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return dbPath;
+}
+
+/**
+ * @brief Публикация нового снимка
+ * @param snapshot Новый снимок
+ * @details После замены указателя эпоха сменяется, и писатель ждет завершения читателей
+ *          прежней эпохи - только они могли закрепить старый снимок. Новые читатели
+ *          получают новый снимок и не задерживаются
+ */
+void UserDatabase::publish(std::unique_ptr<Snapshot> snapshot) {
+    Snapshot* old = current.exchange(snapshot.release());
+    unsigned e = epoch.load();
+    epoch.store(e + 1, std::memory_order_seq_cst);
+    while (readers[e & 1].count.load(std::memory_order_seq_cst) != 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    delete old;
+}
+
+/**
+ * @brief Загрузка текстовой базы
+ * @param db_path Путь к файлу
+ * @param logger Ссылка на журнал
+ * @return Новый снимок или nullptr при ошибке
  * @details Формат файла: каждая строка "логин:пароль"
- *          Пустые строки и строки, начинающиеся с '#', игнорируются
+ *          Пустые строки и строки, начинающиеся с '#', игнорируются.
+ *          Записи сначала собираются в буфер, затем индекс строится один раз с емкостью
+ *          не меньше удвоенного числа записей. При повторе логина действует последняя запись
  * @note Не критические ошибки (неверный формат строки) записываются в журнал, но не прерывают загрузку
  */
-bool UserDatabase::load(const std::string& db_path, Logger& logger) {
+std::unique_ptr<UserDatabase::Snapshot> UserDatabase::loadText(const std::string& db_path, Logger& logger) {
     std::ifstream file(db_path);
     if (!file.is_open()) {
         logger.logError("Cannot open database file: " + db_path, true);
-        return false;
+        return nullptr;
     }
 
+    std::vector<char> new_arena;
+    std::vector<Slot> entries;
     std::string line;
     int line_number = 0;
     while (std::getline(file, line)) {
@@ -37,36 +222,226 @@ bool UserDatabase::load(const std::string& db_path, Logger& logger) {
             logger.logError("Invalid string format " + std::to_string(line_number), false);
             continue;
         }
-        std::string login = line.substr(0, pos);
-        std::string password = line.substr(pos + 1);
-        if (login.empty() || password.empty()) {
+        size_t password_length = line.size() - pos - 1;
+        if (pos == 0 || password_length == 0) {
             logger.logError("Empty login or password on line " + std::to_string(line_number), false);
             continue;
         }
-        users[login] = password;
+        if (new_arena.size() + line.size() > std::numeric_limits<uint32_t>::max()) {
+            logger.logError("User database is too large: " + db_path, true);
+            return nullptr;
+        }
+        uint64_t hash = hashLogin(std::string_view(line.data(), pos));
+        entries.push_back(Slot{static_cast<uint32_t>(hash >> 32), static_cast<uint32_t>(new_arena.size()),
+                               static_cast<uint32_t>(pos), static_cast<uint32_t>(password_length)});
+        new_arena.insert(new_arena.end(), line.begin(), line.begin() + pos);
+        new_arena.insert(new_arena.end(), line.begin() + pos + 1, line.end());
     }
     file.close();
 
-    if (users.empty()) {
+    if (entries.empty()) {
+        logger.logError("User database is empty", true);
+        return nullptr;
+    }
+
+    size_t capacity = 16;
+    while (capacity < entries.size() * 2) {
+        capacity <<= 1;
+    }
+    std::vector<Slot> new_table(capacity, Slot{0, 0, 0, 0});
+    size_t mask = capacity - 1;
+    size_t count = 0;
+    for (const Slot& entry : entries) {
+        std::string_view login(new_arena.data() + entry.offset, entry.loginLength);
+        size_t index = hashLogin(login) & mask;
+        while (true) {
+            Slot& slot = new_table[index];
+            if (slot.loginLength == 0) {
+                slot = entry;
+                ++count;
+                break;
+            }
+            if (slot.hash == entry.hash && slot.loginLength == entry.loginLength &&
+                std::memcmp(new_arena.data() + slot.offset, login.data(), login.size()) == 0) {
+                slot = entry; // повтор логина: действует последняя запись
+                break;
+            }
+            index = (index + 1) & mask;
+        }
+    }
+
+    std::unique_ptr<Snapshot> snapshot(new Snapshot);
+    snapshot->arena.swap(new_arena);
+    snapshot->table.swap(new_table);
+    snapshot->arenaData = snapshot->arena.data();
+    snapshot->arenaSize = snapshot->arena.size();
+    snapshot->slots = snapshot->table.data();
+    snapshot->slotCount = snapshot->table.size();
+    snapshot->userCount = count;
+    return snapshot;
+}
+
+/**
+ * @brief Отображение двоичной базы в память
+ * @param fd Дескриптор открытого файла
+ * @param db_path Путь к файлу (для сообщений)
+ * @param logger Ссылка на журнал
+ * @return Новый снимок или nullptr при ошибке
+ * @details Проверяется только заголовок, поэтому время загрузки не зависит от размера
+ *          базы; границы записей индекса проверяются при поиске. Файл отображается
+ *          только для чтения, страницы подгружаются по мере обращений
+ */
+std::unique_ptr<UserDatabase::Snapshot> UserDatabase::loadBinary(int fd, const std::string& db_path, Logger& logger) {
+    struct stat st;
+    if (fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(FileHeader)) {
+        logger.logError("Corrupted binary database: " + db_path, true);
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* ptr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+        logger.logError("Cannot map database file: " + db_path + ": " + strerror(errno), true);
+        return nullptr;
+    }
+    madvise(ptr, size, MADV_RANDOM); // поиск обращается к случайным страницам, упреждающее чтение не нужно
+
+    const FileHeader* header = static_cast<const FileHeader*>(ptr);
+    uint64_t slots_end = header->slotsOffset + uint64_t(header->slotCount) * sizeof(Slot);
+    bool valid = header->version == BINARY_VERSION &&
+                 header->slotCount >= 2 && (header->slotCount & (header->slotCount - 1)) == 0 &&
+                 header->userCount > 0 && header->userCount < header->slotCount &&
+                 header->slotsOffset >= sizeof(FileHeader) && header->slotsOffset % alignof(Slot) == 0 &&
+                 slots_end <= size &&
+                 header->arenaOffset >= slots_end && header->arenaOffset <= size &&
+                 header->arenaSize <= size - header->arenaOffset;
+    if (!valid) {
+        munmap(ptr, size);
+        logger.logError("Corrupted binary database: " + db_path, true);
+        return nullptr;
+    }
+
+    std::unique_ptr<Snapshot> snapshot(new Snapshot);
+    snapshot->mapping = ptr;
+    snapshot->mappingSize = size;
+    const char* base = static_cast<const char*>(ptr);
+    snapshot->slots = reinterpret_cast<const Slot*>(base + header->slotsOffset);
+    snapshot->slotCount = header->slotCount;
+    snapshot->arenaData = base + header->arenaOffset;
+    snapshot->arenaSize = header->arenaSize;
+    snapshot->userCount = header->userCount;
+    return snapshot;
+}
+
+/**
+ * @brief Сохранение базы в двоичном формате
+ * @param db_path Путь к создаваемому файлу
+ * @param logger Ссылка на объект журнала для записи ошибок
+ * @return true - файл записан,
+ *         false - ошибка записи или база не загружена
+ * @details Структура файла: заголовок FileHeader, индекс со смещения 64,
+ *          затем буфер строк
+ */
+bool UserDatabase::save(const std::string& db_path, Logger& logger) const {
+    Reader reader(*this);
+    const Snapshot* snapshot = reader.snapshot;
+    if (snapshot == nullptr) {
         logger.logError("User database is empty", true);
         return false;
     }
-    logger.logInfo("Loaded " + std::to_string(users.size()) + " users from database");
+    size_t slotCount = snapshot->slotCount;
+    FileHeader header{};
+    std::memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+    header.version = BINARY_VERSION;
+    header.slotCount = static_cast<uint32_t>(slotCount);
+    header.userCount = snapshot->userCount;
+    header.slotsOffset = 64;
+    header.arenaOffset = header.slotsOffset + slotCount * sizeof(Slot);
+    header.arenaSize = snapshot->arenaSize;
+
+    std::string tmp_path = db_path + ".tmp";
+    int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        logger.logError("Cannot create database file: " + tmp_path + ": " + strerror(errno), true);
+        return false;
+    }
+    char padding[64] = {};
+    bool written = writeAll(fd, &header, sizeof(header)) &&
+                   writeAll(fd, padding, header.slotsOffset - sizeof(header)) &&
+                   writeAll(fd, snapshot->slots, slotCount * sizeof(Slot)) &&
+                   writeAll(fd, snapshot->arenaData, snapshot->arenaSize) &&
+                   fsync(fd) == 0;
+    written = close(fd) == 0 && written;
+    if (!written || std::rename(tmp_path.c_str(), db_path.c_str()) != 0) {
+        logger.logError("Cannot write database file: " + db_path + ": " + strerror(errno), true);
+        std::remove(tmp_path.c_str());
+        return false;
+    }
     return true;
 }
 
 /**
- * @brief Получение пароля пользователя по логину
+ * @brief Поиск пароля по логину в снимке
+ * @param login Логин пользователя
+ * @param out_password Представление пароля в буфере снимка
+ * @return true - пользователь найден
+ * @details Пробирование идет от ячейки хеша до первой пустой ячейки, но не дальше
+ *          размера индекса. Запись, выходящая за буфер строк, считается отсутствующей
+ */
+bool UserDatabase::Snapshot::find(std::string_view login, std::string_view& out_password) const {
+    if (login.empty()) {
+        return false;
+    }
+    uint64_t hash = hashLogin(login);
+    uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    size_t mask = slotCount - 1;
+    size_t index = hash & mask;
+    for (size_t probe = 0; probe < slotCount; ++probe, index = (index + 1) & mask) {
+        const Slot& slot = slots[index];
+        if (slot.loginLength == 0) {
+            return false;
+        }
+        if (slot.hash == tag && slot.loginLength == login.size() &&
+            uint64_t(slot.offset) + slot.loginLength + slot.passwordLength <= arenaSize &&
+            std::memcmp(arenaData + slot.offset, login.data(), login.size()) == 0) {
+            out_password = std::string_view(arenaData + slot.offset + slot.loginLength, slot.passwordLength);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Получение копии пароля пользователя по логину
  * @param login Логин пользователя
  * @param out_password Строка для записи пароля
  * @return true - пользователь найден, пароль записан в out_password,
  *         false - пользователь не найден
+ * @details Снимок закрепляется на время копирования
  */
-bool UserDatabase::getPassword(const std::string& login, std::string& out_password) const {
-    auto it = users.find(login);
-    if (it != users.end()) {
-        out_password = it->second;
-        return true;
+bool UserDatabase::getPassword(std::string_view login, std::string& out_password) const {
+    Reader reader(*this);
+    std::string_view password;
+    if (!reader.getPassword(login, password)) {
+        return false;
     }
-    return false;
+    out_password.assign(password.data(), password.size());
+    return true;
+}
+
+/**
+ * @brief Получение количества пользователей
+ * @return Количество пользователей текущего снимка
+ */
+size_t UserDatabase::size() const {
+    Reader reader(*this);
+    return reader.size();
+}
+
+/**
+ * @brief Проверка режима хранения
+ * @return true - текущий снимок отображен из двоичного файла
+ */
+bool UserDatabase::isMapped() const {
+    Reader reader(*this);
+    return reader.snapshot != nullptr && reader.snapshot->mapping != nullptr;
 }
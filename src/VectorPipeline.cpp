@@ -0,0 +1,115 @@
+/**
+ * @file VectorPipeline.cpp
+ * @brief Реализация класса VectorPipeline - вычисления векторов параллельно с приемом
+ */
+
+#include "VectorPipeline.h"
+#include "DataProcessor.h"
+#include "Tracer.h"
+#include <chrono>
+
+/**
+ * @brief Конструктор
+ * @param processor Обработчик данных
+ * @param logger Журнал для записи ошибок вычисления
+ */
+VectorPipeline::VectorPipeline(DataProcessor& processor, Logger& logger)
+    : processor(processor), logger(logger), data(nullptr), count(0), trace(0), queued(false), stopping(false),
+      result{0, 0}, pending(false), worker(&VectorPipeline::run, this)
+{
+}
+
+/**
+ * @brief Деструктор
+ * @details Дожидается текущего вычисления и останавливает поток
+ */
+VectorPipeline::~VectorPipeline() {
+    drain();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    submitted.notify_one();
+    worker.join();
+}
+
+/**
+ * @brief Передача вектора на вычисление
+ * @param data Элементы вектора
+ * @param count Количество элементов
+ * @param trace Номер трассируемой сессии (0 - не трассируется)
+ */
+void VectorPipeline::submit(const int32_t* data, size_t count, uint64_t trace) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->data = data;
+        this->count = count;
+        this->trace = trace;
+        queued = true;
+    }
+    pending = true;
+    submitted.notify_one();
+}
+
+/**
+ * @brief Ожидание результата переданного вектора
+ * @return Результат вычисления
+ * @throw Исключение, выброшенное при вычислении
+ */
+VectorPipeline::Result VectorPipeline::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return !queued; });
+    pending = false;
+    if (error) {
+        std::exception_ptr e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+    return result;
+}
+
+/**
+ * @brief Ожидание завершения вычисления без получения результата
+ */
+void VectorPipeline::drain() {
+    if (!pending) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return !queued; });
+    pending = false;
+    error = nullptr;
+}
+
+/**
+ * @brief Тело потока вычисления
+ * @details Интервал вычисления записывается в трассу сессии, передавшей вектор
+ */
+void VectorPipeline::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        submitted.wait(lock, [this] { return stopping || queued; });
+        if (!queued) {
+            return;
+        }
+        lock.unlock();
+
+        Result value{0, 0};
+        std::exception_ptr failure;
+        auto started = std::chrono::steady_clock::now();
+        try {
+            Tracer::Scope scope(trace);
+            value.value = processor.calculateAverage(data, count, logger);
+        } catch (...) {
+            failure = std::current_exception();
+        }
+        value.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - started).count();
+
+        lock.lock();
+        result = value;
+        error = failure;
+        queued = false;
+        finished.notify_one();
+    }
+}
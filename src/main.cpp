@@ -11,12 +11,25 @@
  * @section usage_sec Использование
  *
  * Запуск сервера:
- * ./server [--file FILE] [--log FILE] [--port PORT]
+ * ./server [--file FILE] [--log FILE] [--port PORT] [--io epoll|uring|blocking] [--workers N] [--stream] [--huge-pages]
+ *          [--pipeline]
+ *          [--parallel-threshold N] [--compute-threads N] [--async-log] [--log-queue N] [--log-overflow block|drop]
+ *          [--log-level trace|debug|info|warning|error|critical|off] [--log-format text|binary]
+ *          [--log-rotate-size BYTES] [--log-rotate-interval SEC] [--log-keep N] [--log-compress]
+ *          [--watch-db] [--hash sha1|sha256] [--tickets] [--ticket-lifetime SEC] [--ticket-secret FILE]
+ *          [--auth-throttle N] [--auth-throttle-window SEC] [--metrics-port PORT]
+ *          [--trace-file FILE] [--trace-sample N]
  * 
  * Вывод справки:
  * ./server --help
  * ./server -h
  *
+ * Перезагрузка базы пользователей без перезапуска:
+ * kill -HUP <pid>
+ *
+ * Сохранение трассы этапов сессий (с параметром --trace-file):
+ * kill -USR1 <pid>
+ *
  */
 
 #include "Interface.h"
@@ -24,9 +37,24 @@
 #include "UserDatabase.h"
 #include "DataProcessor.h"
 #include "Authenticator.h"
+#include "Digest.h"
+#include "TicketManager.h"
+#include "AuthThrottle.h"
 #include "Server.h"
+#include "ThreadPool.h"
+#include "DbReloader.h"
+#include "Metrics.h"
+#include "MetricsServer.h"
+#include "Tracer.h"
 #include <iostream>
+#include <memory>
 #include <string>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+#include <csignal>
+#include <pthread.h>
+#include <functional>
 
 /**
  * @brief Проверка валидности номера порта
@@ -39,6 +67,51 @@ bool isValidPort(unsigned short port) {
     return port >= 1024 && port <= 49151;
 }
 
+/**
+ * @brief Тело потока обработки сигналов
+ * @param signals Набор сигналов, заблокированных во всех потоках
+ * @param logger Журнал
+ * @param reloader Поток перезагрузки базы пользователей
+ * @param tracer Трассировщик сессий (nullptr - трассировка отключена)
+ * @param trace_file Файл трассы
+ * @details SIGHUP запрашивает перезагрузку базы пользователей, SIGUSR1 (при трассировке)
+ *          сохраняет трассу. SIGINT и SIGTERM (обрабатываются при асинхронном журнале
+ *          или трассировке) сохраняют трассу, останавливают журнал - очередь
+ *          дописывается и сбрасывается на диск - и завершают процесс
+ */
+void handleSignals(sigset_t signals, Logger& logger, DbReloader& reloader, const Tracer* tracer,
+                   std::string trace_file) {
+    auto write_trace = [&] {
+        if (tracer == nullptr) {
+            return;
+        }
+        if (tracer->write(trace_file)) {
+            logger.logInfo("Trace written to " + trace_file + " (" + std::to_string(tracer->size()) + " spans)");
+        } else {
+            logger.logError("Cannot write trace file " + trace_file, false);
+        }
+    };
+    while (true) {
+        int sig = 0;
+        if (sigwait(&signals, &sig) != 0) {
+            continue;
+        }
+        if (sig == SIGHUP) {
+            logger.logInfo("Received SIGHUP, reloading user database");
+            reloader.requestReload();
+            continue;
+        }
+        if (sig == SIGUSR1) {
+            write_trace();
+            continue;
+        }
+        logger.logInfo("Received signal " + std::to_string(sig) + ", shutting down");
+        write_trace();
+        logger.stop();
+        std::_Exit(0);
+    }
+}
+
 /**
  * @brief Главная функция программы
  * @param argc Количество аргументов командной строки
@@ -73,11 +146,40 @@ int main(int argc, char** argv) {
      */
     Params params = iface.getParams();
 
+    /**
+     * @brief Блокировка сигналов, обрабатываемых отдельным потоком
+     * @details Маска устанавливается до создания любых потоков, поэтому все потоки
+     *          наследуют ее, а сигналы принимает только поток handleSignals()
+     */
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGHUP);
+    if (params.asyncLog || !params.traceFile.empty()) {
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+    }
+    if (!params.traceFile.empty()) {
+        sigaddset(&signals, SIGUSR1);
+    }
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
     /**
      * @brief Инициализация системы журналирования
      * @details Настраивает журнал на запись в указанный файл
      */
     logger.init(params.logFile);
+    Logger::Level log_level = Logger::Level::Info;
+    Logger::parseLevel(params.logLevel, log_level);
+    logger.setLevel(log_level);
+    logger.setFormat(params.logFormat == "binary" ? Logger::Format::Binary : Logger::Format::Text);
+    logger.setRotation(params.logRotateSize, params.logRotateInterval, params.logKeep, params.logCompress);
+    if (params.asyncLog) {
+        Logger::OverflowPolicy policy = params.logOverflow == "drop"
+            ? Logger::OverflowPolicy::Drop : Logger::OverflowPolicy::Block;
+        if (!logger.startAsync(params.logQueue, policy)) {
+            std::cerr << "Async log unavailable, writing the log synchronously" << std::endl;
+        }
+    }
     logger.logInfo("Server configuration parsing completed");
 
     /**
@@ -89,13 +191,102 @@ int main(int argc, char** argv) {
         return 1; ///< Критическая ошибка: не удалось загрузить базу данных
     }
 
+    /**
+     * @brief Запуск перезагрузки базы пользователей и обработки сигналов
+     * @details База перезагружается по SIGHUP и, с параметром --watch-db, при изменении файла
+     */
+    DbReloader reloader(userDb, logger);
+    reloader.start(params.watchDb);
+
+    /**
+     * @brief Настройка трассировки этапов сессий
+     * @details Рабочие потоки пишут интервалы в свои кольцевые буферы; трасса
+     *          сохраняется по SIGUSR1 и при завершении по SIGINT/SIGTERM.
+     *          Без --trace-file трассировщик не устанавливается
+     */
+    std::unique_ptr<Tracer> tracer;
+    if (!params.traceFile.empty()) {
+        tracer.reset(new Tracer(params.traceSample));
+        Tracer::install(tracer.get());
+        logger.logInfo("Tracing every " + std::to_string(params.traceSample) + " session(s) to " + params.traceFile);
+    }
+    std::thread(handleSignals, signals, std::ref(logger), std::ref(reloader), tracer.get(), params.traceFile).detach();
+
     /**
      * @brief Инициализация модулей обработки
      * @details Создает объекты для аутентификации и обработки данных
      */
-    Authenticator auth;
+    Digest::Algorithm digest_algorithm = Digest::Algorithm::Sha1;
+    Digest::parse(params.hash, digest_algorithm);
+    Authenticator auth(digest_algorithm);
+
+    /**
+     * @brief Настройка билетов возобновления сессии
+     * @details Общий файл секрета позволяет процессам сервера принимать билеты друг друга
+     */
+    std::unique_ptr<TicketManager> tickets;
+    if (params.tickets) {
+        std::string secret;
+        if (params.ticketSecret.empty()) {
+            secret = TicketManager::generateSecret();
+        } else if (!TicketManager::readSecret(params.ticketSecret, secret)) {
+            logger.logError("Cannot read ticket secret (at least " + std::to_string(TicketManager::MIN_SECRET_LENGTH) +
+                            " bytes) from " + params.ticketSecret, true);
+            return 1;
+        }
+        tickets.reset(new TicketManager(secret, params.ticketLifetime));
+        auth.setTickets(tickets.get());
+        logger.logInfo("Session tickets enabled, lifetime " + std::to_string(params.ticketLifetime) + " s");
+    }
+
+    /**
+     * @brief Настройка ограничения неудачных попыток аутентификации
+     * @details Адрес или логин с этого адреса, набравший порог неудач, отклоняется до затухания счетчика
+     */
+    std::unique_ptr<AuthThrottle> throttle;
+    if (params.authThrottle > 0) {
+        throttle.reset(new AuthThrottle(params.authThrottle, params.authThrottleWindow));
+        auth.setThrottle(throttle.get());
+        logger.logInfo("Auth throttle enabled: " + std::to_string(params.authThrottle) + " failures, half-life " +
+                       std::to_string(params.authThrottleWindow) + " s");
+    }
     DataProcessor processor;
+
+    /**
+     * @brief Настройка экспорта метрик
+     * @details Рабочие потоки пишут метрики в свои блоки счетчиков, отдельный поток
+     *          отдает их по HTTP на GET /metrics. Без --metrics-port метрики не ведутся
+     */
+    std::unique_ptr<Metrics> metrics;
+    std::unique_ptr<MetricsServer> metrics_server;
+    if (params.metricsPort != 0) {
+        metrics.reset(new Metrics());
+        auth.setMetrics(metrics.get());
+        processor.setMetrics(metrics.get());
+        UserDatabase* db = &userDb;
+        metrics->addCallback("vcalc_users", "Users in the loaded database", false,
+                             [db] { return static_cast<double>(db->size()); });
+        DbReloader* db_reloader = &reloader;
+        metrics->addCallback("vcalc_db_reloads_total", "Successful user database reloads", true,
+                             [db_reloader] { return static_cast<double>(db_reloader->reloads()); });
+        metrics->addCallback("vcalc_db_reload_failures_total", "Failed user database reloads", true,
+                             [db_reloader] { return static_cast<double>(db_reloader->failures()); });
+        if (AuthThrottle* limiter = throttle.get()) {
+            metrics->addCallback("vcalc_throttle_rejected_addresses_total", "Connections rejected by the auth throttle", true,
+                                 [limiter] { return static_cast<double>(limiter->rejectedAddresses()); });
+            metrics->addCallback("vcalc_throttle_rejected_logins_total", "Logins rejected by the auth throttle", true,
+                                 [limiter] { return static_cast<double>(limiter->rejectedLogins()); });
+        }
+        metrics_server.reset(new MetricsServer(*metrics, logger));
+        if (!metrics_server->start(params.metricsPort)) {
+            logger.logError("Cannot start metrics endpoint on port " + std::to_string(params.metricsPort), true);
+            return 1;
+        }
+    }
     logger.logInfo("Authenticator and DataProcessor initialized");
+    logger.logInfo("Auth digest: " + std::string(Digest::name(digest_algorithm)) + " (" +
+                   Digest::create(digest_algorithm)->provider() + ")");
+    logger.logInfo("Sum kernel: " + std::string(DataProcessor::kernelName()));
 
     /**
      * @brief Проверка валидности порта
@@ -115,13 +306,65 @@ int main(int argc, char** argv) {
     std::cout << "Database file: " << params.dbFile << std::endl;
     std::cout << "Log file: " << params.logFile << std::endl;
     std::cout << "Port: " << params.port << std::endl;
+    std::cout << "I/O mode: " << params.ioMode << std::endl;
+    std::cout << "Auth hash: " << Digest::name(digest_algorithm) << std::endl;
+    std::cout << "Auth throttle: " << (throttle ? std::to_string(params.authThrottle) + " failures" : "off") << std::endl;
+    std::cout << "Metrics: " << (metrics ? "http://*:" + std::to_string(params.metricsPort) + "/metrics" : "off") << std::endl;
+    std::cout << "Tracing: " << (tracer ? params.traceFile + " (1 of " + std::to_string(params.traceSample) + " sessions)" : "off") << std::endl;
+
+    unsigned workers = params.workers;
+    if (workers == 0) {
+        workers = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    std::cout << "Workers: " << workers << std::endl;
+    std::cout << "Streaming: " << (params.streaming ? "on" : "off") << std::endl;
+    std::cout << "Huge pages: " << (params.hugePages ? "on" : "off") << std::endl;
+    std::cout << "Pipeline: " << (params.pipeline ? "on" : "off") << std::endl;
+    std::cout << "Async log: " << (params.asyncLog ? "on (" + params.logOverflow + " on overflow)" : "off") << std::endl;
+
+    /**
+     * @brief Создание пула потоков для параллельного суммирования
+     * @details Вызывающий рабочий поток участвует в вычислениях, поэтому в пуле
+     *          на один поток меньше, чем задано
+     */
+    unsigned compute_threads = params.computeThreads;
+    if (compute_threads == 0) {
+        compute_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    std::unique_ptr<ThreadPool> compute_pool;
+    if (params.parallelThreshold > 0 && compute_threads > 1) {
+        compute_pool.reset(new ThreadPool(compute_threads - 1));
+        processor.setParallel(compute_pool.get(), params.parallelThreshold);
+        std::cout << "Parallel sums: " << compute_threads << " threads from "
+                  << params.parallelThreshold << " elements" << std::endl;
+    } else {
+        std::cout << "Parallel sums: off" << std::endl;
+    }
+
+    /**
+     * @brief Формирование параметров работы сервера
+     * @details Переводит параметры командной строки в настройки модуля Server
+     */
+    ServerConfig config;
+    if (params.ioMode == "blocking") {
+        config.ioMode = IoMode::Blocking;
+    } else if (params.ioMode == "uring") {
+        config.ioMode = IoMode::Uring;
+    } else {
+        config.ioMode = IoMode::Epoll;
+    }
+    config.workers = workers;
+    config.streaming = params.streaming;
+    config.hugePages = params.hugePages;
+    config.pipeline = params.pipeline;
+    config.metrics = metrics.get();
 
     /**
      * @brief Создание и запуск сервера
      * @details Основной блок выполнения программы
      */
     try {
-        Server server(params.port, logger, userDb, auth, processor);
+        Server server(params.port, logger, userDb, auth, processor, config);
         server.run(); ///< Запуск основного цикла сервера
     } catch (const std::exception& e) {
         /**
@@ -0,0 +1,96 @@
+#include <UnitTest++/UnitTest++.h>
+#include "AuthThrottle.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+SUITE(AuthThrottleTest)
+{
+    const uint32_t NOW = 6000; // начало окна при периоде 60 с
+
+    TEST(BlockAfterLimit) { // Тест 1: Адрес отклоняется после порога неудач
+        AuthThrottle throttle(3, 60);
+        for (int i = 0; i < 2; ++i) {
+            throttle.recordFailure("10.0.0.1", "", NOW);
+        }
+        CHECK_EQUAL(true, throttle.allowAddress("10.0.0.1", NOW));
+        throttle.recordFailure("10.0.0.1", "", NOW);
+        CHECK_EQUAL(false, throttle.allowAddress("10.0.0.1", NOW));
+        CHECK_EQUAL(true, throttle.allowAddress("10.0.0.2", NOW));
+        CHECK_EQUAL(1u, throttle.rejectedAddresses());
+    }
+
+    TEST(LoginCounted) { // Тест 2: Неудачи учитываются по логину для каждого адреса
+        AuthThrottle throttle(2, 60);
+        throttle.recordFailure("10.0.0.1", "admin", NOW);
+        throttle.recordFailure("10.0.0.1", "admin", NOW);
+        CHECK_EQUAL(false, throttle.allowLogin("10.0.0.1", "admin", NOW));
+        CHECK_EQUAL(true, throttle.allowLogin("10.0.0.1", "user", NOW));
+        CHECK_EQUAL(true, throttle.allowLogin("10.0.0.2", "admin", NOW));
+        CHECK_EQUAL(false, throttle.allowAddress("10.0.0.1", NOW));
+        CHECK_EQUAL(1u, throttle.rejectedLogins());
+        CHECK_EQUAL(1u, throttle.rejectedAddresses());
+    }
+
+    TEST(OwnerNotLockedOut) { // Тест 3: Неудачи с чужих адресов не блокируют логин владельцу
+        AuthThrottle throttle(2, 60);
+        for (int i = 0; i < 100; ++i) {
+            throttle.recordFailure("10.0.1." + std::to_string(i), "admin", NOW);
+        }
+        CHECK_EQUAL(true, throttle.allowLogin("10.0.0.1", "admin", NOW));
+        CHECK_EQUAL(true, throttle.allowAddress("10.0.0.1", NOW));
+        CHECK_EQUAL(0u, throttle.rejectedLogins());
+    }
+
+    TEST(EmptyLoginSkipped) { // Тест 4: Пустой логин не учитывается
+        AuthThrottle throttle(1, 60);
+        throttle.recordFailure("10.0.0.1", "", NOW);
+        CHECK_EQUAL(0u, throttle.loginFailures("10.0.0.1", "", NOW));
+        CHECK_EQUAL(1u, throttle.addressFailures("10.0.0.1", NOW));
+    }
+
+    TEST(Decay) { // Тест 5: Счетчик уменьшается вдвое за каждый период
+        AuthThrottle throttle(8, 60);
+        for (int i = 0; i < 8; ++i) {
+            throttle.recordFailure("10.0.0.1", "admin", NOW);
+        }
+        CHECK_EQUAL(false, throttle.allowAddress("10.0.0.1", NOW + 59));
+        CHECK_EQUAL(4u, throttle.addressFailures("10.0.0.1", NOW + 60));
+        CHECK_EQUAL(2u, throttle.loginFailures("10.0.0.1", "admin", NOW + 120));
+        CHECK_EQUAL(true, throttle.allowAddress("10.0.0.1", NOW + 60));
+        CHECK_EQUAL(0u, throttle.addressFailures("10.0.0.1", NOW + 60 * 40));
+    }
+
+    TEST(FewCollisions) { // Тест 6: Неудачи многих адресов не блокируют остальные
+        AuthThrottle throttle(5, 60);
+        for (int a = 0; a < 2000; ++a) {
+            std::string address = "10.1." + std::to_string(a / 256) + "." + std::to_string(a % 256);
+            for (int i = 0; i < 4; ++i) {
+                throttle.recordFailure(address, "", NOW);
+            }
+        }
+        int blocked = 0;
+        for (int a = 0; a < 2000; ++a) {
+            std::string address = "10.2." + std::to_string(a / 256) + "." + std::to_string(a % 256);
+            blocked += throttle.allowAddress(address, NOW) ? 0 : 1;
+        }
+        CHECK_EQUAL(0, blocked);
+    }
+
+    TEST(ConcurrentFailures) { // Тест 7: Параллельный учет неудач не теряет обновлений
+        AuthThrottle throttle(1000000, 60);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&throttle] {
+                for (int i = 0; i < 10000; ++i) {
+                    throttle.recordFailure("10.0.0.1", "admin", NOW);
+                }
+            });
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+        CHECK_EQUAL(40000u, throttle.addressFailures("10.0.0.1", NOW));
+        CHECK_EQUAL(40000u, throttle.loginFailures("10.0.0.1", "admin", NOW));
+    }
+}
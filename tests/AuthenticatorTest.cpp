@@ -2,8 +2,12 @@
 #include "Authenticator.h"
 #include "UserDatabase.h"
 #include "Logger.h"
+#include "TicketManager.h"
+#include "AuthThrottle.h"
+#include "Metrics.h"
 #include <fstream>
 #include <cstdio>
+#include <cctype>
 #include <cryptopp/sha.h>
 #include <cryptopp/hex.h>
 
@@ -99,4 +103,124 @@ SUITE(AuthenticatorTest)
         std::string auth_data = valid_salt + valid_hash;
         CHECK_EQUAL(true, auth.verify("user", auth_data, db, logger));
     }
-}
\ No newline at end of file
+
+    TEST_FIXTURE(AuthTestFixture, LowercaseHash) { // Тест 9: Хеш в нижнем регистре
+        std::string salt = "abcdef0123456789";
+        std::string hash = computeValidHash(salt, "testpassword");
+        for (char& c : hash) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        CHECK_EQUAL(true, auth.verify("testuser", salt + hash, db, logger));
+    }
+
+    TEST_FIXTURE(AuthTestFixture, LastByteMismatch) { // Тест 10: Хеш, отличающийся последним байтом
+        std::string salt = "1234567890ABCDEF";
+        std::string hash = computeValidHash(salt, "P@ssW0rd");
+        hash[39] = (hash[39] == '0') ? '1' : '0';
+        CHECK_EQUAL(false, auth.verify("user", salt + hash, db, logger));
+        CHECK_EQUAL(true, auth.verify("user", salt + computeValidHash(salt, "P@ssW0rd"), db, logger));
+    }
+
+    TEST_FIXTURE(AuthTestFixture, Sha256Authentication) { // Тест 11: Аутентификация с SHA-256
+        Authenticator auth256(Digest::Algorithm::Sha256);
+        CHECK_EQUAL(80u, auth256.authDataLength());
+        
+        std::string salt = "1234567890ABCDEF";
+        std::string input = salt + "P@ssW0rd";
+        std::string hash;
+        SHA256 sha256;
+        StringSource(input, true,
+            new HashFilter(sha256,
+                new HexEncoder(
+                    new StringSink(hash))));
+        
+        CHECK_EQUAL(true, auth256.verify("user", salt + hash, db, logger));
+        CHECK_EQUAL(false, auth256.verify("user", salt + computeValidHash(salt, "P@ssW0rd"), db, logger));
+        CHECK_EQUAL(56u, auth.authDataLength());
+    }
+
+    TEST_FIXTURE(AuthTestFixture, ResumeWithTicket) { // Тест 12: Возобновление сессии по билету
+        TicketManager tickets("0123456789abcdef0123456789abcdef", 300);
+        std::string salt = "1234567890ABCDEF";
+        std::string password_auth = "user" + salt + computeValidHash(salt, "P@ssW0rd");
+        CHECK_EQUAL("", auth.issueTicket(password_auth, "user"));
+        CHECK_EQUAL(false, auth.isResume("RESUME:"));
+        
+        auth.setTickets(&tickets);
+        std::string ticket = auth.issueTicket(password_auth, "user");
+        CHECK_EQUAL(TicketManager::TICKET_LENGTH, ticket.size());
+        
+        std::string message = "RESUME:" + ticket + "user";
+        std::string login;
+        CHECK_EQUAL(true, auth.isResume(message));
+        CHECK_EQUAL(true, auth.resume(message, login, logger));
+        CHECK_EQUAL("user", login);
+        
+        CHECK_EQUAL(false, auth.resume("RESUME:" + ticket + "admin", login, logger));
+        CHECK_EQUAL(false, auth.resume("RESUME:" + ticket, login, logger));
+    }
+
+    TEST_FIXTURE(AuthTestFixture, ResumeKeepsExpiry) { // Тест 13: Возобновление не продлевает билет
+        TicketManager tickets("0123456789abcdef0123456789abcdef", 300);
+        auth.setTickets(&tickets);
+        time_t now = std::time(nullptr);
+        std::string ticket = tickets.issue("user", now - 100);
+        
+        std::string message = "RESUME:" + ticket + "user";
+        std::string login;
+        CHECK_EQUAL(true, auth.resume(message, login, logger));
+        std::string renewed = auth.issueTicket(message, login);
+        CHECK_EQUAL(ticket, renewed);
+        CHECK_EQUAL(false, tickets.validate("user", renewed, now + 250));
+        
+        std::string salt = "1234567890ABCDEF";
+        std::string fresh = auth.issueTicket("user" + salt + computeValidHash(salt, "P@ssW0rd"), "user");
+        CHECK_EQUAL(true, tickets.validate("user", fresh, now + 250));
+    }
+
+    TEST_FIXTURE(AuthTestFixture, AuthenticateStatus) { // Тест 14: Коды результата аутентификации
+        std::string salt = "1234567890ABCDEF";
+        std::string login;
+        SessionStatus ok = auth.authenticate("user" + salt + computeValidHash(salt, "P@ssW0rd"), "10.0.0.1", db, logger, login);
+        CHECK(ok.isOk());
+        CHECK_EQUAL("user", login);
+        
+        SessionStatus failed = auth.authenticate("user" + salt + std::string(40, '0'), "10.0.0.1", db, logger, login);
+        CHECK(failed.code() == SessionStatus::Code::AuthFailed);
+        CHECK_EQUAL("Auth error: Authentication failed for login user", failed.message());
+        
+        SessionStatus short_msg = auth.authenticate("short", "10.0.0.1", db, logger, login);
+        CHECK(short_msg.code() == SessionStatus::Code::AuthTooShort);
+        CHECK(short_msg.isAuthError());
+    }
+
+    TEST_FIXTURE(AuthTestFixture, AuthenticateThrottled) { // Тест 15: Отказ логину, превысившему порог неудач с адреса
+        AuthThrottle throttle(2, 60);
+        auth.setThrottle(&throttle);
+        std::string salt = "1234567890ABCDEF";
+        std::string bad = "user" + salt + std::string(40, '0');
+        std::string login;
+        CHECK(auth.authenticate(bad, "10.0.0.1", db, logger, login).code() == SessionStatus::Code::AuthFailed);
+        CHECK(auth.authenticate(bad, "10.0.0.1", db, logger, login).code() == SessionStatus::Code::AuthFailed);
+        
+        std::string good = "user" + salt + computeValidHash(salt, "P@ssW0rd");
+        CHECK(auth.authenticate(good, "10.0.0.1", db, logger, login).code() == SessionStatus::Code::AuthThrottled);
+        CHECK(auth.authenticate("testuser" + salt + computeValidHash(salt, "testpassword"), "10.0.0.1",
+                                db, logger, login).isOk());
+        CHECK_EQUAL(1u, throttle.rejectedLogins());
+        CHECK_EQUAL(3u, throttle.addressFailures("10.0.0.1"));
+    }
+
+    TEST_FIXTURE(AuthTestFixture, AuthenticateMetrics) { // Тест 16: Учет исходов и задержки аутентификации
+        Metrics metrics;
+        auth.setMetrics(&metrics);
+        std::string salt = "1234567890ABCDEF";
+        std::string login;
+        CHECK(auth.authenticate("user" + salt + computeValidHash(salt, "P@ssW0rd"), "10.0.0.1", db, logger, login).isOk());
+        CHECK(!auth.authenticate("user" + salt + std::string(40, '0'), "10.0.0.1", db, logger, login).isOk());
+        CHECK(!auth.authenticate("short", "10.0.0.1", db, logger, login).isOk());
+        CHECK_EQUAL(1u, metrics.value(Metrics::Counter::AuthSuccesses));
+        CHECK_EQUAL(2u, metrics.value(Metrics::Counter::AuthFailures));
+        CHECK_EQUAL(3u, metrics.histogram(Metrics::Latency::Auth).count);
+    }
+}
@@ -0,0 +1,178 @@
+#include <UnitTest++/UnitTest++.h>
+#include "BinaryLog.h"
+#include "Logger.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+SUITE(BinaryLogTest)
+{
+    std::string readFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    size_t countRecords(const std::string& data, BinaryLog::Kind kind) {
+        size_t count = 0;
+        size_t offset = 0;
+        while (offset + BinaryLog::HEADER_SIZE <= data.size()) {
+            uint32_t length;
+            std::memcpy(&length, data.data() + offset + 16, sizeof(length));
+            if (data[offset] == static_cast<char>(kind)) {
+                ++count;
+            }
+            offset += BinaryLog::HEADER_SIZE + length;
+        }
+        return count;
+    }
+
+    TEST(RoundTrip) { // Тест 1: Восстановление текста записей
+        std::string filename = "test_binlog_roundtrip.log";
+        std::remove(filename.c_str());
+        {
+            Logger logger;
+            logger.init(filename);
+            logger.setFormat(Logger::Format::Binary);
+            std::string login = "user";
+            logger.info("Client '", login, "' authenticated successfully");
+            logger.info("Processed vector ", 2u, ", result: ", -2147483647 - 1);
+            logger.warning("Flags ", true, ' ', 'x', ' ', std::string_view("view"));
+            logger.logInfo("Plain message");
+            logger.logError("Test error message", false);
+        }
+        std::string data = readFile(filename);
+        std::remove(filename.c_str());
+
+        std::vector<BinaryLog::Entry> entries;
+        std::string error;
+        CHECK(BinaryLog::decode(data.data(), data.size(), entries, error));
+        CHECK_EQUAL(5u, entries.size());
+        if (entries.size() == 5) {
+            CHECK_EQUAL("Client 'user' authenticated successfully", entries[0].message);
+            CHECK_EQUAL(1u, entries[0].strings.size());
+            CHECK_EQUAL("Processed vector 2, result: -2147483648", entries[1].message);
+            CHECK_EQUAL("Flags true x view", entries[2].message);
+            CHECK_EQUAL(static_cast<int>(Logger::Level::Warning), entries[2].level);
+            CHECK_EQUAL("Plain message", entries[3].message);
+            CHECK_EQUAL(static_cast<int>(Logger::Level::Error), entries[4].level);
+            std::string line = BinaryLog::formatLine(entries[4]);
+            CHECK_EQUAL(19u, line.find("; ERROR; Test error message"));
+        }
+    }
+
+    TEST(TemplateWrittenOnce) { // Тест 2: Шаблон объявляется один раз
+        std::string filename = "test_binlog_templates.log";
+        std::remove(filename.c_str());
+        {
+            Logger logger;
+            logger.init(filename);
+            logger.setFormat(Logger::Format::Binary);
+            for (int i = 0; i < 100; ++i) {
+                logger.info("Processed vector ", i, ", result: ", i * 2);
+                logger.info("Receiving ", i, " vectors");
+            }
+        }
+        std::string data = readFile(filename);
+        std::remove(filename.c_str());
+
+        CHECK_EQUAL(1u, countRecords(data, BinaryLog::Kind::Segment));
+        CHECK_EQUAL(2u, countRecords(data, BinaryLog::Kind::Template));
+        CHECK_EQUAL(200u, countRecords(data, BinaryLog::Kind::Event));
+    }
+
+    TEST(AsyncWriters) { // Тест 3: Асинхронная запись из нескольких потоков
+        std::string filename = "test_binlog_async.log";
+        std::remove(filename.c_str());
+        {
+            Logger logger;
+            logger.init(filename);
+            logger.setFormat(Logger::Format::Binary);
+            CHECK(logger.startAsync(1024));
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; ++t) {
+                threads.emplace_back([&logger, t] {
+                    for (int i = 0; i < 500; ++i) {
+                        logger.info("Thread ", t, " message ", i);
+                        logger.info("Thread ", t, " second template ", i);
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            logger.stop();
+        }
+        std::string data = readFile(filename);
+        std::remove(filename.c_str());
+
+        std::vector<BinaryLog::Entry> entries;
+        std::string error;
+        CHECK(BinaryLog::decode(data.data(), data.size(), entries, error));
+        CHECK_EQUAL(4000u, entries.size());
+        size_t undecodable = 0;
+        for (const auto& entry : entries) {
+            if (entry.message.compare(0, 7, "Thread ") != 0) {
+                ++undecodable;
+            }
+        }
+        CHECK_EQUAL(0u, undecodable);
+    }
+
+    TEST(SegmentsFromSeveralRuns) { // Тест 4: Файл, дописанный несколькими запусками
+        std::string filename = "test_binlog_segments.log";
+        std::remove(filename.c_str());
+        {
+            Logger logger;
+            logger.init(filename);
+            logger.setFormat(Logger::Format::Binary);
+            logger.info("First run ", 1);
+        }
+        {
+            Logger logger;
+            logger.init(filename);
+            logger.setFormat(Logger::Format::Binary);
+            logger.info("Second run template");
+            logger.info("First run ", 2);
+        }
+        std::string data = readFile(filename);
+        std::remove(filename.c_str());
+
+        std::vector<BinaryLog::Entry> entries;
+        std::string error;
+        CHECK(BinaryLog::decode(data.data(), data.size(), entries, error));
+        CHECK_EQUAL(3u, entries.size());
+        if (entries.size() == 3) {
+            CHECK_EQUAL("First run 1", entries[0].message);
+            CHECK_EQUAL("Second run template", entries[1].message);
+            CHECK_EQUAL("First run 2", entries[2].message);
+        }
+    }
+
+    TEST(TruncatedFile) { // Тест 5: Оборванная последняя запись
+        std::string filename = "test_binlog_truncated.log";
+        std::remove(filename.c_str());
+        {
+            Logger logger;
+            logger.init(filename);
+            logger.setFormat(Logger::Format::Binary);
+            logger.info("Complete ", 1);
+            logger.info("Complete ", 2);
+        }
+        std::string data = readFile(filename);
+        std::remove(filename.c_str());
+        data.resize(data.size() - 3);
+
+        std::vector<BinaryLog::Entry> entries;
+        std::string error;
+        CHECK(!BinaryLog::decode(data.data(), data.size(), entries, error));
+        CHECK(!error.empty());
+        CHECK_EQUAL(1u, entries.size());
+
+        std::string text = "2024-01-01 00:00:00; INFO; text log\n";
+        CHECK(!BinaryLog::decode(text.data(), text.size(), entries, error));
+        CHECK_EQUAL("not a binary log", error);
+    }
+}
@@ -0,0 +1,73 @@
+#include <UnitTest++/UnitTest++.h>
+#include "BufferPool.h"
+#include <cstring>
+#include <utility>
+
+SUITE(BufferPoolTest)
+{
+    TEST(SizeClasses) { // Тест 1: Емкость по классам размеров
+        BufferPool pool;
+        BufferPool::Buffer small = pool.acquire(1);
+        BufferPool::Buffer medium = pool.acquire(BufferPool::MIN_BUFFER_SIZE + 1);
+        CHECK(small.data() != nullptr);
+        CHECK_EQUAL(BufferPool::MIN_BUFFER_SIZE, small.capacity());
+        CHECK_EQUAL(2 * BufferPool::MIN_BUFFER_SIZE, medium.capacity());
+    }
+
+    TEST(ReuseReleasedBuffer) { // Тест 2: Повторная выдача освобожденного буфера
+        BufferPool pool;
+        char* first;
+        {
+            BufferPool::Buffer buf = pool.acquire(10000);
+            first = buf.data();
+            std::memset(buf.data(), 0x5A, 10000);
+        }
+        CHECK_EQUAL(16384u, pool.cachedBytes());
+        BufferPool::Buffer again = pool.acquire(9000);
+        CHECK_EQUAL(first, again.data());
+        CHECK_EQUAL(0x5A, again.data()[0]); // содержимое не обнуляется
+        CHECK_EQUAL(1u, pool.allocations());
+        CHECK_EQUAL(0u, pool.cachedBytes());
+    }
+
+    TEST(ManySmallBuffers) { // Тест 3: Множество векторов без новых выделений
+        BufferPool pool;
+        for (int i = 0; i < 10000; ++i) {
+            BufferPool::Buffer buf = pool.acquire(64 + i % 2000);
+            buf.data()[0] = 1;
+        }
+        CHECK_EQUAL(1u, pool.allocations());
+    }
+
+    TEST(LargeBuffer) { // Тест 4: Крупный буфер из mmap с большими страницами
+        BufferPool pool(true);
+        BufferPool::Buffer buf = pool.acquire(3 * BufferPool::HUGE_PAGE_SIZE);
+        CHECK_EQUAL(4 * BufferPool::HUGE_PAGE_SIZE, buf.capacity());
+        buf.data()[buf.capacity() - 1] = 7;
+        buf.reset();
+        CHECK(buf.data() == nullptr);
+        CHECK_EQUAL(4 * BufferPool::HUGE_PAGE_SIZE, pool.cachedBytes());
+    }
+
+    TEST(CacheLimit) { // Тест 5: Предел объема свободных буферов
+        BufferPool pool(false, 8192);
+        {
+            BufferPool::Buffer a = pool.acquire(4096);
+            BufferPool::Buffer b = pool.acquire(4096);
+            BufferPool::Buffer c = pool.acquire(4096);
+        }
+        CHECK_EQUAL(8192u, pool.cachedBytes());
+    }
+
+    TEST(MoveBuffer) { // Тест 6: Передача владения буфером
+        BufferPool pool;
+        BufferPool::Buffer a = pool.acquire(100);
+        char* ptr = a.data();
+        BufferPool::Buffer b(std::move(a));
+        CHECK(a.data() == nullptr);
+        CHECK_EQUAL(ptr, b.data());
+        a = std::move(b);
+        CHECK_EQUAL(ptr, a.data());
+        CHECK_EQUAL(0u, pool.cachedBytes());
+    }
+}
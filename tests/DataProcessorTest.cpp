@@ -1,9 +1,12 @@
 #include <UnitTest++/UnitTest++.h>
 #include "DataProcessor.h"
 #include "Logger.h"
+#include "ThreadPool.h"
+#include "Metrics.h"
 #include <fstream>
 #include <vector>
 #include <climits>
+#include <algorithm>
 
 SUITE(DataProcessorTest)
 {
@@ -68,4 +71,124 @@ SUITE(DataProcessorTest)
         int32_t result = processor.calculateAverage(data, logger);
         CHECK_EQUAL(INT_MIN, result);
     }
-}
\ No newline at end of file
+
+    TEST_FIXTURE(DataProcessorFixture, AccumulatorChunks) { // Тест 9: Потоковое суммирование по частям
+        std::vector<int32_t> data = {7, -3, 100, 25, -9, 4, 12};
+        DataProcessor::Accumulator acc;
+        acc.feed(data.data(), 3);
+        acc.feed(data.data() + 3, data.size() - 3);
+        CHECK_EQUAL(7u, acc.count());
+        CHECK_EQUAL(136, acc.sum());
+        CHECK_EQUAL(processor.calculateAverage(data, logger), processor.finalize(acc, logger));
+    }
+
+    TEST_FIXTURE(DataProcessorFixture, AccumulatorSplitElements) { // Тест 10: Разрыв элементов между порциями байт
+        std::vector<int32_t> data = {INT_MAX, INT_MAX, -5, 1000000, INT_MIN + 1};
+        const char* bytes = reinterpret_cast<const char*>(data.data());
+        size_t total = data.size() * sizeof(int32_t);
+        DataProcessor::Accumulator acc;
+        size_t offset = 0;
+        size_t step = 1;
+        while (offset < total) {
+            size_t n = std::min(step, total - offset);
+            acc.feedBytes(bytes + offset, n);
+            offset += n;
+            step = step % 5 + 2;
+        }
+        CHECK_EQUAL(data.size(), acc.count());
+        CHECK_EQUAL(processor.calculateAverage(data, logger), processor.finalize(acc, logger));
+    }
+
+    TEST_FIXTURE(DataProcessorFixture, AccumulatorEmpty) { // Тест 11: Завершение без данных
+        DataProcessor::Accumulator acc;
+        acc.feedBytes("\x01\x02", 2); // неполный элемент не учитывается
+        CHECK_EQUAL(0u, acc.count());
+        CHECK_EQUAL(0, processor.finalize(acc, logger));
+        acc.reset();
+        acc.feedBytes("\x05\x00\x00\x00", 4);
+        CHECK_EQUAL(5, processor.finalize(acc, logger));
+    }
+
+    TEST_FIXTURE(DataProcessorFixture, RawArray) { // Тест 12: Массив во внешнем буфере
+        int32_t data[] = {10, 20, 30, -4};
+        CHECK_EQUAL(14, processor.calculateAverage(data, 4, logger));
+        CHECK_EQUAL(0, processor.calculateAverage(data, 0, logger));
+    }
+
+    TEST_FIXTURE(DataProcessorFixture, KernelsMatchScalar) { // Тест 13: Совпадение векторных ядер со скалярным
+        std::vector<int32_t> data(1000);
+        uint32_t seed = 12345;
+        for (int32_t& v : data) {
+            seed = seed * 1103515245u + 12345u;
+            v = static_cast<int32_t>(seed);
+        }
+        data[0] = INT_MAX;
+        data[1] = INT_MIN;
+        std::vector<int32_t> big(5000, INT_MAX);
+        std::vector<int32_t> small(5000, INT_MIN);
+
+        const char* initial = DataProcessor::kernelName();
+        CHECK(DataProcessor::selectKernel("scalar"));
+        std::vector<int64_t> expected;
+        for (size_t len : {0u, 1u, 3u, 4u, 15u, 16u, 31u, 33u, 999u}) {
+            DataProcessor::Accumulator acc;
+            acc.feed(data.data() + 1, len); // невыровненное начало
+            expected.push_back(acc.sum());
+        }
+        int32_t expected_big = processor.calculateAverage(big, logger);
+        int32_t expected_small = processor.calculateAverage(small, logger);
+
+        for (const std::string& name : DataProcessor::availableKernels()) {
+            CHECK(DataProcessor::selectKernel(name));
+            size_t k = 0;
+            for (size_t len : {0u, 1u, 3u, 4u, 15u, 16u, 31u, 33u, 999u}) {
+                DataProcessor::Accumulator acc;
+                acc.feed(data.data() + 1, len);
+                CHECK_EQUAL(expected[k++], acc.sum());
+            }
+            CHECK_EQUAL(expected_big, processor.calculateAverage(big, logger));
+            CHECK_EQUAL(expected_small, processor.calculateAverage(small, logger));
+            std::vector<int32_t> up = {INT_MAX, INT_MAX};
+            std::vector<int32_t> down = {INT_MIN, INT_MIN};
+            CHECK_EQUAL(INT_MAX, processor.calculateAverage(up, logger));
+            CHECK_EQUAL(INT_MIN, processor.calculateAverage(down, logger));
+        }
+        CHECK(DataProcessor::selectKernel(initial));
+    }
+
+    TEST_FIXTURE(DataProcessorFixture, ParallelMatchesSerial) { // Тест 14: Параллельное суммирование
+        size_t len = 3 * DataProcessor::PARALLEL_CHUNK + 12345;
+        std::vector<int32_t> data(len);
+        for (size_t i = 0; i < len; ++i) {
+            data[i] = static_cast<int32_t>(i * 2654435761u);
+        }
+        std::vector<int32_t> up(len, INT_MAX);
+        int32_t serial = processor.calculateAverage(data, logger);
+
+        ThreadPool pool(3);
+        DataProcessor parallel;
+        parallel.setParallel(&pool, DataProcessor::PARALLEL_CHUNK);
+        CHECK_EQUAL(serial, parallel.calculateAverage(data, logger));
+        CHECK_EQUAL(INT_MAX, parallel.calculateAverage(up, logger));
+        CHECK_EQUAL(0, parallel.calculateAverage(data.data(), 0, logger));
+    }
+
+    TEST(UnknownKernel) { // Тест 15: Выбор неизвестного ядра
+        CHECK_EQUAL(false, DataProcessor::selectKernel("neon"));
+        CHECK_EQUAL("scalar", DataProcessor::availableKernels().back());
+    }
+
+    TEST_FIXTURE(DataProcessorFixture, OverflowClampsCounted) { // Тест 16: Учет ограничений среднего в метриках
+        Metrics metrics;
+        processor.setMetrics(&metrics);
+        DataProcessor::Accumulator up;
+        up.merge(int64_t(INT_MAX) * 3, 2);
+        DataProcessor::Accumulator down;
+        down.merge(int64_t(INT_MIN) * 3, 2);
+        std::vector<int32_t> extreme = {INT_MAX, INT_MAX};
+        CHECK_EQUAL(INT_MAX, processor.finalize(up, logger));
+        CHECK_EQUAL(INT_MIN, processor.finalize(down, logger));
+        CHECK_EQUAL(INT_MAX, processor.calculateAverage(extreme, logger));
+        CHECK_EQUAL(2u, metrics.value(Metrics::Counter::OverflowClamps));
+    }
+}
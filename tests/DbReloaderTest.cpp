@@ -0,0 +1,83 @@
+#include <UnitTest++/UnitTest++.h>
+#include "DbReloader.h"
+#include "UserDatabase.h"
+#include "Logger.h"
+#include <fstream>
+#include <string>
+#include <cstdio>
+#include <chrono>
+#include <thread>
+
+SUITE(DbReloaderTest)
+{
+    struct ReloaderFixture {
+        Logger logger;
+        UserDatabase db;
+        
+        ReloaderFixture() {
+            logger.init("test_reloader.log");
+            writeDatabase("user:first\n");
+            db.load("test_reloader.conf", logger);
+        }
+        
+        ~ReloaderFixture() {
+            std::remove("test_reloader.conf");
+            std::remove("test_reloader.log");
+        }
+        
+        void writeDatabase(const std::string& content) {
+            std::ofstream file("test_reloader.conf");
+            file << content;
+            file.close();
+        }
+        
+        bool waitPassword(const std::string& expected) {
+            for (int i = 0; i < 500; ++i) {
+                std::string password;
+                if (db.getPassword("user", password) && password == expected) {
+                    return true;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            return false;
+        }
+    };
+
+    TEST_FIXTURE(ReloaderFixture, ReloadOnRequest) { // Тест 1: Перезагрузка по запросу
+        DbReloader reloader(db, logger);
+        CHECK_EQUAL(true, reloader.start(false));
+        
+        writeDatabase("user:second\n");
+        reloader.requestReload();
+        
+        CHECK(waitPassword("second"));
+        reloader.stop();
+        CHECK(reloader.reloads() >= 1u);
+    }
+    
+    TEST_FIXTURE(ReloaderFixture, ReloadOnFileChange) { // Тест 2: Перезагрузка при изменении файла
+        DbReloader reloader(db, logger);
+        CHECK_EQUAL(true, reloader.start(true));
+        
+        writeDatabase("user:changed\n");
+        
+        CHECK(waitPassword("changed"));
+    }
+    
+    TEST_FIXTURE(ReloaderFixture, FailedReloadKeepsDatabase) { // Тест 3: Ошибка перезагрузки сохраняет базу
+        DbReloader reloader(db, logger);
+        CHECK_EQUAL(true, reloader.start(false));
+        
+        writeDatabase("# no users\n");
+        reloader.requestReload();
+        for (int i = 0; i < 500 && reloader.failures() == 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        
+        CHECK_EQUAL(1u, reloader.failures());
+        CHECK_EQUAL(0u, reloader.reloads());
+        std::string password;
+        CHECK_EQUAL(true, db.getPassword("user", password));
+        CHECK_EQUAL("first", password);
+    }
+}
@@ -0,0 +1,62 @@
+#include <UnitTest++/UnitTest++.h>
+#include "Digest.h"
+#include <string>
+#include <cstdio>
+
+namespace {
+
+std::string toHex(const unsigned char* data, size_t size) {
+    std::string hex;
+    char buf[3];
+    for (size_t i = 0; i < size; ++i) {
+        std::snprintf(buf, sizeof(buf), "%02x", data[i]);
+        hex += buf;
+    }
+    return hex;
+}
+
+std::string hashHex(Digest& digest, const std::string& data) {
+    unsigned char out[Digest::MAX_SIZE];
+    digest.update(data.data(), data.size());
+    digest.final(out);
+    return toHex(out, digest.size());
+}
+
+}
+
+SUITE(DigestTest)
+{
+    TEST(Sha1KnownVector) { // Тест 1: Эталонное значение SHA-1
+        std::unique_ptr<Digest> digest = Digest::create(Digest::Algorithm::Sha1);
+        CHECK_EQUAL(20u, digest->size());
+        CHECK_EQUAL("a9993e364706816aba3e25717850c26c9cd0d89d", hashHex(*digest, "abc"));
+    }
+
+    TEST(Sha256KnownVector) { // Тест 2: Эталонное значение SHA-256
+        std::unique_ptr<Digest> digest = Digest::create(Digest::Algorithm::Sha256);
+        CHECK_EQUAL(32u, digest->size());
+        CHECK_EQUAL("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", hashHex(*digest, "abc"));
+    }
+
+    TEST(ReuseAfterFinal) { // Тест 3: Повторное использование объекта после final()
+        std::unique_ptr<Digest> digest = Digest::create(Digest::Algorithm::Sha256);
+        std::string first = hashHex(*digest, "abc");
+        digest->update("a", 1);
+        digest->update("bc", 2);
+        unsigned char out[Digest::MAX_SIZE];
+        digest->final(out);
+        CHECK_EQUAL(first, toHex(out, digest->size()));
+        CHECK(!digest->provider().empty());
+    }
+
+    TEST(ParseNames) { // Тест 4: Разбор названий алгоритмов
+        Digest::Algorithm algorithm;
+        CHECK_EQUAL(true, Digest::parse("sha1", algorithm));
+        CHECK(algorithm == Digest::Algorithm::Sha1);
+        CHECK_EQUAL(true, Digest::parse("sha256", algorithm));
+        CHECK(algorithm == Digest::Algorithm::Sha256);
+        CHECK_EQUAL(false, Digest::parse("md5", algorithm));
+        CHECK_EQUAL(32u, Digest::size(Digest::Algorithm::Sha256));
+        CHECK_EQUAL("SHA-1", std::string(Digest::name(Digest::Algorithm::Sha1)));
+    }
+}
@@ -0,0 +1,79 @@
+#include <UnitTest++/UnitTest++.h>
+#include "FrameReader.h"
+#include <string>
+#include <vector>
+#include <cstring>
+
+SUITE(FrameReaderTest)
+{
+    TEST(LineByParts) { // Тест 1: Строка, пришедшая по частям
+        FrameReader reader(64);
+        std::string line;
+        reader.buffer().write("user", 4);
+        CHECK_EQUAL(false, reader.nextLine(line, 32));
+        reader.buffer().write("name\n", 5);
+        CHECK_EQUAL(true, reader.nextLine(line, 32));
+        CHECK_EQUAL("username", line);
+        CHECK_EQUAL(0u, reader.buffered());
+    }
+
+    TEST(LineMaxLength) { // Тест 2: Строка без перевода строки максимальной длины
+        FrameReader reader(64);
+        std::string line;
+        reader.buffer().write("abcdefghij", 10);
+        CHECK_EQUAL(true, reader.nextLine(line, 8));
+        CHECK_EQUAL("abcdefgh", line);
+        CHECK_EQUAL(2u, reader.buffered());
+    }
+
+    TEST(LinePartial) { // Тест 3: Неполная строка по требованию
+        FrameReader reader(64);
+        std::string line;
+        CHECK_EQUAL(false, reader.nextLine(line, 32, true));
+        reader.buffer().write("abc", 3);
+        CHECK_EQUAL(true, reader.nextLine(line, 32, true));
+        CHECK_EQUAL("abc", line);
+    }
+
+    TEST(SeveralFramesInOneRead) { // Тест 4: Несколько кадров в одной порции данных
+        FrameReader reader(64);
+        std::string data = "login\n";
+        uint32_t fields[] = {2, 3};
+        int32_t values[] = {1, 2, 3};
+        data.append(reinterpret_cast<const char*>(fields), sizeof(fields));
+        data.append(reinterpret_cast<const char*>(values), sizeof(values));
+        reader.buffer().write(data.data(), data.size());
+
+        std::string line;
+        uint32_t count = 0;
+        uint32_t len = 0;
+        CHECK_EQUAL(true, reader.nextLine(line, 32));
+        CHECK_EQUAL("login", line);
+        CHECK_EQUAL(true, reader.nextU32(count));
+        CHECK_EQUAL(2u, count);
+        CHECK_EQUAL(true, reader.nextU32(len));
+        CHECK_EQUAL(3u, len);
+
+        std::vector<int32_t> out(len);
+        char* dst = reinterpret_cast<char*>(out.data());
+        size_t n = reader.nextPayload(len * sizeof(int32_t), [&](const char* chunk, size_t size) {
+            std::memcpy(dst, chunk, size);
+            dst += size;
+        });
+        CHECK_EQUAL(sizeof(values), n);
+        CHECK_EQUAL(3, out[2]);
+        CHECK_EQUAL(false, reader.nextU32(len));
+    }
+
+    TEST(ShortField) { // Тест 5: Поле uint32_t, пришедшее по частям
+        FrameReader reader(64);
+        uint32_t value = 0x01020304;
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        uint32_t out = 0;
+        reader.buffer().write(bytes, 3);
+        CHECK_EQUAL(false, reader.nextU32(out));
+        reader.buffer().write(bytes + 3, 1);
+        CHECK_EQUAL(true, reader.nextU32(out));
+        CHECK_EQUAL(value, out);
+    }
+}
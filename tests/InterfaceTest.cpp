@@ -18,6 +18,27 @@ SUITE(InterfaceTest)
         CHECK_EQUAL("etc/vcalc.conf", p.dbFile);
         CHECK_EQUAL("var/log/vcalc.log", p.logFile);
         CHECK_EQUAL(33333, p.port);
+        CHECK_EQUAL("epoll", p.ioMode);
+        CHECK_EQUAL(1u, p.workers);
+        CHECK_EQUAL(false, p.streaming);
+        CHECK_EQUAL(false, p.hugePages);
+        CHECK_EQUAL(4u * 1024 * 1024, p.parallelThreshold);
+        CHECK_EQUAL(0u, p.computeThreads);
+        CHECK_EQUAL(false, p.asyncLog);
+        CHECK_EQUAL(65536u, p.logQueue);
+        CHECK_EQUAL("block", p.logOverflow);
+        CHECK_EQUAL("info", p.logLevel);
+        CHECK_EQUAL("text", p.logFormat);
+        CHECK_EQUAL(false, p.watchDb);
+        CHECK_EQUAL("sha1", p.hash);
+        CHECK_EQUAL(false, p.tickets);
+        CHECK_EQUAL(300u, p.ticketLifetime);
+        CHECK_EQUAL("", p.ticketSecret);
+        CHECK_EQUAL(0u, p.authThrottle);
+        CHECK_EQUAL(60u, p.authThrottleWindow);
+        CHECK_EQUAL(0, p.metricsPort);
+        CHECK_EQUAL("", p.traceFile);
+        CHECK_EQUAL(1u, p.traceSample);
     }
 
     TEST(CustomAllParams) { // Тест 2: Валидные параметры
@@ -88,4 +109,296 @@ SUITE(InterfaceTest)
         
         CHECK_EQUAL(false, iface.Parser(argc, const_cast<char**>(argv)));
     }
-}
\ No newline at end of file
+    
+    TEST(BlockingIoMode) { // Тест 8: Последовательный режим обработки клиентов
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--io", "blocking"};
+        int argc = 3;
+        
+        CHECK_EQUAL(true, iface.Parser(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL("blocking", iface.getParams().ioMode);
+    }
+    
+    TEST(InvalidIoMode) { // Тест 9: Неизвестный режим ввода-вывода
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "-i", "select"};
+        int argc = 3;
+        
+        CHECK_EQUAL(false, iface.Parser(argc, const_cast<char**>(argv)));
+    }
+    
+    TEST(WorkersOption) { // Тест 10: Количество рабочих потоков
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--workers", "8"};
+        int argc = 3;
+        
+        CHECK_EQUAL(true, iface.Parser(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL(8u, iface.getParams().workers);
+    }
+    
+    TEST(TooManyWorkers) { // Тест 11: Превышение максимального количества потоков
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "-w", "100000"};
+        int argc = 3;
+        
+        CHECK_EQUAL(false, iface.Parser(argc, const_cast<char**>(argv)));
+    }
+    
+    TEST(UringIoMode) { // Тест 12: Режим io_uring
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--io", "uring"};
+        int argc = 3;
+        
+        CHECK_EQUAL(true, iface.Parser(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL("uring", iface.getParams().ioMode);
+    }
+
+    TEST(StreamingSwitch) { // Тест 13: Потоковая обработка векторов
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--stream"};
+        int argc = 2;
+        
+        CHECK_EQUAL(true, iface.Parser(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL(true, iface.getParams().streaming);
+    }
+
+    TEST(HugePagesSwitch) { // Тест 14: Большие страницы для буферов векторов
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--huge-pages"};
+        int argc = 2;
+        
+        CHECK_EQUAL(true, iface.Parser(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL(true, iface.getParams().hugePages);
+    }
+
+    TEST(ParallelOptions) { // Тест 15: Параметры параллельного суммирования
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--parallel-threshold", "1000", "--compute-threads", "4"};
+        int argc = 5;
+        
+        CHECK_EQUAL(true, iface.Parser(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL(1000u, iface.getParams().parallelThreshold);
+        CHECK_EQUAL(4u, iface.getParams().computeThreads);
+    }
+
+    TEST(AsyncLogOptions) { // Тест 16: Параметры асинхронного журнала
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--async-log", "--log-queue", "1024", "--log-overflow", "drop"};
+        int argc = 6;
+        
+        CHECK_EQUAL(true, iface.Parser(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL(true, iface.getParams().asyncLog);
+        CHECK_EQUAL(1024u, iface.getParams().logQueue);
+        CHECK_EQUAL("drop", iface.getParams().logOverflow);
+    }
+
+    TEST(InvalidLogOverflow) { // Тест 17: Недопустимое поведение при переполнении журнала
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--log-overflow", "wait"};
+        int argc = 3;
+        
+        CHECK_EQUAL(false, iface.Parser(argc, const_cast<char**>(argv)));
+    }
+
+    TEST(WatchDbSwitch) { // Тест 18: Перезагрузка базы при изменении файла
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--watch-db"};
+        int argc = 2;
+        
+        CHECK_EQUAL(true, iface.Parser(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL(true, iface.getParams().watchDb);
+    }
+
+    TEST(HashOption) { // Тест 19: Выбор алгоритма хеширования
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--hash", "sha256"};
+        int argc = 3;
+        
+        CHECK_EQUAL(true, iface.Parser(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL("sha256", iface.getParams().hash);
+    }
+
+    TEST(InvalidHash) { // Тест 20: Неизвестный алгоритм хеширования
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--hash", "md5"};
+        int argc = 3;
+        
+        CHECK_EQUAL(false, iface.Parser(argc, const_cast<char**>(argv)));
+    }
+
+    TEST(TicketOptions) { // Тест 21: Параметры билетов возобновления сессии
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--tickets", "--ticket-lifetime", "60", "--ticket-secret", "etc/ticket.key"};
+        int argc = 6;
+        
+        CHECK_EQUAL(true, iface.Parser(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL(true, iface.getParams().tickets);
+        CHECK_EQUAL(60u, iface.getParams().ticketLifetime);
+        CHECK_EQUAL("etc/ticket.key", iface.getParams().ticketSecret);
+    }
+
+    TEST(TicketLifetimeLimit) { // Тест 22: Срок билета не длиннее периода смены ключа
+        Interface max_iface;
+        const char* max_argv[] = {"test_program", "--ticket-lifetime", "3600"};
+        CHECK_EQUAL(true, max_iface.Parser(3, const_cast<char**>(max_argv)));
+
+        Interface long_iface;
+        const char* long_argv[] = {"test_program", "--ticket-lifetime", "3601"};
+        CHECK_EQUAL(false, long_iface.Parser(3, const_cast<char**>(long_argv)));
+    }
+
+    TEST(AuthThrottleOptions) { // Тест 23: Параметры ограничения неудачных попыток
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--auth-throttle", "10", "--auth-throttle-window", "30"};
+        int argc = 5;
+        
+        CHECK_EQUAL(true, iface.Parser(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL(10u, iface.getParams().authThrottle);
+        CHECK_EQUAL(30u, iface.getParams().authThrottleWindow);
+    }
+
+    TEST(ZeroAuthThrottleWindow) { // Тест 24: Нулевой период затухания счетчиков
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--auth-throttle", "10", "--auth-throttle-window", "0"};
+        int argc = 5;
+        
+        CHECK_EQUAL(false, iface.Parser(argc, const_cast<char**>(argv)));
+    }
+
+    TEST(MetricsPort) { // Тест 25: Порт экспорта метрик
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--metrics-port", "9100"};
+        int argc = 3;
+        
+        CHECK_EQUAL(true, iface.Parser(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL(9100, iface.getParams().metricsPort);
+    }
+
+    TEST(MetricsPortSameAsServer) { // Тест 26: Порт метрик совпадает с портом сервера
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--port", "33333", "--metrics-port", "33333"};
+        int argc = 5;
+        
+        CHECK_EQUAL(false, iface.Parser(argc, const_cast<char**>(argv)));
+    }
+
+    TEST(TraceOptions) { // Тест 27: Параметры трассировки
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--trace-file", "/tmp/vcalc.trace.json", "--trace-sample", "100"};
+        int argc = 5;
+        
+        CHECK_EQUAL(true, iface.Parser(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL("/tmp/vcalc.trace.json", iface.getParams().traceFile);
+        CHECK_EQUAL(100u, iface.getParams().traceSample);
+    }
+
+    TEST(ZeroTraceSample) { // Тест 28: Нулевой период выборки трассировки
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--trace-file", "/tmp/vcalc.trace.json", "--trace-sample", "0"};
+        int argc = 5;
+        
+        CHECK_EQUAL(false, iface.Parser(argc, const_cast<char**>(argv)));
+    }
+
+    TEST(LogLevel) { // Тест 29: Уровень журнала
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--log-level", "warning"};
+        int argc = 3;
+        
+        CHECK_EQUAL(true, iface.Parser(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL("warning", iface.getParams().logLevel);
+    }
+
+    TEST(InvalidLogLevel) { // Тест 30: Неизвестный уровень журнала
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--log-level", "verbose"};
+        int argc = 3;
+        
+        CHECK_EQUAL(false, iface.Parser(argc, const_cast<char**>(argv)));
+    }
+
+    TEST(LogFormat) { // Тест 31: Формат файла журнала
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--log-format", "binary"};
+        int argc = 3;
+        
+        CHECK_EQUAL(true, iface.Parser(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL("binary", iface.getParams().logFormat);
+    }
+
+    TEST(InvalidLogFormat) { // Тест 32: Неизвестный формат файла журнала
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--log-format", "json"};
+        int argc = 3;
+        
+        CHECK_EQUAL(false, iface.Parser(argc, const_cast<char**>(argv)));
+    }
+
+    TEST(LogRotation) { // Тест 33: Параметры ротации журнала
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--log-rotate-size", "1048576", "--log-rotate-interval", "3600",
+                              "--log-keep", "3", "--log-compress"};
+        int argc = 8;
+        
+        CHECK_EQUAL(true, iface.Parser(argc, const_cast<char**>(argv)));
+        Params params = iface.getParams();
+        CHECK_EQUAL(1048576u, params.logRotateSize);
+        CHECK_EQUAL(3600u, params.logRotateInterval);
+        CHECK_EQUAL(3u, params.logKeep);
+        CHECK_EQUAL(true, params.logCompress);
+    }
+
+    TEST(InvalidLogKeep) { // Тест 34: Нулевое количество хранимых файлов журнала
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--log-keep", "0"};
+        int argc = 3;
+        
+        CHECK_EQUAL(false, iface.Parser(argc, const_cast<char**>(argv)));
+    }
+
+    TEST(Pipeline) { // Тест 35: Конвейерная обработка векторов
+        Interface iface;
+        
+        const char* argv[] = {"test_program", "--io", "blocking", "--pipeline"};
+        int argc = 4;
+        
+        CHECK_EQUAL(true, iface.Parser(argc, const_cast<char**>(argv)));
+        CHECK_EQUAL(true, iface.getParams().pipeline);
+    }
+
+    TEST(PipelineRequiresBlocking) { // Тест 36: Конвейер только в блокирующем режиме и без --stream
+        Interface epoll_iface;
+        const char* epoll_argv[] = {"test_program", "--pipeline"};
+        CHECK_EQUAL(false, epoll_iface.Parser(2, const_cast<char**>(epoll_argv)));
+
+        Interface stream_iface;
+        const char* stream_argv[] = {"test_program", "--io", "blocking", "--pipeline", "--stream"};
+        CHECK_EQUAL(false, stream_iface.Parser(5, const_cast<char**>(stream_argv)));
+    }
+}
@@ -1,11 +1,50 @@
 #include <UnitTest++/UnitTest++.h>
 #include "Logger.h"
 #include <fstream>
+#include <iterator>
 #include <string>
+#include <string_view>
 #include <cstdio>
+#include <thread>
+#include <vector>
+#include <cstring>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 SUITE(LoggerTest)
 {
+    std::string rotationDir() {
+        std::string dir = "/tmp/vcalc_rotate_test_" + std::to_string(getpid());
+        mkdir(dir.c_str(), 0755);
+        return dir;
+    }
+
+    std::vector<std::string> listDir(const std::string& dir) {
+        std::vector<std::string> names;
+        if (DIR* handle = opendir(dir.c_str())) {
+            while (dirent* entry = readdir(handle)) {
+                if (entry->d_name[0] != '.') {
+                    names.push_back(entry->d_name);
+                }
+            }
+            closedir(handle);
+        }
+        return names;
+    }
+
+    std::string readAll(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    void removeDir(const std::string& dir) {
+        for (const std::string& name : listDir(dir)) {
+            std::remove((dir + "/" + name).c_str());
+        }
+        rmdir(dir.c_str());
+    }
+
     TEST(CreateFile) { // Тест 1: Создание файла при инициализации
         Logger logger;
         std::string filename = "test_create_init.log";
@@ -122,4 +161,324 @@ SUITE(LoggerTest)
         
         CHECK(correct_format);
     }
-}
\ No newline at end of file
+    
+    TEST(ConcurrentWriters) { // Тест 6: Одновременная запись из нескольких потоков
+        Logger logger;
+        std::string filename = "test_concurrent.log";
+        logger.init(filename);
+        
+        const int threads_count = 4;
+        const int messages_per_thread = 200;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threads_count; ++t) {
+            threads.emplace_back([&logger, t]() {
+                for (int i = 0; i < messages_per_thread; ++i) {
+                    logger.logInfo("Thread " + std::to_string(t) + " message " + std::to_string(i));
+                }
+            });
+        }
+        for (auto& th : threads) {
+            th.join();
+        }
+        
+        std::ifstream file(filename);
+        std::string line;
+        int lines = 0;
+        bool all_correct = true;
+        while (std::getline(file, line)) {
+            lines++;
+            all_correct = all_correct && (line.find("; INFO; Thread ") != std::string::npos);
+        }
+        file.close();
+        
+        std::remove(filename.c_str());
+        
+        CHECK_EQUAL(threads_count * messages_per_thread, lines);
+        CHECK(all_correct);
+    }
+
+    TEST(AsyncConcurrentWriters) { // Тест 7: Асинхронная запись из нескольких потоков
+        Logger logger;
+        std::string filename = "test_async.log";
+        std::remove(filename.c_str());
+        logger.init(filename);
+        CHECK(logger.startAsync(1024));
+        
+        const int threads_count = 4;
+        const int messages_per_thread = 500;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threads_count; ++t) {
+            threads.emplace_back([&logger, t]() {
+                for (int i = 0; i < messages_per_thread; ++i) {
+                    logger.logInfo("Thread " + std::to_string(t) + " message " + std::to_string(i));
+                }
+            });
+        }
+        for (auto& th : threads) {
+            th.join();
+        }
+        logger.stop();
+        
+        std::ifstream file(filename);
+        std::string line;
+        int lines = 0;
+        bool all_correct = true;
+        while (std::getline(file, line)) {
+            lines++;
+            all_correct = all_correct && (line.find("; INFO; Thread ") != std::string::npos);
+        }
+        file.close();
+        
+        std::remove(filename.c_str());
+        
+        CHECK_EQUAL(threads_count * messages_per_thread, lines);
+        CHECK(all_correct);
+        CHECK_EQUAL(0u, logger.droppedRecords());
+    }
+
+    TEST(AsyncBlockOnOverflow) { // Тест 8: Ожидание места в переполненной очереди
+        Logger logger;
+        std::string filename = "test_async_block.log";
+        std::remove(filename.c_str());
+        logger.init(filename);
+        CHECK(logger.startAsync(4, Logger::OverflowPolicy::Block));
+        
+        const int messages = 1000;
+        for (int i = 0; i < messages; ++i) {
+            logger.logInfo("Message " + std::to_string(i));
+        }
+        logger.stop();
+        
+        std::ifstream file(filename);
+        std::string line;
+        int lines = 0;
+        bool ordered = true;
+        while (std::getline(file, line)) {
+            ordered = ordered && (line.find("; INFO; Message " + std::to_string(lines)) != std::string::npos);
+            lines++;
+        }
+        file.close();
+        
+        std::remove(filename.c_str());
+        
+        CHECK_EQUAL(messages, lines);
+        CHECK(ordered);
+        CHECK_EQUAL(0u, logger.droppedRecords());
+    }
+
+    TEST(AsyncDropOnOverflow) { // Тест 9: Отбрасывание записей при переполнении очереди
+        Logger logger;
+        std::string filename = "test_async_drop.log";
+        std::remove(filename.c_str());
+        logger.init(filename);
+        CHECK(logger.startAsync(2, Logger::OverflowPolicy::Drop));
+        
+        const int messages = 5000;
+        for (int i = 0; i < messages; ++i) {
+            logger.logInfo("Message " + std::to_string(i));
+        }
+        logger.stop();
+        
+        std::ifstream file(filename);
+        std::string line;
+        int info_lines = 0;
+        bool drop_reported = (logger.droppedRecords() == 0);
+        while (std::getline(file, line)) {
+            if (line.find("; INFO; Message ") != std::string::npos) {
+                info_lines++;
+            } else if (line.find("; ERROR; ") != std::string::npos && line.find("dropped") != std::string::npos) {
+                drop_reported = true;
+            }
+        }
+        file.close();
+        
+        std::remove(filename.c_str());
+        
+        CHECK_EQUAL(static_cast<uint64_t>(messages), info_lines + logger.droppedRecords());
+        CHECK(drop_reported);
+    }
+
+    TEST(StopFallsBackToSync) { // Тест 10: Синхронная запись после остановки асинхронного режима
+        Logger logger;
+        std::string filename = "test_async_stop.log";
+        std::remove(filename.c_str());
+        logger.init(filename);
+        CHECK(logger.startAsync(16));
+        logger.logInfo("Async message");
+        logger.stop();
+        logger.logInfo("Sync message");
+        
+        std::ifstream file(filename);
+        std::string line;
+        int lines = 0;
+        while (std::getline(file, line)) {
+            lines++;
+        }
+        file.close();
+        
+        std::remove(filename.c_str());
+        
+        CHECK_EQUAL(2, lines);
+    }
+
+    TEST(LevelThreshold) { // Тест 11: Записи ниже порога не попадают в журнал
+        Logger logger;
+        std::string filename = "test_level.log";
+        std::remove(filename.c_str());
+        logger.init(filename);
+        CHECK(logger.level() == Logger::Level::Info);
+        CHECK(!logger.enabled(Logger::Level::Debug));
+        logger.debug("Hidden debug ", 1);
+        logger.info("Visible info");
+        logger.setLevel(Logger::Level::Warning);
+        logger.logInfo("Hidden info");
+        logger.info("Hidden info ", 2);
+        logger.warning("Visible warning");
+        logger.setLevel(Logger::Level::Trace);
+        logger.trace("Visible trace");
+        logger.setLevel(Logger::Level::Off);
+        logger.critical("Hidden critical");
+        
+        std::ifstream file(filename);
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+        std::remove(filename.c_str());
+        
+        CHECK(content.find("Hidden") == std::string::npos);
+        CHECK(content.find("; INFO; Visible info") != std::string::npos);
+        CHECK(content.find("; WARNING; Visible warning") != std::string::npos);
+        CHECK(content.find("; TRACE; Visible trace") != std::string::npos);
+    }
+
+    TEST(DeferredFormatting) { // Тест 12: Сборка сообщения из аргументов разных типов
+        Logger logger;
+        std::string filename = "test_format.log";
+        std::remove(filename.c_str());
+        logger.init(filename);
+        std::string login = "user";
+        std::string_view peer("127.0.0.1:5000");
+        logger.info("Vector ", 3u, " of ", login, " from ", peer, ": ", -2147483647 - 1, ' ', uint64_t(18446744073709551615ull),
+                    ' ', true);
+        
+        std::ifstream file(filename);
+        std::string line;
+        std::getline(file, line);
+        file.close();
+        std::remove(filename.c_str());
+        
+        CHECK(line.find("; INFO; Vector 3 of user from 127.0.0.1:5000: -2147483648 18446744073709551615 true") !=
+              std::string::npos);
+    }
+
+    TEST(ParseLevel) { // Тест 13: Разбор названий уровней
+        Logger::Level level = Logger::Level::Info;
+        CHECK(Logger::parseLevel("trace", level));
+        CHECK(level == Logger::Level::Trace);
+        CHECK(Logger::parseLevel("critical", level));
+        CHECK(level == Logger::Level::Critical);
+        CHECK(Logger::parseLevel("off", level));
+        CHECK(level == Logger::Level::Off);
+        CHECK(!Logger::parseLevel("INFO", level));
+        CHECK_EQUAL(std::string("WARNING"), Logger::levelName(Logger::Level::Warning));
+    }
+
+    TEST(RotateBySize) { // Тест 14: Ротация по размеру с ограничением числа хранимых файлов
+        std::string dir = rotationDir();
+        std::string filename = dir + "/server.log";
+        {
+            Logger logger;
+            logger.init(filename);
+            logger.setRotation(400, 0, 2, false);
+            for (int i = 0; i < 100; ++i) {
+                logger.info("Rotated message ", i);
+            }
+        }
+        std::vector<std::string> names = listDir(dir);
+        std::string active = readAll(filename);
+        removeDir(dir);
+
+        CHECK_EQUAL(3u, names.size());
+        CHECK(!active.empty() && active.size() <= 400);
+        CHECK(active.find("Rotated message 99") != std::string::npos);
+        for (const std::string& name : names) {
+            CHECK(name == "server.log" || name.compare(0, 11, "server.log.") == 0);
+        }
+    }
+
+    TEST(AsyncRotationStartsSegments) { // Тест 15: Асинхронная ротация двоичного журнала
+        std::string dir = rotationDir();
+        std::string filename = dir + "/server.log";
+        {
+            Logger logger;
+            logger.init(filename);
+            logger.setFormat(Logger::Format::Binary);
+            logger.setRotation(1024, 0, 10, false);
+            CHECK(logger.startAsync(64));
+            for (int i = 0; i < 200; ++i) {
+                logger.info("Binary message ", i);
+            }
+        }
+        std::vector<std::string> names = listDir(dir);
+        size_t segments = 0;
+        for (const std::string& name : names) {
+            std::string data = readAll(dir + "/" + name);
+            if (data.size() >= BinaryLog::HEADER_SIZE + sizeof(BinaryLog::MAGIC) && data[0] == 0 &&
+                std::memcmp(data.data() + BinaryLog::HEADER_SIZE, BinaryLog::MAGIC, sizeof(BinaryLog::MAGIC)) == 0) {
+                ++segments;
+            }
+        }
+        removeDir(dir);
+
+        CHECK(names.size() > 2);
+        CHECK(names.size() <= 11);
+        CHECK_EQUAL(names.size(), segments);
+    }
+
+    TEST(CompressRotated) { // Тест 16: Сжатие ротированных файлов
+        std::string dir = rotationDir();
+        std::string filename = dir + "/server.log";
+        {
+            Logger logger;
+            logger.init(filename);
+            logger.setRotation(100, 0, 5, true);
+            logger.logInfo("First file message that fills the file");
+            logger.logInfo("Second file message that fills the file");
+            logger.logInfo("Third file message");
+        }
+        std::vector<std::string> names = listDir(dir);
+        removeDir(dir);
+
+        CHECK_EQUAL(3u, names.size());
+        size_t compressed = 0;
+        for (const std::string& name : names) {
+            if (name.size() > 3 && name.compare(name.size() - 3, 3, ".gz") == 0) {
+                ++compressed;
+            }
+        }
+        CHECK_EQUAL(2u, compressed);
+    }
+
+    TEST(CompressWithRetention) { // Тест 17: Удаление старых файлов не мешает сжатию
+        std::string dir = rotationDir();
+        std::string filename = dir + "/server.log";
+        {
+            Logger logger;
+            logger.init(filename);
+            logger.setRotation(100, 0, 1, true);
+            for (int i = 0; i < 20; ++i) {
+                logger.logInfo("Message that fills the whole file " + std::to_string(i));
+            }
+        }
+        std::vector<std::string> names = listDir(dir);
+        removeDir(dir);
+
+        CHECK_EQUAL(2u, names.size());
+        size_t compressed = 0;
+        for (const std::string& name : names) {
+            if (name.size() > 3 && name.compare(name.size() - 3, 3, ".gz") == 0) {
+                ++compressed;
+            }
+        }
+        CHECK_EQUAL(1u, compressed);
+    }
+}
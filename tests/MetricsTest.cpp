@@ -0,0 +1,117 @@
+#include <UnitTest++/UnitTest++.h>
+#include "Metrics.h"
+#include "MetricsServer.h"
+#include "Logger.h"
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+SUITE(MetricsTest)
+{
+    std::string httpGet(unsigned short port, const std::string& path) {
+        int sock = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        std::string response;
+        if (connect(sock, reinterpret_cast<const sockaddr*>(&addr), sizeof addr) == 0) {
+            std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+            send(sock, request.data(), request.size(), 0);
+            char buf[4096];
+            ssize_t rc;
+            while ((rc = recv(sock, buf, sizeof buf, 0)) > 0) {
+                response.append(buf, rc);
+            }
+        }
+        close(sock);
+        return response;
+    }
+
+    TEST(BucketBounds) { // Тест 1: Границы интервалов гистограммы
+        for (uint64_t v = 0; v < 2 * Metrics::SUB_BUCKETS; ++v) {
+            CHECK_EQUAL(v, Metrics::bucketLowerBound(Metrics::bucketIndex(v)));
+        }
+        const uint64_t values[] = {32, 33, 63, 64, 1000, 123456, 999999999, (uint64_t(1) << 39) + 12345};
+        for (uint64_t v : values) {
+            size_t index = Metrics::bucketIndex(v);
+            CHECK(Metrics::bucketLowerBound(index) <= v);
+            CHECK(v < Metrics::bucketLowerBound(index + 1));
+            CHECK(Metrics::bucketLowerBound(index + 1) - Metrics::bucketLowerBound(index) <=
+                  v / Metrics::SUB_BUCKETS + 1);
+        }
+        CHECK_EQUAL(Metrics::BUCKETS - 1, Metrics::bucketIndex(uint64_t(1) << 50));
+    }
+
+    TEST(CountersFromThreads) { // Тест 2: Сложение счетчиков потоков
+        Metrics metrics;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&metrics] {
+                for (int i = 0; i < 10000; ++i) {
+                    metrics.add(Metrics::Counter::VectorsProcessed);
+                    metrics.add(Metrics::Counter::BytesProcessed, 8);
+                    metrics.record(Metrics::Latency::Compute, 100);
+                }
+            });
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+        CHECK_EQUAL(40000u, metrics.value(Metrics::Counter::VectorsProcessed));
+        CHECK_EQUAL(320000u, metrics.value(Metrics::Counter::BytesProcessed));
+        CHECK_EQUAL(40000u, metrics.histogram(Metrics::Latency::Compute).count);
+        CHECK_EQUAL(0u, metrics.value(Metrics::Counter::AuthFailures));
+    }
+
+    TEST(Quantiles) { // Тест 3: Точность квантилей
+        Metrics metrics;
+        for (uint64_t v = 1; v <= 100000; ++v) {
+            metrics.record(Metrics::Latency::Auth, v * 10);
+        }
+        Metrics::Histogram h = metrics.histogram(Metrics::Latency::Auth);
+        CHECK_CLOSE(500000.0, static_cast<double>(h.quantile(0.5)), 500000.0 / Metrics::SUB_BUCKETS);
+        CHECK_CLOSE(990000.0, static_cast<double>(h.quantile(0.99)), 990000.0 / Metrics::SUB_BUCKETS);
+        CHECK_EQUAL(0u, metrics.histogram(Metrics::Latency::Compute).quantile(0.5));
+    }
+
+    TEST(Exposition) { // Тест 4: Текст метрик в формате Prometheus
+        Metrics metrics;
+        metrics.add(Metrics::Counter::ConnectionsAccepted, 3);
+        metrics.add(Metrics::Counter::ConnectionsClosed);
+        metrics.record(Metrics::Latency::VectorReceive, 1500);
+        metrics.addCallback("vcalc_users", "Users", false, [] { return 42.0; });
+        std::string text = metrics.exposition();
+        CHECK(text.find("vcalc_connections_accepted_total 3\n") != std::string::npos);
+        CHECK(text.find("vcalc_connections_active 2\n") != std::string::npos);
+        CHECK(text.find("# TYPE vcalc_vector_receive_duration_seconds histogram\n") != std::string::npos);
+        CHECK(text.find("vcalc_vector_receive_duration_seconds_bucket{le=\"1.024e-06\"} 0\n") != std::string::npos);
+        CHECK(text.find("vcalc_vector_receive_duration_seconds_bucket{le=\"2.048e-06\"} 1\n") != std::string::npos);
+        CHECK(text.find("vcalc_vector_receive_duration_seconds_count 1\n") != std::string::npos);
+        CHECK(text.find("vcalc_users 42\n") != std::string::npos);
+    }
+
+    TEST(HttpEndpoint) { // Тест 5: Отдача метрик по HTTP
+        Logger logger;
+        logger.init("test_metrics.log");
+        Metrics metrics;
+        metrics.add(Metrics::Counter::AuthSuccesses, 7);
+        MetricsServer server(metrics, logger);
+        unsigned short port = static_cast<unsigned short>(40000 + getpid() % 5000);
+        CHECK(server.start(port));
+
+        std::string ok = httpGet(port, "/metrics");
+        CHECK(ok.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+        CHECK(ok.find("vcalc_auth_successes_total 7\n") != std::string::npos);
+        std::string missing = httpGet(port, "/");
+        CHECK(missing.compare(0, 22, "HTTP/1.1 404 Not Found") == 0);
+        CHECK_EQUAL(1u, server.scrapes());
+        server.stop();
+        std::remove("test_metrics.log");
+    }
+}
@@ -0,0 +1,79 @@
+#include <UnitTest++/UnitTest++.h>
+#include "RingBuffer.h"
+#include <string>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+
+SUITE(RingBufferTest)
+{
+    TEST(CapacityRoundedUp) { // Тест 1: Емкость округляется до степени двойки
+        RingBuffer buf(100);
+        CHECK_EQUAL(128u, buf.capacity());
+        CHECK_EQUAL(0u, buf.size());
+        CHECK_EQUAL(128u, buf.space());
+    }
+
+    TEST(WriteRead) { // Тест 2: Запись и чтение
+        RingBuffer buf(16);
+        CHECK_EQUAL(5u, buf.write("hello", 5));
+        char out[8] = {};
+        CHECK_EQUAL(5u, buf.read(out, sizeof(out)));
+        CHECK_EQUAL("hello", std::string(out, 5));
+        CHECK_EQUAL(0u, buf.size());
+    }
+
+    TEST(WriteLimitedBySpace) { // Тест 3: Запись в заполненный буфер
+        RingBuffer buf(16);
+        std::string data(20, 'x');
+        CHECK_EQUAL(16u, buf.write(data.data(), data.size()));
+        CHECK_EQUAL(0u, buf.write("y", 1));
+    }
+
+    TEST(WrapAround) { // Тест 4: Данные через границу памяти
+        RingBuffer buf(16);
+        char out[16];
+        buf.write("0123456789AB", 12);
+        buf.read(out, 10);
+        CHECK_EQUAL(10u, buf.write("CDEFGHIJKL", 10)); // 6 байт в конце, 4 в начале
+        CHECK_EQUAL(2u + 10u, buf.size());
+        CHECK_EQUAL(12u, buf.peek(out, sizeof(out)));
+        CHECK_EQUAL("ABCDEFGHIJKL", std::string(out, 12));
+        CHECK_EQUAL(7u, buf.find('H', 16));
+        CHECK_EQUAL(RingBuffer::npos, buf.find('H', 7));
+    }
+
+    TEST(DrainSpans) { // Тест 5: Передача данных непрерывными участками
+        RingBuffer buf(16);
+        char out[16];
+        buf.write("0123456789AB", 12);
+        buf.read(out, 10);
+        buf.write("CDEFGHIJKL", 10);
+        std::string collected;
+        int calls = 0;
+        size_t n = buf.drain(9, [&](const char* data, size_t len) {
+            collected.append(data, len);
+            ++calls;
+        });
+        CHECK_EQUAL(9u, n);
+        CHECK_EQUAL("ABCDEFGHI", collected);
+        CHECK_EQUAL(2, calls);
+        CHECK_EQUAL(3u, buf.size());
+    }
+
+    TEST(ReceiveFromSocket) { // Тест 6: Прием из сокета через границу памяти
+        int fds[2];
+        CHECK_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+        RingBuffer buf(16);
+        char out[16];
+        buf.write("0123456789", 10);
+        buf.read(out, 10);
+        CHECK_EQUAL(12, write(fds[1], "abcdefghijkl", 12));
+        CHECK_EQUAL(12, buf.receive(fds[0], buf.space()));
+        CHECK_EQUAL(12u, buf.read(out, sizeof(out)));
+        CHECK_EQUAL("abcdefghijkl", std::string(out, 12));
+        close(fds[1]);
+        CHECK_EQUAL(0, buf.receive(fds[0], buf.space()));
+        close(fds[0]);
+    }
+}
@@ -0,0 +1,25 @@
+#include <UnitTest++/UnitTest++.h>
+#include "SessionStatus.h"
+
+SUITE(SessionStatusTest)
+{
+    TEST(DefaultIsOk) { // Тест 1: Результат по умолчанию - успех
+        SessionStatus status;
+        CHECK(status.isOk());
+        CHECK(static_cast<bool>(status));
+        CHECK(status.code() == SessionStatus::Code::Ok);
+        CHECK_EQUAL(false, status.isAuthError());
+    }
+
+    TEST(Messages) { // Тест 2: Текст для журнала с подробностью
+        SessionStatus failed(SessionStatus::Code::AuthFailed, "user");
+        CHECK_EQUAL(false, static_cast<bool>(failed));
+        CHECK_EQUAL(true, failed.isAuthError());
+        CHECK_EQUAL("user", failed.detail());
+        CHECK_EQUAL("Auth error: Authentication failed for login user", failed.message());
+        
+        SessionStatus length(SessionStatus::Code::InvalidLength);
+        CHECK_EQUAL(false, length.isAuthError());
+        CHECK_EQUAL("Vector error: Vector size invalid or too large", length.message());
+    }
+}
@@ -0,0 +1,60 @@
+#include <UnitTest++/UnitTest++.h>
+#include "ThreadPool.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+SUITE(ThreadPoolTest)
+{
+    TEST(EachIndexOnce) { // Тест 1: Каждая часть выполняется ровно один раз
+        ThreadPool pool(4);
+        std::vector<std::atomic<int>> hits(1000);
+        for (auto& h : hits) {
+            h = 0;
+        }
+        pool.parallelFor(hits.size(), [&](size_t i) { hits[i]++; });
+        bool all_once = true;
+        for (auto& h : hits) {
+            all_once = all_once && h == 1;
+        }
+        CHECK(all_once);
+    }
+
+    TEST(NoWorkers) { // Тест 2: Пул без потоков выполняет части в вызывающем потоке
+        ThreadPool pool(0);
+        CHECK_EQUAL(0u, pool.size());
+        std::thread::id caller = std::this_thread::get_id();
+        bool same_thread = true;
+        size_t sum = 0;
+        pool.parallelFor(10, [&](size_t i) {
+            sum += i;
+            same_thread = same_thread && std::this_thread::get_id() == caller;
+        });
+        CHECK_EQUAL(45u, sum);
+        CHECK(same_thread);
+    }
+
+    TEST(ConcurrentCallers) { // Тест 3: Одновременные вызовы из нескольких потоков
+        ThreadPool pool(2);
+        std::atomic<size_t> total(0);
+        std::vector<std::thread> callers;
+        for (int t = 0; t < 4; ++t) {
+            callers.emplace_back([&] {
+                for (int r = 0; r < 50; ++r) {
+                    pool.parallelFor(17, [&](size_t i) { total += i; });
+                }
+            });
+        }
+        for (std::thread& t : callers) {
+            t.join();
+        }
+        CHECK_EQUAL(4u * 50u * 136u, total.load());
+    }
+
+    TEST(EmptyRange) { // Тест 4: Пустой диапазон
+        ThreadPool pool(2);
+        int calls = 0;
+        pool.parallelFor(0, [&](size_t) { ++calls; });
+        CHECK_EQUAL(0, calls);
+    }
+}
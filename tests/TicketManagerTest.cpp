@@ -0,0 +1,56 @@
+#include <UnitTest++/UnitTest++.h>
+#include "TicketManager.h"
+#include <string>
+
+SUITE(TicketManagerTest)
+{
+    const std::string SECRET = "0123456789abcdef0123456789abcdef";
+    const time_t NOW = 1700000000;
+
+    TEST(IssueAndValidate) { // Тест 1: Выданный билет принимается
+        TicketManager tickets(SECRET, 300);
+        std::string ticket = tickets.issue("user", NOW);
+        CHECK_EQUAL(TicketManager::TICKET_LENGTH, ticket.size());
+        CHECK_EQUAL(true, tickets.validate("user", ticket, NOW));
+        CHECK_EQUAL(true, tickets.validate("user", ticket, NOW + 299));
+    }
+
+    TEST(WrongLogin) { // Тест 2: Билет другого пользователя отклоняется
+        TicketManager tickets(SECRET, 300);
+        std::string ticket = tickets.issue("user", NOW);
+        CHECK_EQUAL(false, tickets.validate("admin", ticket, NOW));
+    }
+
+    TEST(Expired) { // Тест 3: Истекший билет отклоняется
+        TicketManager tickets(SECRET, 300);
+        std::string ticket = tickets.issue("user", NOW);
+        CHECK_EQUAL(false, tickets.validate("user", ticket, NOW + 300));
+    }
+
+    TEST(Tampered) { // Тест 4: Измененный билет отклоняется
+        TicketManager tickets(SECRET, 300);
+        std::string ticket = tickets.issue("user", NOW);
+        std::string longer = ticket;
+        longer[15] = (longer[15] == 'F') ? 'E' : 'F'; // продление срока действия
+        CHECK_EQUAL(false, tickets.validate("user", longer, NOW));
+        CHECK_EQUAL(false, tickets.validate("user", ticket.substr(1), NOW));
+        CHECK_EQUAL(false, tickets.validate("user", std::string(TicketManager::TICKET_LENGTH, 'X'), NOW));
+    }
+
+    TEST(SharedSecret) { // Тест 5: Билет принимается другим процессом с тем же секретом
+        TicketManager issuer(SECRET, 300);
+        TicketManager same(SECRET, 60);
+        TicketManager other("fedcba9876543210fedcba9876543210", 300);
+        std::string ticket = issuer.issue("user", NOW);
+        CHECK_EQUAL(true, same.validate("user", ticket, NOW + 100));
+        CHECK_EQUAL(false, other.validate("user", ticket, NOW));
+    }
+
+    TEST(KeyRotation) { // Тест 6: Принимаются ключи текущего и предыдущего периода
+        TicketManager tickets(SECRET, 3 * TicketManager::KEY_ROTATION);
+        time_t start = (NOW / TicketManager::KEY_ROTATION) * TicketManager::KEY_ROTATION;
+        std::string ticket = tickets.issue("user", start);
+        CHECK_EQUAL(true, tickets.validate("user", ticket, start + TicketManager::KEY_ROTATION));
+        CHECK_EQUAL(false, tickets.validate("user", ticket, start + 2 * TicketManager::KEY_ROTATION));
+    }
+}
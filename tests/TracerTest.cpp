@@ -0,0 +1,142 @@
+#include <UnitTest++/UnitTest++.h>
+#include "Tracer.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+SUITE(TracerTest)
+{
+    std::string tracePath() {
+        return "/tmp/vcalc_tracer_test_" + std::to_string(getpid()) + ".json";
+    }
+
+    std::string readFile(const std::string& path) {
+        std::ifstream file(path);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    size_t countOf(const std::string& text, const std::string& pattern) {
+        size_t count = 0;
+        for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+            ++count;
+        }
+        return count;
+    }
+
+    TEST(NoTracerInstalled) { // Тест 1: Без установленного трассировщика сессии не трассируются
+        Tracer tracer;
+        Tracer::install(nullptr);
+        CHECK_EQUAL(0u, Tracer::startSession());
+        {
+            Tracer::Scope scope(Tracer::startSession());
+            Tracer::Span span(Tracer::Stage::Verify);
+        }
+        Tracer::record(Tracer::Stage::Accept, 1, Tracer::now(), Tracer::now());
+        CHECK_EQUAL(0u, tracer.size());
+    }
+
+    TEST(SpansInsideScope) { // Тест 2: Интервалы записываются только внутри трассируемой сессии
+        Tracer tracer;
+        Tracer::install(&tracer);
+        {
+            Tracer::Span span(Tracer::Stage::Average);
+        }
+        CHECK_EQUAL(0u, tracer.size());
+        {
+            Tracer::Scope scope(Tracer::startSession());
+            CHECK(Tracer::session() != 0);
+            Tracer::Span span(Tracer::Stage::Verify);
+        }
+        CHECK_EQUAL(0u, Tracer::session());
+        CHECK_EQUAL(1u, tracer.size());
+        Tracer::install(nullptr);
+    }
+
+    TEST(Sampling) { // Тест 3: Выборка каждой N-й сессии
+        Tracer tracer(4);
+        Tracer::install(&tracer);
+        std::vector<uint64_t> sampled;
+        for (int i = 0; i < 8; ++i) {
+            if (uint64_t session = Tracer::startSession()) {
+                sampled.push_back(session);
+            }
+        }
+        Tracer::install(nullptr);
+        CHECK_EQUAL(2u, sampled.size());
+        CHECK_EQUAL(1u, sampled[0]);
+        CHECK_EQUAL(5u, sampled[1]);
+    }
+
+    TEST(RingWraparound) { // Тест 4: При переполнении буфера сохраняются последние интервалы
+        Tracer tracer(1, 8);
+        Tracer::install(&tracer);
+        for (uint64_t session = 1; session <= 20; ++session) {
+            uint64_t start = Tracer::now();
+            Tracer::record(Tracer::Stage::Receive, session, start, start + 1000);
+        }
+        Tracer::install(nullptr);
+        CHECK_EQUAL(8u, tracer.size());
+
+        std::string path = tracePath();
+        CHECK(tracer.write(path));
+        std::string json = readFile(path);
+        std::remove(path.c_str());
+        CHECK_EQUAL(7u, countOf(json, "\"ph\": \"X\""));
+        CHECK(json.find("\"session\": 13}") == std::string::npos);
+        CHECK(json.find("\"session\": 14}") != std::string::npos);
+        CHECK(json.find("\"session\": 20}") != std::string::npos);
+    }
+
+    TEST(ChromeTraceFormat) { // Тест 5: Формат Chrome trace_event
+        Tracer tracer;
+        Tracer::install(&tracer);
+        {
+            Tracer::Scope scope(Tracer::startSession());
+            Tracer::Span verify(Tracer::Stage::Verify);
+            Tracer::Span finalize(Tracer::Stage::Finalize);
+        }
+        Tracer::install(nullptr);
+
+        std::string path = tracePath();
+        CHECK(tracer.write(path));
+        std::string json = readFile(path);
+        std::remove(path.c_str());
+        CHECK_EQUAL(0u, json.find("{\"traceEvents\": ["));
+        CHECK(json.find("\"name\": \"verify\"") != std::string::npos);
+        CHECK(json.find("\"name\": \"finalize\"") != std::string::npos);
+        CHECK(json.find("\"name\": \"thread_name\"") != std::string::npos);
+        CHECK_EQUAL(2u, countOf(json, "\"session\": 1}"));
+        CHECK_EQUAL(std::string("send"), Tracer::stageName(Tracer::Stage::Send));
+    }
+
+    TEST(BufferPerThread) { // Тест 6: Каждый поток пишет в свой буфер
+        Tracer tracer(1, 1024);
+        Tracer::install(&tracer);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([] {
+                for (int i = 0; i < 100; ++i) {
+                    Tracer::Scope scope(Tracer::startSession());
+                    Tracer::Span span(Tracer::Stage::Average);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        Tracer::install(nullptr);
+        CHECK_EQUAL(400u, tracer.size());
+
+        std::string path = tracePath();
+        CHECK(tracer.write(path));
+        std::string json = readFile(path);
+        std::remove(path.c_str());
+        CHECK_EQUAL(4u, countOf(json, "\"name\": \"thread_name\""));
+    }
+}
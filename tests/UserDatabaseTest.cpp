@@ -3,6 +3,11 @@
 #include "Logger.h"
 #include <fstream>
 #include <cstdio>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
 
 SUITE(UserDatabaseTest)
 {
@@ -132,4 +137,212 @@ SUITE(UserDatabaseTest)
         std::remove("invalid.conf");
         std::remove("test_invalid.log");
     }
-}
\ No newline at end of file
+    
+    TEST(PasswordView) { // Тест 8: Поиск по string_view без копирования пароля
+        Logger logger;
+        logger.init("test.log");
+        UserDatabase db;
+        
+        std::ofstream file("test.conf");
+        file << "user:P@ssW0rd\n";
+        file << "admin:admin123\n";
+        file.close();
+        
+        CHECK_EQUAL(true, db.load("test.conf", logger));
+        
+        const char buffer[] = "adminXYZ";
+        UserDatabase::Reader reader(db);
+        std::string_view password;
+        CHECK_EQUAL(true, reader.getPassword(std::string_view(buffer, 5), password));
+        CHECK(password == "admin123");
+        CHECK_EQUAL(false, reader.getPassword(std::string_view(buffer, 4), password));
+        CHECK_EQUAL(false, reader.getPassword(std::string_view(), password));
+        
+        std::remove("test.conf");
+        std::remove("test.log");
+    }
+    
+    TEST(DuplicateLogin) { // Тест 9: Повтор логина - действует последняя запись
+        Logger logger;
+        logger.init("test.log");
+        UserDatabase db;
+        
+        std::ofstream file("test.conf");
+        file << "user:first\n";
+        file << "user:second\n";
+        file.close();
+        
+        CHECK_EQUAL(true, db.load("test.conf", logger));
+        CHECK_EQUAL(1u, db.size());
+        
+        std::string password;
+        CHECK_EQUAL(true, db.getPassword("user", password));
+        CHECK_EQUAL("second", password);
+        
+        std::remove("test.conf");
+        std::remove("test.log");
+    }
+    
+    TEST(ManyUsers) { // Тест 10: Поиск среди большого числа пользователей
+        Logger logger;
+        logger.init("test.log");
+        UserDatabase db;
+        
+        const int users_count = 20000;
+        std::ofstream file("many.conf");
+        for (int i = 0; i < users_count; ++i) {
+            file << "user" << i << ":pass" << i << "\n";
+        }
+        file.close();
+        
+        CHECK_EQUAL(true, db.load("many.conf", logger));
+        CHECK_EQUAL(static_cast<size_t>(users_count), db.size());
+        
+        bool all_found = true;
+        UserDatabase::Reader reader(db);
+        std::string_view password;
+        for (int i = 0; i < users_count; ++i) {
+            all_found = all_found && reader.getPassword("user" + std::to_string(i), password) &&
+                        password == "pass" + std::to_string(i);
+        }
+        CHECK(all_found);
+        CHECK_EQUAL(false, reader.getPassword("user" + std::to_string(users_count), password));
+        
+        std::remove("many.conf");
+        std::remove("test.log");
+    }
+    
+    TEST(BinaryRoundTrip) { // Тест 11: Сохранение и загрузка двоичной базы
+        Logger logger;
+        logger.init("test.log");
+        
+        std::ofstream file("test.conf");
+        for (int i = 0; i < 1000; ++i) {
+            file << "user" << i << ":pass" << i << "\n";
+        }
+        file.close();
+        
+        UserDatabase text_db;
+        CHECK_EQUAL(true, text_db.load("test.conf", logger));
+        CHECK_EQUAL(false, text_db.isMapped());
+        CHECK_EQUAL(true, text_db.save("test_db.bin", logger));
+        
+        UserDatabase db;
+        CHECK_EQUAL(true, db.load("test_db.bin", logger));
+        CHECK_EQUAL(true, db.isMapped());
+        CHECK_EQUAL(1000u, db.size());
+        
+        bool all_found = true;
+        UserDatabase::Reader reader(db);
+        std::string_view password;
+        for (int i = 0; i < 1000; ++i) {
+            all_found = all_found && reader.getPassword("user" + std::to_string(i), password) &&
+                        password == "pass" + std::to_string(i);
+        }
+        CHECK(all_found);
+        CHECK_EQUAL(false, reader.getPassword("user1000", password));
+        
+        std::remove("test.conf");
+        std::remove("test_db.bin");
+        std::remove("test.log");
+    }
+    
+    TEST(CorruptedBinary) { // Тест 12: Отказ загрузки поврежденной двоичной базы
+        Logger logger;
+        logger.init("test.log");
+        
+        std::ofstream file("test.conf");
+        file << "user:P@ssW0rd\n";
+        file.close();
+        
+        UserDatabase db;
+        CHECK_EQUAL(true, db.load("test.conf", logger));
+        CHECK_EQUAL(true, db.save("test_db.bin", logger));
+        CHECK_EQUAL(0, truncate("test_db.bin", 40));
+        
+        CHECK_EQUAL(false, db.load("test_db.bin", logger));
+        std::string password;
+        CHECK_EQUAL(true, db.getPassword("user", password)); // предыдущая база сохраняется
+        CHECK_EQUAL("P@ssW0rd", password);
+        
+        std::remove("test.conf");
+        std::remove("test_db.bin");
+        std::remove("test.log");
+    }
+    
+    TEST(ReloadKeepsPinnedSnapshot) { // Тест 13: Перезагрузка не затрагивает закрепленный снимок
+        Logger logger;
+        logger.init("test.log");
+        UserDatabase db;
+        
+        std::ofstream file("test.conf");
+        file << "user:old_password\n";
+        file.close();
+        CHECK_EQUAL(true, db.load("test.conf", logger));
+        
+        std::unique_ptr<UserDatabase::Reader> reader(new UserDatabase::Reader(db));
+        std::string_view old_password;
+        CHECK_EQUAL(true, reader->getPassword("user", old_password));
+        
+        std::thread reload_thread([&db, &logger] {
+            std::ofstream file("test.conf");
+            file << "user:new_password\n";
+            file << "admin:admin123\n";
+            file.close();
+            db.reload(logger); // возвращается после освобождения старого снимка
+        });
+        while (db.size() != 2) {
+            std::this_thread::yield();
+        }
+        
+        CHECK(old_password == "old_password"); // старый снимок еще закреплен
+        std::string password;
+        CHECK_EQUAL(true, db.getPassword("user", password));
+        CHECK_EQUAL("new_password", password);
+        CHECK_EQUAL(false, reader->getPassword("admin", old_password));
+        
+        reader.reset(); // освобождение старого снимка завершает перезагрузку
+        reload_thread.join();
+        
+        std::remove("test.conf");
+        std::remove("test.log");
+    }
+    
+    TEST(ConcurrentReadersDuringReload) { // Тест 14: Чтение во время многократных перезагрузок
+        Logger logger;
+        logger.init("test.log");
+        UserDatabase db;
+        
+        std::ofstream file("test.conf");
+        file << "user:P@ssW0rd\n";
+        file.close();
+        CHECK_EQUAL(true, db.load("test.conf", logger));
+        
+        std::atomic<bool> done(false);
+        std::atomic<int> failures(0);
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 3; ++t) {
+            readers.emplace_back([&db, &done, &failures] {
+                while (!done.load()) {
+                    UserDatabase::Reader reader(db);
+                    std::string_view password;
+                    if (!reader.getPassword("user", password) || password != "P@ssW0rd") {
+                        failures.fetch_add(1);
+                    }
+                }
+            });
+        }
+        for (int i = 0; i < 50; ++i) {
+            CHECK_EQUAL(true, db.reload(logger));
+        }
+        done.store(true);
+        for (auto& th : readers) {
+            th.join();
+        }
+        
+        CHECK_EQUAL(0, failures.load());
+        
+        std::remove("test.conf");
+        std::remove("test.log");
+    }
+}
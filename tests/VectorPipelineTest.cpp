@@ -0,0 +1,78 @@
+#include <UnitTest++/UnitTest++.h>
+#include "VectorPipeline.h"
+#include "DataProcessor.h"
+#include "Logger.h"
+#include "Tracer.h"
+#include <cstdio>
+#include <vector>
+
+SUITE(VectorPipelineTest)
+{
+    struct VectorPipelineFixture {
+        Logger logger;
+        DataProcessor processor;
+        std::string test_log_file;
+
+        VectorPipelineFixture() : test_log_file("test_pipeline.log") {
+            logger.init(test_log_file);
+        }
+
+        ~VectorPipelineFixture() {
+            std::remove(test_log_file.c_str());
+        }
+    };
+
+    TEST_FIXTURE(VectorPipelineFixture, ResultsInOrder) { // Тест 1: Результаты совпадают с последовательным вычислением
+        VectorPipeline pipeline(processor, logger);
+        std::vector<std::vector<int32_t>> vectors;
+        for (int32_t i = 0; i < 50; ++i) {
+            vectors.push_back(std::vector<int32_t>(1000 + i, i * 3 - 40));
+        }
+        for (const auto& v : vectors) {
+            CHECK(!pipeline.busy());
+            pipeline.submit(v.data(), v.size());
+            CHECK(pipeline.busy());
+            VectorPipeline::Result result = pipeline.wait();
+            CHECK_EQUAL(processor.calculateAverage(v, logger), result.value);
+        }
+        CHECK(!pipeline.busy());
+    }
+
+    TEST_FIXTURE(VectorPipelineFixture, OverlapWithCaller) { // Тест 2: Вызывающий поток работает во время вычисления
+        VectorPipeline pipeline(processor, logger);
+        std::vector<int32_t> first(1 << 20, 7);
+        std::vector<int32_t> second(1 << 20, -3);
+        pipeline.submit(first.data(), first.size());
+        for (size_t i = 0; i < second.size(); ++i) {
+            second[i] -= static_cast<int32_t>(i & 1);
+        }
+        CHECK_EQUAL(7, pipeline.wait().value);
+        pipeline.submit(second.data(), second.size());
+        CHECK_EQUAL(-3, pipeline.wait().value);
+    }
+
+    TEST_FIXTURE(VectorPipelineFixture, DrainDiscardsResult) { // Тест 3: Ожидание без получения результата
+        std::vector<int32_t> data(100000, 5);
+        {
+            VectorPipeline pipeline(processor, logger);
+            pipeline.submit(data.data(), data.size());
+            pipeline.drain();
+            CHECK(!pipeline.busy());
+            pipeline.submit(data.data(), data.size());
+        }
+        CHECK(true);
+    }
+
+    TEST_FIXTURE(VectorPipelineFixture, TracedInSubmittingSession) { // Тест 4: Вычисление попадает в трассу сессии
+        Tracer tracer;
+        Tracer::install(&tracer);
+        VectorPipeline pipeline(processor, logger);
+        std::vector<int32_t> data(1000, 1);
+        pipeline.submit(data.data(), data.size(), Tracer::startSession());
+        pipeline.wait();
+        pipeline.submit(data.data(), data.size());
+        pipeline.wait();
+        Tracer::install(nullptr);
+        CHECK_EQUAL(2u, tracer.size()); // average и finalize первого вектора
+    }
+}
@@ -0,0 +1,528 @@
+/**
+ * @file benchclient.cpp
+ * @brief Нагрузочный клиент для измерения производительности сервера
+ * @details Использование: bench_client [--host ADDR] [--port PORT] [--users FILE] [--connections N]
+ *          [--sessions N] [--vectors SPEC] [--length SPEC] [--hash sha1|sha256] [--tickets] [--output FILE]
+ *
+ * Каждое из N соединений обслуживается своим потоком и выполняет заданное число сессий
+ * по протоколу сервера: подключение, строка LOGIN + SALT + HASH, "OK", количество векторов,
+ * для каждого вектора длина и данные с ожиданием результата. Пользователи берутся по кругу
+ * из текстовой базы "логин:пароль". Количество векторов в сессии и длина вектора задаются
+ * спецификацией распределения:
+ *   N        - постоянное значение,
+ *   MIN-MAX  - равномерное распределение,
+ *   exp:MEAN - экспоненциальное распределение со средним MEAN (не меньше 1).
+ * Результаты - пропускная способность и задержки фаз (connect, auth, vector)
+ * с процентилями p50/p99/p999 - выводятся в формате JSON
+ */
+
+#include "Digest.h"
+#include "TicketManager.h"
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace po = boost::program_options;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock; ///< Часы измерения задержек
+
+const unsigned MAX_CONNECTIONS = 4096; ///< Максимальное количество соединений
+
+/**
+ * @brief Распределение целых значений, заданное строкой
+ */
+class Distribution {
+public:
+    /**
+     * @brief Разбор спецификации распределения
+     * @param spec Строка "N", "MIN-MAX" или "exp:MEAN"
+     * @return true - спецификация корректна
+     */
+    bool parse(const std::string& spec) {
+        char tail = 0;
+        if (spec.compare(0, 4, "exp:") == 0) {
+            kind = Kind::Exponential;
+            return std::sscanf(spec.c_str() + 4, "%lf%c", &mean, &tail) == 1 && mean >= 1;
+        }
+        if (std::sscanf(spec.c_str(), "%u-%u%c", &low, &high, &tail) == 2) {
+            kind = Kind::Uniform;
+            return low <= high;
+        }
+        if (std::sscanf(spec.c_str(), "%u%c", &low, &tail) == 1) {
+            kind = Kind::Fixed;
+            high = low;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Получение очередного значения
+     * @param rng Генератор случайных чисел потока
+     * @return Значение распределения
+     */
+    uint32_t next(std::mt19937_64& rng) const {
+        switch (kind) {
+        case Kind::Fixed:
+            return low;
+        case Kind::Uniform:
+            return std::uniform_int_distribution<uint32_t>(low, high)(rng);
+        case Kind::Exponential:
+            return 1 + static_cast<uint32_t>(std::exponential_distribution<double>(1.0 / mean)(rng));
+        }
+        return low;
+    }
+
+    /**
+     * @brief Получение наименьшего возможного значения
+     * @return Нижняя граница
+     */
+    uint32_t minimum() const {
+        return kind == Kind::Exponential ? 1 : low;
+    }
+
+private:
+    /**
+     * @brief Вид распределения
+     */
+    enum class Kind {
+        Fixed, ///< Постоянное значение
+        Uniform, ///< Равномерное распределение
+        Exponential ///< Экспоненциальное распределение
+    };
+
+    Kind kind = Kind::Fixed; ///< Вид распределения
+    uint32_t low = 0; ///< Значение или нижняя граница
+    uint32_t high = 0; ///< Верхняя граница
+    double mean = 1; ///< Среднее экспоненциального распределения
+};
+
+/**
+ * @brief Параметры нагрузки
+ */
+struct Options {
+    std::string host; ///< Адрес сервера
+    unsigned short port; ///< Порт сервера
+    std::string usersFile; ///< Текстовая база пользователей
+    unsigned connections; ///< Количество одновременных соединений
+    unsigned sessions; ///< Сессий на соединение
+    std::string vectorsSpec; ///< Распределение количества векторов в сессии
+    std::string lengthSpec; ///< Распределение длины вектора
+    std::string hash; ///< Алгоритм хеширования аутентификации
+    bool tickets; ///< Сервер выдает билет вместе с "OK"
+    std::string output; ///< Файл результатов (пусто - стандартный вывод)
+    Distribution vectors; ///< Количество векторов в сессии
+    Distribution length; ///< Длина вектора
+    Digest::Algorithm algorithm; ///< Алгоритм хеширования
+};
+
+/**
+ * @brief Учетная запись пользователя
+ */
+struct User {
+    std::string login; ///< Логин
+    std::string password; ///< Пароль
+};
+
+/**
+ * @brief Результаты одного потока нагрузки
+ */
+struct Samples {
+    std::vector<uint64_t> connect; ///< Задержки подключения, нс
+    std::vector<uint64_t> auth; ///< Задержки аутентификации, нс
+    std::vector<uint64_t> vector; ///< Задержки обработки вектора, нс
+    uint64_t sessions = 0; ///< Завершенные сессии
+    uint64_t failedSessions = 0; ///< Сессии, прерванные ошибкой
+    uint64_t authRejected = 0; ///< Ответы "ERR" на аутентификацию
+    uint64_t mismatches = 0; ///< Результаты, не совпавшие с ожидаемыми
+    uint64_t bytesSent = 0; ///< Отправлено байт данных векторов
+};
+
+/**
+ * @brief Загрузка пользователей из текстовой базы
+ * @param path Файл "логин:пароль"
+ * @param users Загруженные пользователи
+ * @return true - загружен хотя бы один пользователь
+ */
+bool loadUsers(const std::string& path, std::vector<User>& users) {
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        size_t colon = line.find(':');
+        if (colon == std::string::npos || colon == 0) {
+            continue;
+        }
+        users.push_back(User{line.substr(0, colon), line.substr(colon + 1)});
+    }
+    return !users.empty();
+}
+
+/**
+ * @brief Отправка буфера целиком
+ * @param sock Сокет
+ * @param data Данные
+ * @param len Длина
+ * @return true - все данные отправлены
+ */
+bool sendAll(int sock, const void* data, size_t len) {
+    const char* p = static_cast<const char*>(data);
+    while (len > 0) {
+        ssize_t rc = send(sock, p, len, MSG_NOSIGNAL);
+        if (rc <= 0) {
+            if (rc == -1 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p += rc;
+        len -= rc;
+    }
+    return true;
+}
+
+/**
+ * @brief Прием заданного количества байт
+ * @param sock Сокет
+ * @param data Буфер
+ * @param len Длина
+ * @return true - данные приняты целиком
+ */
+bool recvAll(int sock, void* data, size_t len) {
+    char* p = static_cast<char*>(data);
+    while (len > 0) {
+        ssize_t rc = recv(sock, p, len, 0);
+        if (rc <= 0) {
+            if (rc == -1 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p += rc;
+        len -= rc;
+    }
+    return true;
+}
+
+/**
+ * @brief Формирование строки аутентификации
+ * @param user Пользователь
+ * @param algorithm Алгоритм хеширования
+ * @param rng Генератор случайных чисел потока
+ * @return LOGIN + SALT16 + HASH + '\n'
+ */
+std::string authLine(const User& user, Digest::Algorithm algorithm, std::mt19937_64& rng) {
+    unsigned char salt_bytes[8];
+    uint64_t r = rng();
+    std::memcpy(salt_bytes, &r, sizeof(salt_bytes));
+    std::string salt(16, '0');
+    Digest::encodeHex(salt_bytes, sizeof(salt_bytes), &salt[0]);
+
+    std::unique_ptr<Digest> digest = Digest::create(algorithm);
+    unsigned char hash[Digest::MAX_SIZE];
+    digest->update(salt.data(), salt.size());
+    digest->update(user.password.data(), user.password.size());
+    digest->final(hash);
+    std::string hex(2 * digest->size(), '0');
+    Digest::encodeHex(hash, digest->size(), &hex[0]);
+    return user.login + salt + hex + "\n";
+}
+
+/**
+ * @brief Ожидаемый результат сервера для вектора
+ * @param data Вектор
+ * @return Среднее с усечением к нулю, ограниченное диапазоном int32_t
+ */
+int32_t expectedAverage(const std::vector<int32_t>& data) {
+    int64_t sum = 0;
+    for (int32_t v : data) {
+        sum += v;
+    }
+    int64_t avg = sum / static_cast<int64_t>(data.size());
+    return static_cast<int32_t>(std::max<int64_t>(INT32_MIN, std::min<int64_t>(INT32_MAX, avg)));
+}
+
+/**
+ * @brief Наносекунды, прошедшие с момента времени
+ * @param start Начало интервала
+ * @return Длительность в наносекундах
+ */
+uint64_t since(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Выполнение одной сессии
+ * @param opts Параметры нагрузки
+ * @param addr Адрес сервера
+ * @param user Пользователь
+ * @param rng Генератор случайных чисел потока
+ * @param samples Результаты потока
+ * @return true - сессия завершена без ошибок
+ */
+bool runSession(const Options& opts, const sockaddr_in& addr, const User& user,
+                std::mt19937_64& rng, Samples& samples) {
+    Clock::time_point start = Clock::now();
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock == -1) {
+        return false;
+    }
+    int one = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(sock, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == -1) {
+        close(sock);
+        return false;
+    }
+    samples.connect.push_back(since(start));
+
+    std::string line = authLine(user, opts.algorithm, rng);
+    start = Clock::now();
+    char reply[2];
+    if (!sendAll(sock, line.data(), line.size()) || !recvAll(sock, reply, 2)) {
+        close(sock);
+        return false;
+    }
+    if (std::memcmp(reply, "OK", 2) != 0) {
+        ++samples.authRejected;
+        close(sock);
+        return false;
+    }
+    if (opts.tickets) {
+        char ticket[TicketManager::TICKET_LENGTH]; // билет не используется, но должен быть вычитан
+        if (!recvAll(sock, ticket, sizeof(ticket))) {
+            close(sock);
+            return false;
+        }
+    }
+    samples.auth.push_back(since(start));
+
+    uint32_t count = opts.vectors.next(rng);
+    bool ok = sendAll(sock, &count, sizeof(count));
+    std::uniform_int_distribution<int32_t> value(-1000000, 1000000);
+    std::vector<int32_t> data;
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        uint32_t len = opts.length.next(rng);
+        data.resize(len);
+        for (int32_t& v : data) {
+            v = value(rng);
+        }
+        start = Clock::now();
+        int32_t result;
+        ok = sendAll(sock, &len, sizeof(len)) && sendAll(sock, data.data(), len * sizeof(int32_t)) &&
+             recvAll(sock, &result, sizeof(result));
+        if (ok) {
+            samples.vector.push_back(since(start));
+            samples.bytesSent += len * sizeof(int32_t);
+            if (result != expectedAverage(data)) {
+                ++samples.mismatches;
+            }
+        }
+    }
+    close(sock);
+    return ok;
+}
+
+/**
+ * @brief Запись статистики задержек фазы в JSON
+ * @param out Поток вывода
+ * @param name Имя фазы
+ * @param values Задержки в наносекундах (сортируются)
+ */
+void writeLatency(std::ostream& out, const char* name, std::vector<uint64_t>& values) {
+    std::sort(values.begin(), values.end());
+    auto percentile = [&values](double p) -> double {
+        if (values.empty()) {
+            return 0;
+        }
+        size_t index = static_cast<size_t>(std::ceil(p * values.size()));
+        return values[std::min(values.size() - 1, index == 0 ? 0 : index - 1)] / 1000.0;
+    };
+    double sum = 0;
+    for (uint64_t v : values) {
+        sum += v;
+    }
+    out << "    \"" << name << "\": {\"count\": " << values.size()
+        << ", \"mean\": " << (values.empty() ? 0 : sum / values.size() / 1000.0)
+        << ", \"p50\": " << percentile(0.50)
+        << ", \"p99\": " << percentile(0.99)
+        << ", \"p999\": " << percentile(0.999)
+        << ", \"max\": " << (values.empty() ? 0 : values.back() / 1000.0) << "}";
+}
+
+/**
+ * @brief Разбор параметров командной строки
+ * @param argc Количество аргументов
+ * @param argv Массив аргументов
+ * @param opts Параметры нагрузки
+ * @return true - параметры корректны
+ */
+bool parseOptions(int argc, char** argv, Options& opts) {
+    po::options_description desc("Allowed options");
+    desc.add_options()
+    ("help,h", "Show help")
+    ("host", po::value<std::string>(&opts.host)->default_value("127.0.0.1"), "Server IPv4 address")
+    ("port,p", po::value<unsigned short>(&opts.port)->default_value(33333), "Server port")
+    ("users,f", po::value<std::string>(&opts.usersFile)->default_value("etc/vcalc.conf"), "Text user database (login:password per line)")
+    ("connections,c", po::value<unsigned>(&opts.connections)->default_value(16), "Concurrent connections, one thread each")
+    ("sessions,n", po::value<unsigned>(&opts.sessions)->default_value(100), "Sessions per connection")
+    ("vectors", po::value<std::string>(&opts.vectorsSpec)->default_value("10"), "Vectors per session: N, MIN-MAX or exp:MEAN")
+    ("length", po::value<std::string>(&opts.lengthSpec)->default_value("1000"), "Vector length (elements): N, MIN-MAX or exp:MEAN")
+    ("hash", po::value<std::string>(&opts.hash)->default_value("sha1"), "Authentication hash: sha1 or sha256")
+    ("tickets", po::bool_switch(&opts.tickets), "Server runs with --tickets: read the ticket following \"OK\"")
+    ("output,o", po::value<std::string>(&opts.output)->default_value(""), "JSON result file (default - standard output)");
+    try {
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        if (vm.count("help")) {
+            std::cout << desc << std::endl;
+            return false;
+        }
+        po::notify(vm);
+        if (opts.connections == 0 || opts.connections > MAX_CONNECTIONS) {
+            throw po::error("connections must be 1-" + std::to_string(MAX_CONNECTIONS));
+        }
+        if (!opts.vectors.parse(opts.vectorsSpec)) {
+            throw po::error("invalid vector count distribution '" + opts.vectorsSpec + "'");
+        }
+        if (!opts.length.parse(opts.lengthSpec) || opts.length.minimum() == 0) {
+            throw po::error("invalid vector length distribution '" + opts.lengthSpec + "'");
+        }
+        if (!Digest::parse(opts.hash, opts.algorithm)) {
+            throw po::error("invalid hash algorithm '" + opts.hash + "'");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error parsing arguments: " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief Главная функция нагрузочного клиента
+ * @param argc Количество аргументов командной строки
+ * @param argv Массив аргументов командной строки
+ * @return 0 - измерение выполнено,
+ *         1 - ошибка параметров или ни одна сессия не завершилась успешно
+ */
+int main(int argc, char** argv) {
+    Options opts;
+    if (!parseOptions(argc, argv, opts)) {
+        return 1;
+    }
+    std::vector<User> users;
+    if (!loadUsers(opts.usersFile, users)) {
+        std::cerr << "No users loaded from " << opts.usersFile << std::endl;
+        return 1;
+    }
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(opts.port);
+    if (inet_pton(AF_INET, opts.host.c_str(), &addr.sin_addr) != 1) {
+        std::cerr << "Invalid server address " << opts.host << std::endl;
+        return 1;
+    }
+
+    std::vector<Samples> samples(opts.connections);
+    std::vector<std::thread> threads;
+    std::atomic<unsigned> ready(0);
+    std::atomic<bool> go(false);
+    for (unsigned c = 0; c < opts.connections; ++c) {
+        threads.emplace_back([&, c] {
+            std::mt19937_64 rng(0x9e3779b97f4a7c15ULL * (c + 1));
+            Samples& s = samples[c];
+            s.connect.reserve(opts.sessions);
+            s.auth.reserve(opts.sessions);
+            ++ready;
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (unsigned i = 0; i < opts.sessions; ++i) {
+                const User& user = users[(c + static_cast<size_t>(i) * opts.connections) % users.size()];
+                if (runSession(opts, addr, user, rng, s)) {
+                    ++s.sessions;
+                } else {
+                    ++s.failedSessions;
+                }
+            }
+        });
+    }
+    while (ready.load() != opts.connections) {
+        std::this_thread::yield();
+    }
+    Clock::time_point start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    double seconds = since(start) / 1e9;
+
+    Samples total;
+    for (Samples& s : samples) {
+        total.connect.insert(total.connect.end(), s.connect.begin(), s.connect.end());
+        total.auth.insert(total.auth.end(), s.auth.begin(), s.auth.end());
+        total.vector.insert(total.vector.end(), s.vector.begin(), s.vector.end());
+        total.sessions += s.sessions;
+        total.failedSessions += s.failedSessions;
+        total.authRejected += s.authRejected;
+        total.mismatches += s.mismatches;
+        total.bytesSent += s.bytesSent;
+    }
+
+    std::ostringstream out;
+    out << "{\n"
+        << "  \"config\": {\"host\": \"" << opts.host << "\", \"port\": " << opts.port
+        << ", \"connections\": " << opts.connections << ", \"sessions_per_connection\": " << opts.sessions
+        << ", \"vectors\": \"" << opts.vectorsSpec << "\", \"length\": \"" << opts.lengthSpec
+        << "\", \"hash\": \"" << opts.hash << "\"},\n"
+        << "  \"duration_s\": " << seconds << ",\n"
+        << "  \"sessions\": " << total.sessions << ",\n"
+        << "  \"failed_sessions\": " << total.failedSessions << ",\n"
+        << "  \"auth_rejected\": " << total.authRejected << ",\n"
+        << "  \"mismatches\": " << total.mismatches << ",\n"
+        << "  \"throughput\": {\"sessions_per_s\": " << total.sessions / seconds
+        << ", \"vectors_per_s\": " << total.vector.size() / seconds
+        << ", \"mb_per_s\": " << total.bytesSent / seconds / 1e6 << "},\n"
+        << "  \"latency_us\": {\n";
+    writeLatency(out, "connect", total.connect);
+    out << ",\n";
+    writeLatency(out, "auth", total.auth);
+    out << ",\n";
+    writeLatency(out, "vector", total.vector);
+    out << "\n  }\n}\n";
+
+    if (opts.output.empty()) {
+        std::cout << out.str();
+    } else {
+        std::ofstream file(opts.output);
+        file << out.str();
+        if (!file) {
+            std::cerr << "Cannot write " << opts.output << std::endl;
+            return 1;
+        }
+    }
+    return total.sessions > 0 ? 0 : 1;
+}
@@ -0,0 +1,36 @@
+/**
+ * @file dbcompile.cpp
+ * @brief Утилита преобразования текстовой базы пользователей в двоичный формат
+ * @details Использование: vcalc-dbc INPUT OUTPUT
+ *
+ * INPUT - файл "логин:пароль" (формат etc/vcalc.conf) или уже скомпилированная база,
+ * OUTPUT - создаваемый двоичный файл, который сервер принимает в параметре --file
+ */
+
+#include "UserDatabase.h"
+#include "Logger.h"
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Главная функция утилиты
+ * @param argc Количество аргументов командной строки
+ * @param argv Массив аргументов командной строки
+ * @return 0 - база записана,
+ *         1 - ошибка параметров, загрузки или записи
+ */
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " INPUT OUTPUT" << std::endl;
+        return 1;
+    }
+    Logger logger; ///< Ошибки выводятся в stderr, информационные сообщения не нужны
+    logger.init("/dev/null");
+
+    UserDatabase db;
+    if (!db.load(argv[1], logger) || !db.save(argv[2], logger)) {
+        return 1;
+    }
+    std::cout << "Compiled " << db.size() << " users into " << argv[2] << std::endl;
+    return 0;
+}
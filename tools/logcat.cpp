@@ -0,0 +1,164 @@
+/**
+ * @file logcat.cpp
+ * @brief Утилита чтения двоичного журнала сервера
+ * @details Использование: vcalc-logcat [--level LEVEL] [--login LOGIN] [--since TIME] [--until TIME] FILE...
+ *
+ * Записи журнала, созданного с --log-format binary, выводятся в текстовом формате
+ * сервера "YYYY-MM-DD HH:MM:SS; УРОВЕНЬ; СООБЩЕНИЕ". Фильтры:
+ *   --level - записи не ниже уровня (trace ... critical),
+ *   --login - записи, у которых один из строковых аргументов равен LOGIN,
+ *   --since/--until - записи в интервале местного времени "YYYY-MM-DD HH:MM:SS"
+ *                     (--until включает указанную секунду)
+ */
+
+#include "BinaryLog.h"
+#include "Logger.h"
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace po = boost::program_options;
+
+namespace {
+
+/**
+ * @brief Параметры вывода
+ */
+struct Options {
+    std::vector<std::string> files; ///< Файлы журнала
+    std::string level; ///< Минимальный уровень
+    std::string login; ///< Логин (пусто - без фильтра)
+    std::string since; ///< Начало интервала
+    std::string until; ///< Конец интервала
+    Logger::Level minLevel = Logger::Level::Trace; ///< Разобранный минимальный уровень
+    uint64_t from = 0; ///< Начало интервала, нс
+    uint64_t to = UINT64_MAX; ///< Конец интервала, нс (не включая)
+};
+
+/**
+ * @brief Разбор местного времени
+ * @param text Строка "YYYY-MM-DD HH:MM:SS"
+ * @param seconds Секунды от эпохи Unix
+ * @return true - строка корректна
+ */
+bool parseTime(const std::string& text, time_t& seconds) {
+    std::tm tm{};
+    const char* end = strptime(text.c_str(), "%Y-%m-%d %H:%M:%S", &tm);
+    if (end == nullptr || *end != '\0') {
+        return false;
+    }
+    tm.tm_isdst = -1;
+    seconds = mktime(&tm);
+    return seconds != -1;
+}
+
+/**
+ * @brief Разбор параметров командной строки
+ * @param argc Количество аргументов
+ * @param argv Массив аргументов
+ * @param opts Параметры вывода
+ * @return true - параметры корректны
+ */
+bool parseOptions(int argc, char** argv, Options& opts) {
+    po::options_description desc("Allowed options");
+    desc.add_options()
+    ("help,h", "Show help")
+    ("level", po::value<std::string>(&opts.level)->default_value("trace"), "Show records at or above this level: trace, debug, info, warning, error or critical")
+    ("login", po::value<std::string>(&opts.login)->default_value(""), "Show records with a string argument equal to this login")
+    ("since", po::value<std::string>(&opts.since)->default_value(""), "Show records from this local time (YYYY-MM-DD HH:MM:SS)")
+    ("until", po::value<std::string>(&opts.until)->default_value(""), "Show records up to this local time, inclusive (YYYY-MM-DD HH:MM:SS)")
+    ("file", po::value<std::vector<std::string>>(&opts.files), "Binary log file");
+    po::positional_options_description positional;
+    positional.add("file", -1);
+    try {
+        po::variables_map vm;
+        po::store(po::command_line_parser(argc, argv).options(desc).positional(positional).run(), vm);
+        if (vm.count("help")) {
+            std::cout << "Usage: " << argv[0] << " [options] FILE..." << std::endl << desc << std::endl;
+            return false;
+        }
+        po::notify(vm);
+        if (opts.files.empty()) {
+            throw po::error("no log file given");
+        }
+        if (!Logger::parseLevel(opts.level, opts.minLevel) || opts.minLevel == Logger::Level::Off) {
+            throw po::error("invalid log level '" + opts.level + "'");
+        }
+        time_t seconds;
+        if (!opts.since.empty()) {
+            if (!parseTime(opts.since, seconds)) {
+                throw po::error("invalid time '" + opts.since + "'");
+            }
+            opts.from = static_cast<uint64_t>(seconds) * 1000000000;
+        }
+        if (!opts.until.empty()) {
+            if (!parseTime(opts.until, seconds)) {
+                throw po::error("invalid time '" + opts.until + "'");
+            }
+            opts.to = (static_cast<uint64_t>(seconds) + 1) * 1000000000;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error parsing arguments: " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Проверка записи по фильтрам
+ * @param entry Запись
+ * @param opts Параметры вывода
+ * @return true - запись выводится
+ */
+bool matches(const BinaryLog::Entry& entry, const Options& opts) {
+    if (entry.level < static_cast<uint8_t>(opts.minLevel) || entry.timestamp < opts.from || entry.timestamp >= opts.to) {
+        return false;
+    }
+    return opts.login.empty() ||
+           std::find(entry.strings.begin(), entry.strings.end(), opts.login) != entry.strings.end();
+}
+
+} // namespace
+
+/**
+ * @brief Главная функция утилиты
+ * @param argc Количество аргументов командной строки
+ * @param argv Массив аргументов командной строки
+ * @return 0 - все файлы разобраны,
+ *         1 - ошибка параметров, чтения или формата файла
+ */
+int main(int argc, char** argv) {
+    Options opts;
+    if (!parseOptions(argc, argv, opts)) {
+        return 1;
+    }
+    int status = 0;
+    for (const std::string& path : opts.files) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::cerr << "Cannot open " << path << std::endl;
+            status = 1;
+            continue;
+        }
+        std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::vector<BinaryLog::Entry> entries;
+        std::string error;
+        if (!BinaryLog::decode(data.data(), data.size(), entries, error)) {
+            std::cerr << path << ": " << error << std::endl;
+            status = 1;
+        }
+        for (const BinaryLog::Entry& entry : entries) {
+            if (matches(entry, opts)) {
+                std::cout << BinaryLog::formatLine(entry) << '\n';
+            }
+        }
+    }
+    std::cout.flush();
+    return status;
+}
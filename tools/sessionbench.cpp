@@ -0,0 +1,140 @@
+/**
+ * @file sessionbench.cpp
+ * @brief Измерение стоимости неудачных клиентских сессий
+ * @details Использование: vcalc-sessionbench [SESSIONS] [THREADS]
+ *
+ * Прогоняет через Connection::onData() сессии, завершающиеся ошибкой протокола:
+ * неверный пароль, короткая строка аутентификации, недопустимая длина вектора
+ * после успешного входа. Сеть не используется, журнал пишется в /dev/null.
+ * Для каждого сценария выводится время одной сессии в наносекундах при
+ * THREADS потоках, одновременно обрабатывающих свои сессии
+ */
+
+#include "Connection.h"
+#include "Authenticator.h"
+#include "UserDatabase.h"
+#include "DataProcessor.h"
+#include "BufferPool.h"
+#include "Digest.h"
+#include "Logger.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Формирование строки аутентификации SHA-1
+ * @param login Логин
+ * @param password Пароль
+ * @param salt Соль (16 hex-символов)
+ * @return LOGIN + SALT + HASH + '\n'
+ */
+std::string authLine(const std::string& login, const std::string& password, const std::string& salt) {
+    std::unique_ptr<Digest> digest = Digest::create(Digest::Algorithm::Sha1);
+    unsigned char hash[Digest::MAX_SIZE];
+    digest->update(salt.data(), salt.size());
+    digest->update(password.data(), password.size());
+    digest->final(hash);
+    size_t size = Digest::size(Digest::Algorithm::Sha1);
+    std::string hex(2 * size, '0');
+    Digest::encodeHex(hash, size, &hex[0]);
+    return login + salt + hex + "\n";
+}
+
+/**
+ * @brief Прогон сессий одного сценария
+ * @param input Данные, присылаемые клиентом за сессию
+ * @param sessions Количество сессий на поток
+ * @param threads Количество потоков
+ * @param logger Журнал сессий
+ * @param db База пользователей
+ * @param auth Аутентификатор
+ * @param processor Обработчик данных
+ * @return Среднее время одной сессии в наносекундах (по всем потокам)
+ */
+double run(const std::string& input, size_t sessions, unsigned threads, Logger& logger,
+           UserDatabase& db, Authenticator& auth, DataProcessor& processor) {
+    auto body = [&] {
+        BufferPool pool;
+        for (size_t i = 0; i < sessions; ++i) {
+            Connection conn(-1, "127.0.0.1", logger, db, auth, processor, pool);
+            conn.onData(input.data(), input.size());
+        }
+    };
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t) {
+        workers.emplace_back(body);
+    }
+    body();
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    return elapsed.count() / (static_cast<double>(sessions) * threads);
+}
+
+} // namespace
+
+/**
+ * @brief Главная функция утилиты
+ * @param argc Количество аргументов командной строки
+ * @param argv Массив аргументов командной строки
+ * @return 0 - измерение выполнено, 1 - ошибка подготовки
+ */
+int main(int argc, char** argv) {
+    size_t sessions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    unsigned threads = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 1;
+    if (sessions == 0 || threads == 0) {
+        std::cerr << "Usage: " << argv[0] << " [SESSIONS] [THREADS]" << std::endl;
+        return 1;
+    }
+
+    Logger logger;
+    logger.init("/dev/null");
+    const char* db_path = "sessionbench.conf";
+    {
+        std::ofstream db_file(db_path);
+        db_file << "user:P@ssW0rd\n";
+    }
+    UserDatabase db;
+    bool loaded = db.load(db_path, logger);
+    std::remove(db_path);
+    if (!loaded) {
+        return 1;
+    }
+    Authenticator auth;
+    DataProcessor processor;
+
+    std::string salt = "1234567890ABCDEF";
+    std::string bad_password = "user" + salt + std::string(40, '0') + "\n";
+    std::string short_auth = "user\n";
+    std::string bad_length = authLine("user", "P@ssW0rd", salt);
+    uint32_t header[2] = {1, 0}; // один вектор нулевой длины
+    bad_length.append(reinterpret_cast<const char*>(header), sizeof(header));
+
+    struct Scenario {
+        const char* name;
+        const std::string* input;
+    } scenarios[] = {
+        {"bad_password", &bad_password},
+        {"short_auth", &short_auth},
+        {"bad_length", &bad_length},
+    };
+    std::cout << "Failed sessions: " << sessions << " per thread, " << threads << " threads" << std::endl;
+    for (const Scenario& s : scenarios) {
+        run(*s.input, sessions / 10 + 1, threads, logger, db, auth, processor); // прогрев
+        std::printf("%-14s %10.1f ns/session\n", s.name,
+                    run(*s.input, sessions, threads, logger, db, auth, processor));
+    }
+    return 0;
+}